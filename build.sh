@@ -28,6 +28,25 @@ cmd_build() {
 cmd_test() {
     make test_core
     make test_lookup
+    make test_dcache
+    make test_negative
+    make test_shrinker
+    make test_ino
+    make test_itable
+    make test_mounts
+    make test_rw_mt
+    make test_fh
+    make test_vectored
+    make test_uring
+    make test_async
+    make test_batch
+    make test_splice
+    make test_copy_range
+    make test_posix_handles
+    make test_posix_dirfd
+    make test_readdir
+    make test_posix_fd_cache
+    make test_readahead
     make test_file_ops
     make test_integration
     make test_stress
@@ -5,6 +5,7 @@
 
 #define _GNU_SOURCE
 #include "backend_posix.h"
+#include "../core/vfs_core.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,8 +17,13 @@
 #include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
 
 /* Use fuse's filler type if available */
 #ifdef __has_include
@@ -36,19 +42,155 @@ typedef int (*fuse_fill_dir_t)(void *buf, const char *name, const struct stat *s
 /* (the existing implementation follows unchanged) */
 
 #define PATH_BUFSZ PATH_MAX
-#define INITIAL_HANDLE_CAP 16
+#define DIRENT_BUFSZ (64 * 1024)         /* getdents64 reads this much at a time */
+
+/*
+ * Handle table: handle h is slot h-1. Slots live in fixed-size segments
+ * that are allocated on demand and only freed at shutdown, so lookup_fd
+ * is two atomic loads with no lock. Free slots form a lock-free stack
+ * whose head carries an ABA tag; only adding a segment takes b->lock.
+ */
+#define HANDLE_SEG_SHIFT 10
+#define HANDLE_SEG_SIZE  (1u << HANDLE_SEG_SHIFT)
+#define HANDLE_MAX_SEGS  1024
+#define HANDLE_NONE      UINT32_MAX         /* end of the free list */
+
+/*
+ * Read-pattern tracking: each open file follows up to RA_STREAMS streams,
+ * remembering where each one's last read ended, so readers interleaving
+ * on one handle (the VFS shares an inode's handle between its opens) or
+ * on one cached fd are told apart. A read that picks up where a stream
+ * ended continues it; any other read starts a stream in place of the
+ * least recently used one. After RA_SEQ_READS reads in a row on a
+ * stream, the fd is advised POSIX_FADV_SEQUENTIAL and readahead() keeps a
+ * window ahead of that stream; the window starts at RA_MIN_WINDOW and
+ * doubles each time it is topped up, up to b->ra_max. After
+ * RA_RANDOM_READS reads that continue no stream, the fd is advised
+ * POSIX_FADV_RANDOM so the kernel stops reading around them, but not
+ * while a stream on it is still sequential. A read-only stream that has
+ * run for RA_DROP_AFTER drops what lies more than RA_DROP_KEEP behind it
+ * with POSIX_FADV_DONTNEED, so one pass over a big file doesn't push the
+ * rest of the page cache out; it never drops what another sequential
+ * stream has yet to reach.
+ *
+ * Advice belongs to the open file, so handles on a cached fd share the
+ * state in its fd_entry; other handles keep their own. A read that finds
+ * another read on the same file updating the state leaves it alone.
+ */
+#define RA_STREAMS       4
+#define RA_SEQ_READS     2
+#define RA_RANDOM_READS  4
+#define RA_MIN_WINDOW    (256 * 1024)
+#define RA_MAX_DEFAULT   (8 * 1024 * 1024)
+#define RA_DROP_AFTER    ((off_t)32 * 1024 * 1024)
+#define RA_DROP_KEEP     ((off_t)4 * 1024 * 1024)
+#define RA_DROP_CHUNK    ((off_t)4 * 1024 * 1024)
+
+typedef struct ra_stream {
+    int seq;                         /* reads in a row that followed on */
+    unsigned long used;              /* rp->clock at its last read */
+    off_t next;                      /* where a sequential read starts */
+    off_t start;                     /* where the stream started */
+    off_t ra_end;                    /* readahead issued up to here */
+    off_t dropped;                   /* dropped from the page cache below here */
+    size_t window;                   /* next readahead size, 0 before the first */
+} ra_stream_t;
+
+typedef struct read_pattern {
+    _Atomic int busy;                /* a read is updating the fields below */
+    int readonly;                    /* opened O_RDONLY: nothing dirty to drop */
+    int advice;                      /* last POSIX_FADV_* given */
+    int rnd;                         /* reads in a row that continued no stream */
+    unsigned long clock;             /* reads tracked, for picking the LRU stream */
+    ra_stream_t streams[RA_STREAMS]; /* all expect a read at 0 to begin with */
+} read_pattern_t;
+
+struct fd_entry;
 
 typedef struct backend_handle {
-    int fd;
-    int in_use;
+    _Atomic int fd;                  /* -1 while the slot is free */
+    _Atomic uint32_t next_free;      /* free-list link */
+    struct fd_entry *fde;            /* fd shared through the open fd cache */
+    read_pattern_t rp;               /* unless fde is set */
 } backend_handle_t;
 
+/*
+ * Directory fd cache: O_PATH fds for recently used directories, keyed by
+ * their path below the root. Path operations look up the parent here and
+ * then act on the last component with the *at() calls. On a miss the
+ * parent is opened relative to its deepest cached ancestor (or the root
+ * fd), so the kernel only walks the part that isn't cached.
+ *
+ * Entries are pinned while in use. An entry evicted or invalidated while
+ * pinned is closed by its last user. Renames and removals made through
+ * the backend drop the entries at and below the old path. Directories
+ * renamed on the host behind the backend's back are not noticed.
+ */
+#define DIR_CACHE_MAX     256
+#define DIR_CACHE_BUCKETS 512
+
+typedef struct dir_entry {
+    struct dir_entry *hnext;         /* hash chain */
+    struct dir_entry *prev, *next;   /* LRU list, most recent first */
+    int fd;
+    int refs;                        /* users, plus one while cached */
+    size_t len;
+    char path[];                     /* below the root, no trailing '/' */
+} dir_entry_t;
+
+/*
+ * Open fd cache: fds of plain opens stay open after the last close and
+ * serve the next open of the same path with the same access mode without
+ * a syscall. Handles on one (path, mode) share the fd; pread/pwrite never
+ * move its offset. Each entry records the (dev, ino) it was opened on and
+ * is checked against the path with one fstatat before it is handed out:
+ * read-only entries once FD_CACHE_TTL_NS has passed, so a file replaced on
+ * the host is noticed within that time, writable ones on every open, so
+ * writes never go to a file that the path no longer names.
+ * Unlinks and renames through the backend drop the entries at and below
+ * their paths at once. As with directory entries, an entry evicted while
+ * handles still use it is closed by the last of them.
+ */
+#define FD_CACHE_DEFAULT 128
+#define FD_CACHE_BUCKETS 256
+#define FD_CACHE_TTL_NS  1000000000ull
+
+typedef struct fd_entry {
+    struct fd_entry *hnext;          /* hash chain */
+    struct fd_entry *prev, *next;    /* LRU list, most recent first */
+    int fd;
+    int acc;                         /* O_RDONLY, O_WRONLY or O_RDWR */
+    int refs;                        /* handles, plus one while cached */
+    dev_t dev;
+    ino_t ino;
+    uint64_t checked;                /* when (dev, ino) last matched the path */
+    read_pattern_t rp;               /* shared by the handles on fd */
+    size_t len;
+    char path[];                     /* below the root */
+} fd_entry_t;
+
 typedef struct posix_backend {
     int id;
     char *rootpath;                  /* absolute path to backend root */
-    pthread_mutex_t lock;            /* protects handles/table */
-    backend_handle_t *handles;       /* dynamic array indexed by (handle-1) */
-    size_t handle_cap;
+    int rootfd;                      /* O_PATH handle on the backing dir */
+    pthread_mutex_t dir_lock;        /* protects the directory cache */
+    dir_entry_t *dir_hash[DIR_CACHE_BUCKETS];
+    dir_entry_t *dir_lru, *dir_lru_tail;
+    size_t ndirs;
+    unsigned long dir_gen;           /* bumped by every invalidation */
+    pthread_mutex_t fd_lock;         /* protects the open fd cache */
+    fd_entry_t *fd_hash[FD_CACHE_BUCKETS];
+    fd_entry_t *fd_lru, *fd_lru_tail;
+    size_t nfds, fd_max;
+    unsigned long fd_gen;            /* bumped by every invalidation */
+    uint64_t fd_hits, fd_misses, fd_checks;
+    _Atomic size_t ra_max;           /* readahead window limit, 0: no tracking */
+    _Atomic uint64_t ra_seq, ra_random, ra_bytes, ra_dropped;
+    pthread_mutex_t lock;            /* serializes growing the handle table */
+    _Atomic(backend_handle_t *) segs[HANDLE_MAX_SEGS];
+    _Atomic uint64_t free_head;      /* ABA tag << 32 | slot (HANDLE_NONE: empty) */
+    unsigned int nsegs;              /* under lock */
+    _Atomic int no_reflink;          /* the host fs said clones are unsupported */
 } posix_backend_t;
 
 /* Simple global registry for backends */
@@ -84,100 +226,587 @@ static void free_backend_slot(int backend_id) {
     pthread_mutex_unlock(&backends_lock);
 }
 
-/* join rootpath and relpath safely into out (size out_sz). relpath must be relative */
-static int join_backend_path(const char *root, const char *relpath, char *out, size_t out_sz) {
-    if (!root || !relpath || !out) { errno = EINVAL; return -1; }
-    if (relpath[0] == '/') {
+/* ---- Directory fd cache ---- */
+
+/* Keys are whole paths below the root, often hundreds of bytes deep in a
+ * tree: hash them eight bytes at a time */
+static uint32_t path_hash(const char *path, size_t len) {
+    const uint64_t k = 0x9E3779B97F4A7C15ull;
+    uint64_t h = len * k, w;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        memcpy(&w, path + i, 8);
+        h = (h ^ w) * k;
+    }
+    if (i < len) {
+        w = 0;
+        memcpy(&w, path + i, len - i);
+        h = (h ^ w) * k;
+    }
+    h ^= h >> 32;
+    return (uint32_t)(h ^ (h >> 17));
+}
+
+/* Find path[0..len) and make it most recent. Called with dir_lock held */
+static dir_entry_t *dir_find(posix_backend_t *b, const char *path, size_t len) {
+    dir_entry_t *e = b->dir_hash[path_hash(path, len) % DIR_CACHE_BUCKETS];
+    while (e && (e->len != len || memcmp(e->path, path, len) != 0)) e = e->hnext;
+    if (!e || e == b->dir_lru) return e;
+    /* move to the front of the LRU list */
+    e->prev->next = e->next;
+    if (e->next) e->next->prev = e->prev; else b->dir_lru_tail = e->prev;
+    e->prev = NULL;
+    e->next = b->dir_lru;
+    b->dir_lru->prev = e;
+    b->dir_lru = e;
+    return e;
+}
+
+/* Drop a reference; the last one closes the fd. Called with dir_lock held */
+static void dir_unref(dir_entry_t *e) {
+    if (--e->refs > 0) return;
+    close(e->fd);
+    free(e);
+}
+
+/* Take e out of the cache and drop the cache's reference */
+static void dir_remove(posix_backend_t *b, dir_entry_t *e) {
+    dir_entry_t **pp = &b->dir_hash[path_hash(e->path, e->len) % DIR_CACHE_BUCKETS];
+    while (*pp != e) pp = &(*pp)->hnext;
+    *pp = e->hnext;
+    if (e->prev) e->prev->next = e->next; else b->dir_lru = e->next;
+    if (e->next) e->next->prev = e->prev; else b->dir_lru_tail = e->prev;
+    b->ndirs--;
+    dir_unref(e);
+}
+
+static void dir_release(posix_backend_t *b, dir_entry_t *pin) {
+    if (!pin) return;
+    pthread_mutex_lock(&b->dir_lock);
+    dir_unref(pin);
+    pthread_mutex_unlock(&b->dir_lock);
+}
+
+/* fd of the directory path[0..len) (the root when len is 0). *pin is
+ * the entry to hand back to dir_release, NULL for the root. -1 with
+ * errno set when the directory can't be opened */
+static int dir_get(posix_backend_t *b, const char *path, size_t len, dir_entry_t **pin) {
+    *pin = NULL;
+    if (len == 0) return b->rootfd;
+    if (len >= PATH_BUFSZ) { errno = ENAMETOOLONG; return -1; }
+
+    pthread_mutex_lock(&b->dir_lock);
+    dir_entry_t *e = dir_find(b, path, len);
+    if (e) {
+        e->refs++;
+        pthread_mutex_unlock(&b->dir_lock);
+        *pin = e;
+        return e->fd;
+    }
+    /* Deepest cached ancestor; the kernel walks the rest */
+    dir_entry_t *anc = NULL;
+    size_t alen = len;
+    while (alen > 0) {
+        while (alen > 0 && path[alen - 1] != '/') alen--;
+        while (alen > 0 && path[alen - 1] == '/') alen--;
+        if (alen > 0 && (anc = dir_find(b, path, alen)) != NULL) {
+            anc->refs++;
+            break;
+        }
+    }
+    unsigned long gen = b->dir_gen;
+    pthread_mutex_unlock(&b->dir_lock);
+
+    char rest[PATH_BUFSZ];
+    size_t skip = alen;
+    while (skip < len && path[skip] == '/') skip++;
+    memcpy(rest, path + skip, len - skip);
+    rest[len - skip] = '\0';
+    int fd = openat(anc ? anc->fd : b->rootfd, rest, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    int err = errno;
+    dir_release(b, anc);
+    if (fd < 0) { errno = err; return -1; }
+
+    e = malloc(sizeof(*e) + len + 1);
+    if (!e) { close(fd); errno = ENOMEM; return -1; }
+    e->fd = fd;
+    e->refs = 1;
+    e->len = len;
+    memcpy(e->path, path, len);
+    e->path[len] = '\0';
+
+    pthread_mutex_lock(&b->dir_lock);
+    dir_entry_t *old = dir_find(b, path, len);
+    if (old) {
+        /* somebody else cached it first */
+        old->refs++;
+        pthread_mutex_unlock(&b->dir_lock);
+        close(fd);
+        free(e);
+        *pin = old;
+        return old->fd;
+    }
+    if (gen == b->dir_gen) {
+        /* nothing was renamed meanwhile, so fd is still what path names */
+        dir_entry_t **bucket = &b->dir_hash[path_hash(path, len) % DIR_CACHE_BUCKETS];
+        e->hnext = *bucket;
+        *bucket = e;
+        e->prev = NULL;
+        e->next = b->dir_lru;
+        if (b->dir_lru) b->dir_lru->prev = e; else b->dir_lru_tail = e;
+        b->dir_lru = e;
+        e->refs++;
+        if (++b->ndirs > DIR_CACHE_MAX) dir_remove(b, b->dir_lru_tail);
+    }
+    pthread_mutex_unlock(&b->dir_lock);
+    *pin = e;
+    return fd;
+}
+
+/* The directory at relpath, if it was one, and everything below it were
+ * renamed or removed */
+static void dir_invalidate(posix_backend_t *b, const char *relpath) {
+    size_t len = strlen(relpath);
+    while (len > 0 && relpath[len - 1] == '/') len--;
+    pthread_mutex_lock(&b->dir_lock);
+    b->dir_gen++;
+    dir_entry_t *next;
+    for (dir_entry_t *e = b->dir_lru; e; e = next) {
+        next = e->next;
+        if (e->len >= len && memcmp(e->path, relpath, len) == 0 &&
+            (e->len == len || e->path[len] == '/'))
+            dir_remove(b, e);
+    }
+    pthread_mutex_unlock(&b->dir_lock);
+}
+
+/* relpath as a parent directory fd and a last component for the *at()
+ * calls; release at->pin with dir_release when done */
+typedef struct at_path {
+    int dfd;
+    const char *name;
+    dir_entry_t *pin;
+} at_path_t;
+
+static int resolve_at(posix_backend_t *b, const char *relpath, at_path_t *at) {
+    if (!relpath || relpath[0] == '/') {
         /* disallow absolute relpath for safety */
         errno = EINVAL;
         return -1;
     }
-    int n = snprintf(out, out_sz, "%s/%s", root, relpath);
-    if (n < 0 || (size_t)n >= out_sz) { errno = ENAMETOOLONG; return -1; }
-    return 0;
+    size_t end = strlen(relpath);
+    while (end > 0 && relpath[end - 1] == '/') end--;
+    size_t slash = end;
+    while (slash > 0 && relpath[slash - 1] != '/') slash--;
+    at->name = end ? relpath + slash : ".";
+    size_t plen = slash;
+    while (plen > 0 && relpath[plen - 1] == '/') plen--;
+    at->dfd = dir_get(b, relpath, plen, &at->pin);
+    return at->dfd < 0 ? -1 : 0;
+}
+
+static void dir_cache_clear(posix_backend_t *b) {
+    pthread_mutex_lock(&b->dir_lock);
+    while (b->dir_lru) dir_remove(b, b->dir_lru);
+    pthread_mutex_unlock(&b->dir_lock);
+}
+
+/* ---- Open fd cache ---- */
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Opens whose fd can be shared: no creation, truncation or fd-wide state */
+static int fd_cacheable(int flags) {
+    return (flags & ~(O_ACCMODE | O_CLOEXEC | O_LARGEFILE)) == 0 &&
+           (flags & O_ACCMODE) != O_ACCMODE;
+}
+
+static uint32_t fd_bucket(const char *path, size_t len, int acc) {
+    return (path_hash(path, len) ^ (uint32_t)acc) % FD_CACHE_BUCKETS;
+}
+
+/* Find (path, acc) and make it most recent. Called with fd_lock held */
+static fd_entry_t *fd_find(posix_backend_t *b, const char *path, size_t len, int acc) {
+    fd_entry_t *e = b->fd_hash[fd_bucket(path, len, acc)];
+    while (e && (e->acc != acc || e->len != len || memcmp(e->path, path, len) != 0))
+        e = e->hnext;
+    if (!e || e == b->fd_lru) return e;
+    e->prev->next = e->next;
+    if (e->next) e->next->prev = e->prev; else b->fd_lru_tail = e->prev;
+    e->prev = NULL;
+    e->next = b->fd_lru;
+    b->fd_lru->prev = e;
+    b->fd_lru = e;
+    return e;
+}
+
+/* Drop a reference; the last one closes the fd. Called with fd_lock held */
+static void fd_unref(fd_entry_t *e) {
+    if (--e->refs > 0) return;
+    close(e->fd);
+    free(e);
 }
 
-/* Ensure backend handle table has capacity */
-static int ensure_handle_capacity(posix_backend_t *b, size_t min_cap) {
-    if (b->handle_cap >= min_cap) return 0;
-    size_t new_cap = b->handle_cap ? b->handle_cap * 2 : INITIAL_HANDLE_CAP;
-    while (new_cap < min_cap) new_cap *= 2;
-    backend_handle_t *new_table = realloc(b->handles, new_cap * sizeof(backend_handle_t));
-    if (!new_table) return -1;
-    /* initialize new entries */
-    for (size_t i = b->handle_cap; i < new_cap; ++i) {
-        new_table[i].in_use = 0;
-        new_table[i].fd = -1;
-    }
-    b->handles = new_table;
-    b->handle_cap = new_cap;
+/* Take e out of the cache and drop the cache's reference */
+static void fd_remove(posix_backend_t *b, fd_entry_t *e) {
+    fd_entry_t **pp = &b->fd_hash[fd_bucket(e->path, e->len, e->acc)];
+    while (*pp != e) pp = &(*pp)->hnext;
+    *pp = e->hnext;
+    if (e->prev) e->prev->next = e->next; else b->fd_lru = e->next;
+    if (e->next) e->next->prev = e->prev; else b->fd_lru_tail = e->prev;
+    b->nfds--;
+    fd_unref(e);
+}
+
+static void fd_release(posix_backend_t *b, fd_entry_t *e) {
+    pthread_mutex_lock(&b->fd_lock);
+    fd_unref(e);
+    pthread_mutex_unlock(&b->fd_lock);
+}
+
+/*
+ * A referenced entry for (relpath, acc), or NULL on a miss. A writable
+ * entry, or a read-only one past its TTL, is checked against the path
+ * first and dropped if the path now names another file. *gen is for
+ * fd_insert after a miss.
+ */
+static fd_entry_t *fd_lookup(posix_backend_t *b, const char *relpath, int acc,
+                             unsigned long *gen) {
+    size_t len = strlen(relpath);
+    pthread_mutex_lock(&b->fd_lock);
+    *gen = b->fd_gen;
+    fd_entry_t *e = b->fd_max ? fd_find(b, relpath, len, acc) : NULL;
+    if (!e) {
+        b->fd_misses++;
+        pthread_mutex_unlock(&b->fd_lock);
+        return NULL;
+    }
+    e->refs++;
+    uint64_t now = monotonic_ns();
+    if (acc == O_RDONLY && now - e->checked < FD_CACHE_TTL_NS) {
+        b->fd_hits++;
+        pthread_mutex_unlock(&b->fd_lock);
+        return e;
+    }
+    b->fd_checks++;
+    pthread_mutex_unlock(&b->fd_lock);
+
+    struct stat st;
+    at_path_t at;
+    int same = resolve_at(b, relpath, &at) == 0;
+    if (same) {
+        same = fstatat(at.dfd, at.name, &st, 0) == 0 &&
+               st.st_dev == e->dev && st.st_ino == e->ino;
+        dir_release(b, at.pin);
+    }
+
+    pthread_mutex_lock(&b->fd_lock);
+    *gen = b->fd_gen;
+    if (same) {
+        e->checked = now;
+        b->fd_hits++;
+    } else {
+        if (fd_find(b, e->path, e->len, acc) == e) fd_remove(b, e);
+        fd_unref(e);
+        e = NULL;
+        b->fd_misses++;
+    }
+    pthread_mutex_unlock(&b->fd_lock);
+    return e;
+}
+
+/* Fresh read-pattern state for a newly opened file */
+static void rp_init(read_pattern_t *rp, int readonly) {
+    memset(rp, 0, sizeof(*rp));
+    rp->readonly = readonly;
+    rp->advice = POSIX_FADV_NORMAL;
+}
+
+/* Cache fd, just opened as relpath for acc, and return the entry with a
+ * reference for the caller; NULL leaves fd to the caller */
+static fd_entry_t *fd_insert(posix_backend_t *b, const char *relpath, int acc, int fd,
+                             unsigned long gen) {
+    struct stat st;
+    size_t len = strlen(relpath);
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return NULL;
+    fd_entry_t *e = malloc(sizeof(*e) + len + 1);
+    if (!e) return NULL;
+    e->fd = fd;
+    e->acc = acc;
+    e->refs = 2;
+    e->dev = st.st_dev;
+    e->ino = st.st_ino;
+    e->checked = monotonic_ns();
+    rp_init(&e->rp, acc == O_RDONLY);
+    e->len = len;
+    memcpy(e->path, relpath, len + 1);
+
+    pthread_mutex_lock(&b->fd_lock);
+    if (gen != b->fd_gen || !b->fd_max || fd_find(b, relpath, len, acc)) {
+        /* renamed or unlinked meanwhile, cache off, or cached by somebody else */
+        pthread_mutex_unlock(&b->fd_lock);
+        free(e);
+        return NULL;
+    }
+    fd_entry_t **bucket = &b->fd_hash[fd_bucket(relpath, len, acc)];
+    e->hnext = *bucket;
+    *bucket = e;
+    e->prev = NULL;
+    e->next = b->fd_lru;
+    if (b->fd_lru) b->fd_lru->prev = e; else b->fd_lru_tail = e;
+    b->fd_lru = e;
+    if (++b->nfds > b->fd_max) fd_remove(b, b->fd_lru_tail);
+    pthread_mutex_unlock(&b->fd_lock);
+    return e;
+}
+
+/* The file at relpath, or everything below it, was renamed or removed */
+static void fd_invalidate(posix_backend_t *b, const char *relpath) {
+    size_t len = strlen(relpath);
+    while (len > 0 && relpath[len - 1] == '/') len--;
+    pthread_mutex_lock(&b->fd_lock);
+    b->fd_gen++;
+    fd_entry_t *next;
+    for (fd_entry_t *e = b->fd_lru; e; e = next) {
+        next = e->next;
+        if (e->len >= len && memcmp(e->path, relpath, len) == 0 &&
+            (e->len == len || e->path[len] == '/'))
+            fd_remove(b, e);
+    }
+    pthread_mutex_unlock(&b->fd_lock);
+}
+
+int posix_fd_cache_set_size(int backend_id, int entries) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b || entries < 0) { errno = EINVAL; return -1; }
+    pthread_mutex_lock(&b->fd_lock);
+    b->fd_max = (size_t)entries;
+    while (b->nfds > b->fd_max) fd_remove(b, b->fd_lru_tail);
+    pthread_mutex_unlock(&b->fd_lock);
     return 0;
 }
 
-/* Create a new handle entry for fd, return handle (>0) or -1 */
-static int create_handle(posix_backend_t *b, int fd) {
+int posix_fd_cache_stats(int backend_id, uint64_t *hits, uint64_t *misses, uint64_t *checks) {
+    posix_backend_t *b = get_backend(backend_id);
     if (!b) { errno = EINVAL; return -1; }
-    pthread_mutex_lock(&b->lock);
-    /* find free slot */
-    for (size_t i = 0; i < b->handle_cap; ++i) {
-        if (!b->handles[i].in_use) {
-            b->handles[i].in_use = 1;
-            b->handles[i].fd = fd;
-            int handle = (int)(i + 1);
-            pthread_mutex_unlock(&b->lock);
-            return handle;
-        }
-    }
-    /* need more capacity */
-    size_t need = b->handle_cap ? b->handle_cap * 2 : INITIAL_HANDLE_CAP;
-    if (ensure_handle_capacity(b, need) != 0) {
-        pthread_mutex_unlock(&b->lock);
-        errno = ENOMEM;
-        return -1;
+    pthread_mutex_lock(&b->fd_lock);
+    if (hits) *hits = b->fd_hits;
+    if (misses) *misses = b->fd_misses;
+    if (checks) *checks = b->fd_checks;
+    pthread_mutex_unlock(&b->fd_lock);
+    return 0;
+}
+
+/* ---- Handle table ---- */
+
+static backend_handle_t *handle_slot(posix_backend_t *b, uint32_t idx) {
+    if ((idx >> HANDLE_SEG_SHIFT) >= HANDLE_MAX_SEGS) return NULL;
+    backend_handle_t *seg = atomic_load_explicit(&b->segs[idx >> HANDLE_SEG_SHIFT],
+                                                 memory_order_acquire);
+    return seg ? &seg[idx & (HANDLE_SEG_SIZE - 1)] : NULL;
+}
+
+/* Push the chain first..last (already linked through next_free) */
+static void handle_push(posix_backend_t *b, uint32_t first, backend_handle_t *last) {
+    uint64_t head = atomic_load_explicit(&b->free_head, memory_order_relaxed);
+    uint64_t next;
+    do {
+        atomic_store_explicit(&last->next_free, (uint32_t)head, memory_order_relaxed);
+        next = ((head >> 32) + 1) << 32 | first;
+    } while (!atomic_compare_exchange_weak_explicit(&b->free_head, &head, next,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+/* Pop a free slot; HANDLE_NONE when the list is empty */
+static uint32_t handle_pop(posix_backend_t *b) {
+    uint64_t head = atomic_load_explicit(&b->free_head, memory_order_acquire);
+    for (;;) {
+        uint32_t idx = (uint32_t)head;
+        if (idx == HANDLE_NONE) return HANDLE_NONE;
+        /* a stale link is harmless: the tag fails the exchange if the head moved */
+        uint32_t nxt = atomic_load_explicit(&handle_slot(b, idx)->next_free,
+                                            memory_order_relaxed);
+        uint64_t next = ((head >> 32) + 1) << 32 | nxt;
+        if (atomic_compare_exchange_weak_explicit(&b->free_head, &head, next,
+                                                  memory_order_acquire,
+                                                  memory_order_acquire))
+            return idx;
     }
-    /* after resize, allocate first new slot */
-    for (size_t i = 0; i < b->handle_cap; ++i) {
-        if (!b->handles[i].in_use) {
-            b->handles[i].in_use = 1;
-            b->handles[i].fd = fd;
-            int handle = (int)(i + 1);
-            pthread_mutex_unlock(&b->lock);
-            return handle;
-        }
+}
+
+/* Add a segment of free slots; 0, or -1 with errno set */
+static int handle_grow(posix_backend_t *b) {
+    int ret = 0;
+    pthread_mutex_lock(&b->lock);
+    if ((uint32_t)atomic_load(&b->free_head) != HANDLE_NONE) goto out;  /* freed or grown meanwhile */
+    if (b->nsegs == HANDLE_MAX_SEGS) { errno = EMFILE; ret = -1; goto out; }
+    backend_handle_t *seg = malloc(HANDLE_SEG_SIZE * sizeof(*seg));
+    if (!seg) { errno = ENOMEM; ret = -1; goto out; }
+    uint32_t base = b->nsegs << HANDLE_SEG_SHIFT;
+    for (uint32_t i = 0; i < HANDLE_SEG_SIZE; ++i) {
+        atomic_init(&seg[i].fd, -1);
+        atomic_init(&seg[i].next_free, base + i + 1);
     }
+    atomic_store_explicit(&b->segs[b->nsegs], seg, memory_order_release);
+    b->nsegs++;
+    handle_push(b, base, &seg[HANDLE_SEG_SIZE - 1]);
+out:
     pthread_mutex_unlock(&b->lock);
-    errno = ENOMEM;
-    return -1;
+    return ret;
+}
+
+/* Create a new handle entry for fd (shared through fde, if not NULL),
+ * return handle (>0) or -1 */
+static int create_handle(posix_backend_t *b, int fd, fd_entry_t *fde, int readonly) {
+    if (!b) { errno = EINVAL; return -1; }
+    uint32_t idx;
+    while ((idx = handle_pop(b)) == HANDLE_NONE)
+        if (handle_grow(b) != 0) return -1;
+    backend_handle_t *h = handle_slot(b, idx);
+    h->fde = fde;
+    if (!fde) rp_init(&h->rp, readonly);
+    atomic_store_explicit(&h->fd, fd, memory_order_release);
+    return (int)idx + 1;
 }
 
 /* Lookup handle -> fd, return fd or -1 and set errno */
 static int lookup_fd(posix_backend_t *b, int handle) {
     if (!b || handle <= 0) { errno = EINVAL; return -1; }
-    size_t idx = (size_t)(handle - 1);
-    pthread_mutex_lock(&b->lock);
-    if (idx >= b->handle_cap || !b->handles[idx].in_use) {
-        pthread_mutex_unlock(&b->lock);
-        errno = EBADF;
-        return -1;
-    }
-    int fd = b->handles[idx].fd;
-    pthread_mutex_unlock(&b->lock);
+    backend_handle_t *h = handle_slot(b, (uint32_t)(handle - 1));
+    int fd = h ? atomic_load_explicit(&h->fd, memory_order_acquire) : -1;
+    if (fd < 0) { errno = EBADF; return -1; }
     return fd;
 }
 
-/* free handle */
-static int free_handle(posix_backend_t *b, int handle) {
+/* Free handle; returns the fd it held or -1. The caller closes the fd,
+ * or releases *fde instead when the fd came from the open fd cache */
+static int free_handle(posix_backend_t *b, int handle, fd_entry_t **fde) {
     if (!b || handle <= 0) { errno = EINVAL; return -1; }
-    size_t idx = (size_t)(handle - 1);
-    pthread_mutex_lock(&b->lock);
-    if (idx >= b->handle_cap || !b->handles[idx].in_use) {
-        pthread_mutex_unlock(&b->lock);
-        errno = EBADF;
-        return -1;
+    uint32_t idx = (uint32_t)(handle - 1);
+    backend_handle_t *h = handle_slot(b, idx);
+    int fd = h ? atomic_exchange_explicit(&h->fd, -1, memory_order_acq_rel) : -1;
+    if (fd < 0) { errno = EBADF; return -1; }
+    *fde = h->fde;
+    h->fde = NULL;
+    handle_push(b, idx, h);
+    return fd;
+}
+
+/* ---- Read-pattern tracking ---- */
+
+static void ra_advise(posix_backend_t *b, read_pattern_t *rp, int fd, int advice) {
+    rp->advice = advice;
+    if (posix_fadvise(fd, 0, 0, advice) == 0)
+        atomic_fetch_add_explicit(advice == POSIX_FADV_SEQUENTIAL ? &b->ra_seq : &b->ra_random,
+                                  1, memory_order_relaxed);
+}
+
+/* The stream a read at off continues, or the least recently used one,
+ * started over at off */
+static ra_stream_t *ra_stream(read_pattern_t *rp, off_t off) {
+    ra_stream_t *lru = &rp->streams[0];
+    for (int i = 0; i < RA_STREAMS; ++i) {
+        ra_stream_t *s = &rp->streams[i];
+        if (s->next == off) {
+            if (s->seq < RA_SEQ_READS) s->seq++;
+            return s;
+        }
+        if (s->used < lru->used) lru = s;
     }
-    b->handles[idx].in_use = 0;
-    b->handles[idx].fd = -1;
-    pthread_mutex_unlock(&b->lock);
+    lru->seq = 0;
+    lru->start = lru->dropped = off;
+    lru->window = 0;
+    if (rp->rnd < RA_RANDOM_READS) rp->rnd++;
+    return lru;
+}
+
+/* Where s may drop the page cache up to: RA_DROP_KEEP behind end, and
+ * not past another sequential stream that has yet to get there */
+static off_t ra_drop_limit(const read_pattern_t *rp, const ra_stream_t *s, off_t end) {
+    off_t upto = end - RA_DROP_KEEP;
+    for (int i = 0; i < RA_STREAMS; ++i) {
+        const ra_stream_t *o = &rp->streams[i];
+        if (o != s && o->seq == RA_SEQ_READS && o->next < upto) upto = o->next;
+    }
+    return upto;
+}
+
+/* Note a read of n bytes at off that asked for count */
+static void ra_track(posix_backend_t *b, int handle, int fd, off_t off, size_t count, size_t n) {
+    size_t max = atomic_load_explicit(&b->ra_max, memory_order_relaxed);
+    if (!max || !n) return;
+    backend_handle_t *h = handle_slot(b, (uint32_t)(handle - 1));
+    read_pattern_t *rp = h->fde ? &h->fde->rp : &h->rp;
+    if (atomic_exchange_explicit(&rp->busy, 1, memory_order_acquire)) return;
+
+    off_t end = off + (off_t)n;
+    ra_stream_t *s = ra_stream(rp, off);
+    s->next = end;
+    s->used = ++rp->clock;
+
+    if (s->seq == RA_SEQ_READS) {
+        rp->rnd = 0;
+        if (rp->advice != POSIX_FADV_SEQUENTIAL)
+            ra_advise(b, rp, fd, POSIX_FADV_SEQUENTIAL);
+
+        /* Start a window, or double it once the reader is within half a
+         * window of its end; a short read hit EOF with nothing to fetch */
+        int top_up = 0;
+        if (!s->window) {
+            s->window = max < RA_MIN_WINDOW ? max : RA_MIN_WINDOW;
+            s->ra_end = end;
+            top_up = 1;
+        } else if (s->ra_end - end <= (off_t)(s->window / 2)) {
+            s->window = s->window * 2 < max ? s->window * 2 : max;
+            top_up = 1;
+        }
+        if (top_up && n == count) {
+            off_t to = end + (off_t)s->window;
+            if (s->ra_end < end) s->ra_end = end;
+            if (readahead(fd, s->ra_end, (size_t)(to - s->ra_end)) == 0)
+                atomic_fetch_add_explicit(&b->ra_bytes, (uint64_t)(to - s->ra_end),
+                                          memory_order_relaxed);
+            s->ra_end = to;
+        }
+
+        off_t upto = ra_drop_limit(rp, s, end);
+        if (rp->readonly && end - s->start >= RA_DROP_AFTER &&
+            upto - s->dropped >= RA_DROP_CHUNK) {
+            if (posix_fadvise(fd, s->dropped, upto - s->dropped, POSIX_FADV_DONTNEED) == 0)
+                atomic_fetch_add_explicit(&b->ra_dropped, (uint64_t)(upto - s->dropped),
+                                          memory_order_relaxed);
+            s->dropped = upto;
+        }
+    } else if (rp->rnd == RA_RANDOM_READS && rp->advice != POSIX_FADV_RANDOM) {
+        int streaming = 0;
+        for (int i = 0; i < RA_STREAMS; ++i)
+            streaming |= rp->streams[i].seq == RA_SEQ_READS;
+        if (!streaming)
+            ra_advise(b, rp, fd, POSIX_FADV_RANDOM);
+    }
+    atomic_store_explicit(&rp->busy, 0, memory_order_release);
+}
+
+int posix_readahead_set_window(int backend_id, size_t max_bytes) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+    atomic_store_explicit(&b->ra_max, max_bytes, memory_order_relaxed);
+    return 0;
+}
+
+int posix_readahead_stats(int backend_id, uint64_t *sequential, uint64_t *random,
+                          uint64_t *readahead_bytes, uint64_t *dropped_bytes) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+    if (sequential) *sequential = atomic_load(&b->ra_seq);
+    if (random) *random = atomic_load(&b->ra_random);
+    if (readahead_bytes) *readahead_bytes = atomic_load(&b->ra_bytes);
+    if (dropped_bytes) *dropped_bytes = atomic_load(&b->ra_dropped);
     return 0;
 }
 
@@ -195,18 +824,33 @@ int posix_backend_init(const char *rootpath) {
         errno = ENOMEM;
         return -1;
     }
-    if (pthread_mutex_init(&b->lock, NULL) != 0) {
+    b->rootfd = open(rootpath, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (b->rootfd < 0) {
+        int err = errno;
+        free(b->rootpath);
+        free(b);
+        errno = err;
+        return -1;
+    }
+    if (pthread_mutex_init(&b->lock, NULL) != 0 ||
+        pthread_mutex_init(&b->dir_lock, NULL) != 0 ||
+        pthread_mutex_init(&b->fd_lock, NULL) != 0) {
+        close(b->rootfd);
         free(b->rootpath);
         free(b);
         errno = ENOMEM;
         return -1;
     }
-    b->handles = NULL;
-    b->handle_cap = 0;
+    atomic_init(&b->free_head, HANDLE_NONE);
+    b->fd_max = FD_CACHE_DEFAULT;
+    atomic_init(&b->ra_max, RA_MAX_DEFAULT);
 
     int id = allocate_backend_slot(b);
     if (id < 0) {
         pthread_mutex_destroy(&b->lock);
+        pthread_mutex_destroy(&b->dir_lock);
+        pthread_mutex_destroy(&b->fd_lock);
+        close(b->rootfd);
         free(b->rootpath);
         free(b);
         return -1;
@@ -219,21 +863,26 @@ int posix_backend_shutdown(int backend_id) {
     posix_backend_t *b = get_backend(backend_id);
     if (!b) { errno = EINVAL; return -1; }
 
-    /* close any open fds */
-    pthread_mutex_lock(&b->lock);
-    for (size_t i = 0; i < b->handle_cap; ++i) {
-        if (b->handles && b->handles[i].in_use) {
-            close(b->handles[i].fd);
-            b->handles[i].in_use = 0;
-            b->handles[i].fd = -1;
+    /* close any open fds; nothing else uses the backend by now */
+    for (unsigned int s = 0; s < b->nsegs; ++s) {
+        backend_handle_t *seg = atomic_load(&b->segs[s]);
+        for (uint32_t i = 0; i < HANDLE_SEG_SIZE; ++i) {
+            int fd = atomic_load(&seg[i].fd);
+            if (fd < 0) continue;
+            if (seg[i].fde) fd_release(b, seg[i].fde);
+            else close(fd);
         }
+        free(seg);
     }
-    pthread_mutex_unlock(&b->lock);
 
     /* free resources */
-    if (b->handles) free(b->handles);
+    posix_fd_cache_set_size(backend_id, 0);
+    dir_cache_clear(b);
+    close(b->rootfd);
     free(b->rootpath);
     pthread_mutex_destroy(&b->lock);
+    pthread_mutex_destroy(&b->dir_lock);
+    pthread_mutex_destroy(&b->fd_lock);
 
     free_backend_slot(backend_id);
     free(b);
@@ -243,19 +892,33 @@ int posix_backend_shutdown(int backend_id) {
 int posix_open(int backend_id, const char *relpath, int flags, mode_t mode) {
     posix_backend_t *b = get_backend(backend_id);
     if (!b) { errno = EINVAL; return -1; }
+    if (!relpath || relpath[0] == '/') { errno = EINVAL; return -1; }
 
-    char full[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, relpath, full, sizeof(full)) != 0) {
-        return -1;
+    /* A plain open of a file opened before shares the cached fd */
+    int acc = flags & O_ACCMODE;
+    int cacheable = fd_cacheable(flags);
+    unsigned long gen = 0;
+    fd_entry_t *fde = cacheable ? fd_lookup(b, relpath, acc, &gen) : NULL;
+    int fd;
+    if (fde) {
+        fd = fde->fd;
+    } else {
+        at_path_t at;
+        if (resolve_at(b, relpath, &at) != 0) return -1;
+        fd = openat(at.dfd, at.name, flags, mode);
+        int err = errno;
+        dir_release(b, at.pin);
+        if (fd < 0) { errno = err; return -1; }
+        if (cacheable) fde = fd_insert(b, relpath, acc, fd, gen);
     }
 
-    int fd = open(full, flags, mode);
-    if (fd < 0) return -1;
-
-    int handle = create_handle(b, fd);
+    int handle = create_handle(b, fd, fde, acc == O_RDONLY);
     if (handle < 0) {
-        /* failed to create logical handle; close FD to avoid leak */
-        close(fd);
+        /* failed to create logical handle; drop the FD to avoid a leak */
+        int err = errno;
+        if (fde) fd_release(b, fde);
+        else close(fd);
+        errno = err;
         return -1;
     }
     return handle;
@@ -265,11 +928,15 @@ int posix_close(int backend_id, int handle) {
     posix_backend_t *b = get_backend(backend_id);
     if (!b) { errno = EINVAL; return -1; }
 
-    int fd = lookup_fd(b, handle);
+    fd_entry_t *fde;
+    int fd = free_handle(b, handle, &fde);
     if (fd < 0) return -1;
-
-    if (close(fd) != 0) return -1;
-    return free_handle(b, handle);
+    if (fde) {
+        /* stays open in the cache (or closes with its last handle) */
+        fd_release(b, fde);
+        return 0;
+    }
+    return close(fd);
 }
 
 ssize_t posix_read(int backend_id, int handle, void *buf, size_t count, off_t offset) {
@@ -280,6 +947,7 @@ ssize_t posix_read(int backend_id, int handle, void *buf, size_t count, off_t of
     if (fd < 0) return -1;
 
     ssize_t r = pread(fd, buf, count, offset);
+    if (r > 0) ra_track(b, handle, fd, offset, count, (size_t)r);
     return r;
 }
 
@@ -294,49 +962,257 @@ ssize_t posix_write(int backend_id, int handle, const void *buf, size_t count, o
     return w;
 }
 
-int posix_stat(int backend_id, const char *relpath, struct stat *st) {
+/* Vectored forms: one preadv2/pwritev2 for the whole list. Kernels older
+ * than 4.6 lack the *v2 calls; plain preadv/pwritev do the same job when
+ * no RWF_* flags are passed. */
+ssize_t posix_readv(int backend_id, int handle, const struct iovec *iov, int iovcnt, off_t offset) {
     posix_backend_t *b = get_backend(backend_id);
-    if (!b || !st) { errno = EINVAL; return -1; }
+    if (!b) { errno = EINVAL; return -1; }
 
-    char full[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, relpath, full, sizeof(full)) != 0) {
-        return -1;
+    int fd = lookup_fd(b, handle);
+    if (fd < 0) return -1;
+
+    ssize_t r = preadv2(fd, iov, iovcnt, offset, 0);
+    if (r < 0 && errno == ENOSYS)
+        r = preadv(fd, iov, iovcnt, offset);
+    if (r > 0) {
+        size_t count = 0;
+        for (int i = 0; i < iovcnt; ++i) count += iov[i].iov_len;
+        ra_track(b, handle, fd, offset, count, (size_t)r);
     }
+    return r;
+}
+
+ssize_t posix_writev(int backend_id, int handle, const struct iovec *iov, int iovcnt, off_t offset) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+
+    int fd = lookup_fd(b, handle);
+    if (fd < 0) return -1;
+
+    ssize_t w = pwritev2(fd, iov, iovcnt, offset, 0);
+    if (w < 0 && errno == ENOSYS)
+        w = pwritev(fd, iov, iovcnt, offset);
+    return w;
+}
+
+int posix_fsync(int backend_id, int handle, int datasync) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+
+    int fd = lookup_fd(b, handle);
+    if (fd < 0) return -1;
+
+    return datasync ? fdatasync(fd) : fsync(fd);
+}
+
+/* Reflink the range if the filesystem shares extents: FICLONE for a whole
+ * file, FICLONERANGE for block-aligned ranges. Bytes cloned, or -1 when
+ * the caller should copy instead */
+static ssize_t try_clone(posix_backend_t *b, int fd_in, off_t off_in,
+                         int fd_out, off_t off_out, size_t len) {
+    if (atomic_load_explicit(&b->no_reflink, memory_order_relaxed)) return -1;
+
+    struct stat si, so;
+    if (fstat(fd_in, &si) != 0 || fstat(fd_out, &so) != 0) return -1;
+    if (si.st_dev != so.st_dev || si.st_ino == so.st_ino || off_in >= si.st_size) return -1;
+
+    /* Clones stop at the end of the source, like a copy would */
+    size_t avail = (size_t)(si.st_size - off_in);
+    size_t n = len < avail ? len : avail;
+    int ret;
+    if (off_in == 0 && off_out == 0 && n == avail) {
+        ret = ioctl(fd_out, FICLONE, fd_in);
+    } else {
+        off_t blk = si.st_blksize > 0 ? si.st_blksize : 4096;
+        int to_eof = n == avail;
+        if (off_in % blk || off_out % blk || (!to_eof && n % blk)) return -1;
+        struct file_clone_range r = {
+            .src_fd = fd_in,
+            .src_offset = (uint64_t)off_in,
+            .src_length = to_eof ? 0 : (uint64_t)n,
+            .dest_offset = (uint64_t)off_out,
+        };
+        ret = ioctl(fd_out, FICLONERANGE, &r);
+    }
+    if (ret == 0) return (ssize_t)n;
+    if (errno == EOPNOTSUPP || errno == ENOTTY)
+        atomic_store_explicit(&b->no_reflink, 1, memory_order_relaxed);
+    return -1;
+}
+
+ssize_t posix_copy_range(int backend_id, int handle_in, off_t off_in,
+                         int handle_out, off_t off_out, size_t len) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+
+    int fd_in = lookup_fd(b, handle_in);
+    if (fd_in < 0) return -1;
+    int fd_out = lookup_fd(b, handle_out);
+    if (fd_out < 0) return -1;
+
+    ssize_t cloned = try_clone(b, fd_in, off_in, fd_out, off_out, len);
+    if (cloned >= 0) return cloned;
+
+    /* The kernel may stop short of len; carry on until the source ends */
+    size_t done = 0;
+    while (done < len) {
+        loff_t oi = off_in + (off_t)done, oo = off_out + (off_t)done;
+        ssize_t n = copy_file_range(fd_in, &oi, fd_out, &oo, len - done, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (done) break;
+            if (errno == ENOSYS) errno = EOPNOTSUPP;
+            return -1;
+        }
+        if (n == 0) break;
+        done += (size_t)n;
+    }
+    return (ssize_t)done;
+}
+
+int posix_fd(int backend_id, int handle) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+
+    return lookup_fd(b, handle);
+}
 
-    if (stat(full, st) != 0) return -1;
+int posix_fd_read(int backend_id, int handle, off_t offset, size_t count) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b) { errno = EINVAL; return -1; }
+
+    int fd = lookup_fd(b, handle);
+    if (fd < 0) return -1;
+    ra_track(b, handle, fd, offset, count, count);
     return 0;
 }
 
-int posix_readdir(int backend_id, const char *relpath, void *buf, vfs_fill_dir_t filler, off_t offset) {
+int posix_stat(int backend_id, const char *relpath, struct stat *st) {
     posix_backend_t *b = get_backend(backend_id);
-    if (!b || !filler) { errno = EINVAL; return -1; }
+    if (!b || !st) { errno = EINVAL; return -1; }
 
-    char full[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, relpath, full, sizeof(full)) != 0) {
-        return -1;
+    at_path_t at;
+    if (resolve_at(b, relpath, &at) != 0) return -1;
+    int ret = fstatat(at.dfd, at.name, st, 0);
+    int err = errno;
+    dir_release(b, at.pin);
+    errno = err;
+    return ret;
+}
+
+/* ---- Directory streams ---- */
+
+/*
+ * An open directory and the getdents64 buffer it was last read into. An
+ * entry's cookie is its d_off, the position just after it, so lseek() to
+ * a cookie resumes there. A listing that carries on from where the last
+ * one stopped is served from the buffer without seeking.
+ */
+struct posix_dir {
+    int fd;
+    pthread_mutex_t lock;
+    char *dents;
+    size_t len, pos;                 /* bytes in dents, next entry */
+    off_t cookie;                    /* position of the entry at pos */
+};
+
+posix_dir_t *posix_opendir(int backend_id, const char *relpath) {
+    posix_backend_t *b = get_backend(backend_id);
+    if (!b || !relpath) { errno = EINVAL; return NULL; }
+
+    at_path_t at;
+    if (resolve_at(b, relpath, &at) != 0) return NULL;
+    int fd = openat(at.dfd, at.name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    int err = errno;
+    dir_release(b, at.pin);
+    if (fd < 0) { errno = err; return NULL; }
+
+    posix_dir_t *d = calloc(1, sizeof(*d));
+    if (d) d->dents = malloc(DIRENT_BUFSZ);
+    if (!d || !d->dents) {
+        free(d);
+        close(fd);
+        errno = ENOMEM;
+        return NULL;
     }
+    d->fd = fd;
+    pthread_mutex_init(&d->lock, NULL);
+    return d;
+}
 
-    DIR *d = opendir(full);
-    if (!d) return -1;
+int posix_readdir_stream(int backend_id, posix_dir_t *d, void *buf, vfs_fill_dir_t filler,
+                         off_t offset, int flags) {
+    if (!get_backend(backend_id) || !d || !filler || offset < 0) { errno = EINVAL; return -1; }
+
+    pthread_mutex_lock(&d->lock);
+    if (offset != d->cookie) {
+        if (lseek(d->fd, offset, SEEK_SET) < 0) {
+            int err = errno;
+            pthread_mutex_unlock(&d->lock);
+            errno = err;
+            return -1;
+        }
+        d->len = d->pos = 0;
+        d->cookie = offset;
+    }
 
-    struct dirent *de;
-    struct stat stbuf;
-    while ((de = readdir(d)) != NULL) {
-        /* Skip . and ..? Let filler decide; common to include them */
-        char childpath[PATH_BUFSZ];
-        int rc = snprintf(childpath, sizeof(childpath), "%s/%s", full, de->d_name);
-        if (rc < 0 || (size_t)rc >= sizeof(childpath)) {
-            continue;
+    /* Entries come in bulk with their type; attributes only on request */
+    int plus = flags & VFS_READDIR_PLUS;
+    int ret = 0;
+    for (;;) {
+        if (d->pos == d->len) {
+            ssize_t n = getdents64(d->fd, d->dents, DIRENT_BUFSZ);
+            if (n < 0) ret = -1;
+            d->len = n > 0 ? (size_t)n : 0;
+            d->pos = 0;
+            if (n <= 0) break;
         }
-        if (stat(childpath, &stbuf) != 0) {
-            memset(&stbuf, 0, sizeof(stbuf));
+        struct dirent64 *de = (struct dirent64 *)(d->dents + d->pos);
+
+        struct stat st;
+        int fill_flags = 0;
+        /* not following symlinks, so the type agrees with d_type */
+        if (plus && fstatat(d->fd, de->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+            fill_flags = VFS_FILL_DIR_PLUS;
+        } else {
+            memset(&st, 0, sizeof(st));
+            st.st_ino = de->d_ino;
+            st.st_mode = DTTOIF(de->d_type);
+            if (de->d_type == DT_UNKNOWN &&
+                fstatat(d->fd, de->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                st.st_mode = 0;
         }
-        /* call the filler - return value ignored here (FUSE uses non-zero to stop) */
-        filler(buf, de->d_name, &stbuf, 0);
+        /* non-zero: the caller's buffer is full; this entry comes first next time */
+        if (filler(buf, de->d_name, &st, de->d_off, fill_flags) != 0) break;
+        d->pos += de->d_reclen;
+        d->cookie = de->d_off;
     }
+    int err = errno;
+    pthread_mutex_unlock(&d->lock);
+    errno = err;
+    return ret;
+}
 
-    closedir(d);
-    return 0;
+int posix_closedir(int backend_id, posix_dir_t *d) {
+    if (!get_backend(backend_id) || !d) { errno = EINVAL; return -1; }
+    int ret = close(d->fd);
+    pthread_mutex_destroy(&d->lock);
+    free(d->dents);
+    free(d);
+    return ret;
+}
+
+int posix_readdir(int backend_id, const char *relpath, void *buf, vfs_fill_dir_t filler,
+                  off_t offset, int flags) {
+    if (!filler) { errno = EINVAL; return -1; }
+    posix_dir_t *d = posix_opendir(backend_id, relpath);
+    if (!d) return -1;
+    int ret = posix_readdir_stream(backend_id, d, buf, filler, offset, flags);
+    int err = errno;
+    posix_closedir(backend_id, d);
+    errno = err;
+    return ret;
 }
 
 /* Create file: open with O_CREAT|O_EXCL and return a handle */
@@ -344,15 +1220,14 @@ int posix_create(int backend_id, const char *relpath, mode_t mode) {
     posix_backend_t *b = get_backend(backend_id);
     if (!b || !relpath) { errno = EINVAL; return -1; }
 
-    char full[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, relpath, full, sizeof(full)) != 0) {
-        return -1;
-    }
-
-    int fd = open(full, O_CREAT | O_EXCL | O_RDWR, mode);
-    if (fd < 0) return -1;
+    at_path_t at;
+    if (resolve_at(b, relpath, &at) != 0) return -1;
+    int fd = openat(at.dfd, at.name, O_CREAT | O_EXCL | O_RDWR, mode);
+    int err = errno;
+    dir_release(b, at.pin);
+    if (fd < 0) { errno = err; return -1; }
 
-    int handle = create_handle(b, fd);
+    int handle = create_handle(b, fd, NULL, 0);
     if (handle < 0) {
         close(fd);
         return -1;
@@ -365,19 +1240,21 @@ int posix_unlink(int backend_id, const char *relpath) {
     posix_backend_t *b = get_backend(backend_id);
     if (!b || !relpath) { errno = EINVAL; return -1; }
 
-    char full[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, relpath, full, sizeof(full)) != 0) {
-        return -1;
-    }
+    at_path_t at;
+    if (resolve_at(b, relpath, &at) != 0) return -1;
 
-    /* Try unlink first */
-    if (unlink(full) == 0) return 0;
-
-    /* If unlink failed with EISDIR, try rmdir */
-    if (errno == EISDIR) {
-        if (rmdir(full) == 0) return 0;
+    /* Try unlink first; if it failed with EISDIR, try rmdir */
+    int ret = unlinkat(at.dfd, at.name, 0);
+    if (ret != 0 && errno == EISDIR) {
+        ret = unlinkat(at.dfd, at.name, AT_REMOVEDIR);
+        if (ret == 0) dir_invalidate(b, relpath);
     }
-    return -1;
+    int err = errno;
+    /* a cached fd would keep the removed file's blocks allocated */
+    if (ret == 0) fd_invalidate(b, relpath);
+    dir_release(b, at.pin);
+    errno = err;
+    return ret;
 }
 
 /* Rename within backend */
@@ -385,17 +1262,28 @@ int posix_rename(int backend_id, const char *old_relpath, const char *new_relpat
     posix_backend_t *b = get_backend(backend_id);
     if (!b || !old_relpath || !new_relpath) { errno = EINVAL; return -1; }
 
-    char full_old[PATH_BUFSZ];
-    char full_new[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, old_relpath, full_old, sizeof(full_old)) != 0) {
-        return -1;
-    }
-    if (join_backend_path(b->rootpath, new_relpath, full_new, sizeof(full_new)) != 0) {
+    at_path_t from, to;
+    if (resolve_at(b, old_relpath, &from) != 0) return -1;
+    if (resolve_at(b, new_relpath, &to) != 0) {
+        int err = errno;
+        dir_release(b, from.pin);
+        errno = err;
         return -1;
     }
 
-    if (rename(full_old, full_new) != 0) return -1;
-    return 0;
+    int ret = renameat(from.dfd, from.name, to.dfd, to.name);
+    int err = errno;
+    dir_release(b, from.pin);
+    dir_release(b, to.pin);
+    if (ret == 0) {
+        /* cached paths below either name now lead elsewhere */
+        dir_invalidate(b, old_relpath);
+        dir_invalidate(b, new_relpath);
+        fd_invalidate(b, old_relpath);
+        fd_invalidate(b, new_relpath);
+    }
+    errno = err;
+    return ret;
 }
 
 /* Make directory */
@@ -403,22 +1291,19 @@ int posix_mkdir(int backend_id, const char *relpath, mode_t mode) {
     posix_backend_t *b = get_backend(backend_id);
     if (!b || !relpath) { errno = EINVAL; return -1; }
 
-    char full[PATH_BUFSZ];
-    if (join_backend_path(b->rootpath, relpath, full, sizeof(full)) != 0) {
-        return -1;
-    }
-
-    if (mkdir(full, mode) != 0) return -1;
-    return 0;
+    at_path_t at;
+    if (resolve_at(b, relpath, &at) != 0) return -1;
+    int ret = mkdirat(at.dfd, at.name, mode);
+    int err = errno;
+    dir_release(b, at.pin);
+    errno = err;
+    return ret;
 }
 
 /* ========================================================================
  * VFS Backend Ops Adapters
  * ======================================================================== */
 
-#include "../core/vfs_core.h"
-#include <stdint.h>
-
 /* Adapter: init - wraps posix_backend_init */
 static int posix_ops_init(const char *root_path, void **backend_data) {
     if (!backend_data) return -EINVAL;
@@ -489,6 +1374,76 @@ static ssize_t posix_ops_write(void *backend_data, void *handle, const void *buf
     return (ret < 0) ? -errno : ret;
 }
 
+/* Adapter: readv - wraps posix_readv */
+static ssize_t posix_ops_readv(void *backend_data, void *handle, const struct iovec *iov,
+                               int iovcnt, off_t offset) {
+    if (!backend_data || !handle || !iov) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int h = (int)(intptr_t)handle;
+
+    ssize_t ret = posix_readv(backend_id, h, iov, iovcnt, offset);
+    return (ret < 0) ? -errno : ret;
+}
+
+/* Adapter: writev - wraps posix_writev */
+static ssize_t posix_ops_writev(void *backend_data, void *handle, const struct iovec *iov,
+                                int iovcnt, off_t offset) {
+    if (!backend_data || !handle || !iov) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int h = (int)(intptr_t)handle;
+
+    ssize_t ret = posix_writev(backend_id, h, iov, iovcnt, offset);
+    return (ret < 0) ? -errno : ret;
+}
+
+/* Adapter: fsync - wraps posix_fsync */
+static int posix_ops_fsync(void *backend_data, void *handle, int datasync) {
+    if (!backend_data || !handle) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int h = (int)(intptr_t)handle;
+
+    int ret = posix_fsync(backend_id, h, datasync);
+    return (ret < 0) ? -errno : 0;
+}
+
+/* Adapter: get_fd - wraps posix_fd; O_DIRECT fds need aligned transfers,
+ * which splice can't promise */
+static int posix_ops_get_fd(void *backend_data, void *handle) {
+    if (!backend_data || !handle) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int h = (int)(intptr_t)handle;
+
+    int fd = posix_fd(backend_id, h);
+    if (fd < 0) return -errno;
+    int fl = fcntl(fd, F_GETFL);
+    if (fl < 0) return -errno;
+    return (fl & O_DIRECT) ? -EOPNOTSUPP : fd;
+}
+
+/* Adapter: note_read - wraps posix_fd_read */
+static void posix_ops_note_read(void *backend_data, void *handle, off_t offset, size_t count) {
+    if (!backend_data || !handle) return;
+
+    posix_fd_read((int)(intptr_t)backend_data, (int)(intptr_t)handle, offset, count);
+}
+
+/* Adapter: copy_range - wraps posix_copy_range */
+static ssize_t posix_ops_copy_range(void *backend_data, void *handle_in, off_t off_in,
+                                    void *handle_out, off_t off_out, size_t len) {
+    if (!backend_data || !handle_in || !handle_out) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int h_in = (int)(intptr_t)handle_in;
+    int h_out = (int)(intptr_t)handle_out;
+
+    ssize_t ret = posix_copy_range(backend_id, h_in, off_in, h_out, off_out, len);
+    return (ret < 0) ? -errno : ret;
+}
+
 /* Adapter: stat - wraps posix_stat */
 static int posix_ops_stat(void *backend_data, const char *relpath, struct stat *st) {
     if (!backend_data || !relpath || !st) return -EINVAL;
@@ -498,16 +1453,46 @@ static int posix_ops_stat(void *backend_data, const char *relpath, struct stat *
     return (ret < 0) ? -errno : 0;
 }
 
-/* Adapter: readdir - wraps posix_readdir */
-static int posix_ops_readdir(void *backend_data, const char *relpath, 
-                              void *buf, void *filler) {
-    if (!backend_data || !relpath || !filler) return -EINVAL;
-    
+/* Adapter: opendir - wraps posix_opendir */
+static int posix_ops_opendir(void *backend_data, const char *relpath, void **dir) {
+    if (!backend_data || !relpath || !dir) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    posix_dir_t *d = posix_opendir(backend_id, relpath);
+    if (!d) return -errno;
+
+    *dir = d;
+    return 0;
+}
+
+/* Adapter: readdir - wraps posix_readdir_stream */
+static int posix_ops_readdir(void *backend_data, void *dir, void *buf, void *filler,
+                             off_t offset, int flags) {
+    if (!backend_data || !dir || !filler) return -EINVAL;
+
     int backend_id = (int)(intptr_t)backend_data;
     /* Cast filler to vfs_fill_dir_t (matches fuse_fill_dir_t signature) */
     vfs_fill_dir_t fill_fn = (vfs_fill_dir_t)filler;
-    
-    int ret = posix_readdir(backend_id, relpath, buf, fill_fn, 0);
+
+    int ret = posix_readdir_stream(backend_id, dir, buf, fill_fn, offset, flags);
+    return (ret < 0) ? -errno : 0;
+}
+
+/* Adapter: releasedir - wraps posix_closedir */
+static int posix_ops_releasedir(void *backend_data, void *dir) {
+    if (!backend_data || !dir) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int ret = posix_closedir(backend_id, dir);
+    return (ret < 0) ? -errno : 0;
+}
+
+/* Adapter: mkdir - wraps posix_mkdir */
+static int posix_ops_mkdir(void *backend_data, const char *relpath, mode_t mode) {
+    if (!backend_data || !relpath) return -EINVAL;
+
+    int backend_id = (int)(intptr_t)backend_data;
+    int ret = posix_mkdir(backend_id, relpath, mode);
     return (ret < 0) ? -errno : 0;
 }
 
@@ -520,8 +1505,17 @@ const vfs_backend_ops_t posix_backend_ops = {
     .close = posix_ops_close,
     .read = posix_ops_read,
     .write = posix_ops_write,
+    .readv = posix_ops_readv,
+    .writev = posix_ops_writev,
+    .fsync = posix_ops_fsync,
+    .get_fd = posix_ops_get_fd,
+    .note_read = posix_ops_note_read,
+    .copy_range = posix_ops_copy_range,
     .stat = posix_ops_stat,
+    .opendir = posix_ops_opendir,
     .readdir = posix_ops_readdir,
+    .releasedir = posix_ops_releasedir,
+    .mkdir = posix_ops_mkdir,
 };
 
 /* Getter function for backend ops */
@@ -1,14 +1,19 @@
 #ifndef BACKEND_POSIX_H
 #define BACKEND_POSIX_H
 
+#include <stdint.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 /* When building with libfuse3, this type matches fuse_fill_dir_t.
  * We include fuse3 headers in the C file, but keep the header minimal.
+ * flags is VFS_FILL_DIR_PLUS when st holds full attributes, else st has
+ * only st_ino and the file type bits of st_mode.
  */
-typedef int (*vfs_fill_dir_t)(void *buf, const char *name, const struct stat *st, off_t off);
+typedef int (*vfs_fill_dir_t)(void *buf, const char *name, const struct stat *st, off_t off,
+                              int flags);
 
 /* Initialize a posix backend for the given root path.
  * Returns backend_id >= 1 on success, or -1 on error (errno set).
@@ -19,24 +24,82 @@ int posix_backend_init(const char *rootpath);
 int posix_backend_shutdown(int backend_id);
 
 /* Open a file in the backend. Returns a backend-specific handle (>0) or -1 on error (errno set).
- * Flags and mode are POSIX-style flags and mode.
+ * Flags and mode are POSIX-style flags and mode. Opens with nothing but an
+ * access mode (and O_CLOEXEC) share an fd kept in the open fd cache.
  */
 int posix_open(int backend_id, const char *relpath, int flags, mode_t mode);
 
+/* Keep the fds of up to entries recently opened files for reuse (default
+ * 128); 0 turns the cache off. Returns 0, or -1 with errno set */
+int posix_fd_cache_set_size(int backend_id, int entries);
+
+/* Open fd cache counters since init: opens served from the cache, opens
+ * that went to the host, and identity rechecks (one fstatat each; every
+ * writable hit is one) */
+int posix_fd_cache_stats(int backend_id, uint64_t *hits, uint64_t *misses, uint64_t *checks);
+
 /* Close a handle returned by posix_open */
 int posix_close(int backend_id, int handle);
 
-/* Read/write using handle (pread/pwrite semantics) */
+/* Read/write using handle (pread/pwrite semantics). Reads are watched
+ * per open file, with interleaved streams told apart: sequential streams
+ * get fadvise(SEQUENTIAL) and a growing readahead() window, scattered
+ * reads fadvise(RANDOM) while no stream is sequential, and long read-only
+ * streams drop the pages far behind them from the page cache */
 ssize_t posix_read(int backend_id, int handle, void *buf, size_t count, off_t offset);
 ssize_t posix_write(int backend_id, int handle, const void *buf, size_t count, off_t offset);
 
+/* Largest readahead window for sequential streams (8 MiB by default);
+ * 0 turns read-pattern tracking off and leaves readahead to the kernel */
+int posix_readahead_set_window(int backend_id, size_t max_bytes);
+
+/* Read-pattern counters since init: files advised sequential and
+ * random, bytes requested with readahead(), and bytes dropped behind
+ * streams */
+int posix_readahead_stats(int backend_id, uint64_t *sequential, uint64_t *random,
+                          uint64_t *readahead_bytes, uint64_t *dropped_bytes);
+
+/* Scatter/gather read/write (preadv2/pwritev2 semantics), one syscall per call */
+ssize_t posix_readv(int backend_id, int handle, const struct iovec *iov, int iovcnt, off_t offset);
+ssize_t posix_writev(int backend_id, int handle, const struct iovec *iov, int iovcnt, off_t offset);
+
+/* fsync/fdatasync the file behind handle */
+int posix_fsync(int backend_id, int handle, int datasync);
+
+/* The fd behind handle (for splicing), or -1 with errno set */
+int posix_fd(int backend_id, int handle);
+
+/* Report a read of count bytes at offset made on posix_fd's fd rather than
+ * with posix_read, so it is watched like one. Returns 0, or -1 with errno set */
+int posix_fd_read(int backend_id, int handle, off_t offset, size_t count);
+
+/* Copy len bytes between two handles without leaving the kernel: a reflink
+ * where the host filesystem supports it, else copy_file_range. Returns the
+ * bytes copied (short at the end of the source) or -1 with errno set;
+ * EXDEV/EOPNOTSUPP/ENOSYS mean the kernel can't copy this pair */
+ssize_t posix_copy_range(int backend_id, int handle_in, off_t off_in,
+                         int handle_out, off_t off_out, size_t len);
+
 /* Stat a relative path within backend, filling struct stat */
 int posix_stat(int backend_id, const char *relpath, struct stat *st);
 
-/* Read directory entries. Uses a filler compatible with fuse_fill_dir_t semantics.
- * Returns 0 on success, -1 on error (errno set).
+/* Directory streams. posix_opendir returns NULL on error (errno set).
+ * posix_readdir_stream lists from cookie offset (0: the start) into a filler
+ * compatible with fuse_fill_dir_t semantics, passing each entry's cookie as
+ * off; a later call with that cookie resumes after the entry. A non-zero
+ * return from the filler ends the listing before that entry. Attributes
+ * beyond the inode number and type are fetched only with flags &
+ * VFS_READDIR_PLUS. Returns 0 on success, -1 on error (errno set).
  */
-int posix_readdir(int backend_id, const char *relpath, void *buf, vfs_fill_dir_t filler, off_t offset);
+typedef struct posix_dir posix_dir_t;
+posix_dir_t *posix_opendir(int backend_id, const char *relpath);
+int posix_readdir_stream(int backend_id, posix_dir_t *dir, void *buf, vfs_fill_dir_t filler,
+                         off_t offset, int flags);
+int posix_closedir(int backend_id, posix_dir_t *dir);
+
+/* One-shot listing of relpath from cookie offset, as above */
+int posix_readdir(int backend_id, const char *relpath, void *buf, vfs_fill_dir_t filler,
+                  off_t offset, int flags);
 
 
 /* Create file (like open with O_CREAT | O_EXCL). Returns handle (>0) or -1 */
@@ -0,0 +1,1408 @@
+#define _GNU_SOURCE
+#include "backend_uring.h"
+#include "../core/vfs_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+/*
+ * posix_uring backend.
+ *
+ * Same tree layout and semantics as the posix backend, but opens, reads,
+ * writes, statx and fsync go through one io_uring per mount. The ring is
+ * driven with the raw syscalls (no liburing dependency).
+ *
+ * Any thread may submit, but one at a time: a caller queues its SQE under
+ * the ring lock and, if no submit is in progress, sends everything queued
+ * so far in one io_uring_enter. Callers that arrive while that syscall
+ * runs queue behind it and go out together in the next one, so N FUSE
+ * workers hitting the same mount share submissions. Waiting is shared
+ * too: one thread sleeps in io_uring_enter for completions and hands out
+ * every CQE it finds, waking only the threads whose requests finished;
+ * the rest sleep on their own condition variables.
+ *
+ * A thread that submitted other callers' requests stays until those have
+ * completed, not just its own: io_uring cancels a task's punted work when
+ * the task exits, and FUSE retires idle worker threads.
+ *
+ * Open files are installed in a registered file table, saving the
+ * per-request fget. O_DIRECT transfers are staged through a pool of
+ * registered, page-aligned buffers so the kernel does not pin user pages
+ * for every request; buffered I/O is not, the copy would cost more than
+ * it saves. If io_uring cannot be set up, or lacks an opcode we need, the
+ * mount runs the same operations as plain syscalls.
+ *
+ * Reads and writes can also be started without waiting (the core's
+ * vfs_read_async/vfs_write_async). Those SQEs join the same queue; a
+ * completer thread, started on first use, submits them when nobody else
+ * is and runs their callbacks. While it sleeps in the kernel it keeps a
+ * read posted on an eventfd, so a new request can wake it.
+ */
+
+#define UR_ENTRIES   256              /* SQ size; also the in-flight cap */
+#define UR_FILES     1024             /* registered file slots */
+#define UR_NBUFS     64               /* registered buffers */
+#define UR_BUFSZ     (64 * 1024)      /* O_DIRECT I/O up to this size is staged */
+
+#define UR_DENTS_BUFSZ (64 * 1024)     /* getdents64 reads this much at a time */
+#define UR_STATX_WAVE  64             /* readdir-plus statx requests in flight */
+
+typedef int (*ur_fill_dir_t)(void *buf, const char *name, const struct stat *st, off_t off,
+                             int flags);
+
+/* -------------------------------------------------------------------------- */
+/* RING */
+/* -------------------------------------------------------------------------- */
+
+/* One per thread inside ring_call, or one per async request */
+typedef struct ur_waiter {
+    pthread_cond_t cond;              /* threads only */
+    int res;
+    int done;                         /* this thread's request completed */
+    unsigned mine;                    /* requests it submitted, not yet reaped */
+    struct ur_waiter *owner;          /* who submitted this thread's request */
+    struct ur_waiter *next;           /* on r->idle while sleeping, or r->completed */
+    void (*complete)(struct ur_waiter *w);  /* async: run by the completer */
+} ur_waiter_t;
+
+typedef struct ur_ring {
+    int fd;
+    unsigned entries;
+
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned sq_tail_local;
+    struct io_uring_sqe *sqes;
+
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    void *sq_map, *cq_map;
+    size_t sq_map_sz, cq_map_sz, sqes_sz;
+
+    pthread_mutex_t lock;
+    pthread_cond_t space;             /* in-flight dropped below the cap */
+    ur_waiter_t *idle;                /* sleeping callers, for role handoff */
+    unsigned unsubmitted;             /* queued in the SQ, not yet entered */
+    unsigned in_kernel;               /* submitted, not reaped */
+    unsigned inflight;                /* unsubmitted + in_kernel */
+    int submitting;                   /* a thread is in a submitting enter */
+    int reaping;                      /* a thread is waiting for completions */
+    _Atomic int broken;               /* an enter failed for good: use syscalls */
+
+    uint64_t requests;
+    uint64_t submits;               /* io_uring_enter calls that submitted */
+
+    /* Async requests */
+    int completer_started;
+    int completer_stop;
+    pthread_t completer;
+    pthread_cond_t completer_cond;
+    int completer_sleeping;           /* on completer_cond */
+    int completer_reaping;            /* in the kernel, wake it with the kick */
+    unsigned async_pending;           /* queued or in the kernel */
+    ur_waiter_t *completed, *completed_tail;  /* reaped, callback not run */
+
+    int kick_fd;                      /* eventfd */
+    uint64_t kick_buf;
+    int kick_armed;                   /* a read on kick_fd is queued or posted */
+    int kick_posted;                  /* ... and the kernel has it */
+    ur_waiter_t kick;                 /* its user_data; owned by nobody */
+} ur_ring_t;
+
+static int sys_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static _Atomic int g_fail_enter;
+
+static int sys_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    int err = atomic_exchange(&g_fail_enter, 0);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_uring_register(int fd, unsigned op, const void *arg, unsigned nr)
+{
+    return (int)syscall(__NR_io_uring_register, fd, op, arg, nr);
+}
+
+static void ring_unmap(ur_ring_t *r)
+{
+    if (r->sqes && r->sqes != MAP_FAILED)
+        munmap(r->sqes, r->sqes_sz);
+    if (r->cq_map && r->cq_map != MAP_FAILED && r->cq_map != r->sq_map)
+        munmap(r->cq_map, r->cq_map_sz);
+    if (r->sq_map && r->sq_map != MAP_FAILED)
+        munmap(r->sq_map, r->sq_map_sz);
+}
+
+static int ring_init(ur_ring_t *r)
+{
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    memset(r, 0, sizeof(*r));
+
+    r->fd = sys_uring_setup(UR_ENTRIES, &p);
+    if (r->fd < 0)
+        return -errno;
+    r->entries = p.sq_entries;
+
+    r->sq_map_sz = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_map_sz = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (r->cq_map_sz > r->sq_map_sz)
+            r->sq_map_sz = r->cq_map_sz;
+        r->cq_map_sz = r->sq_map_sz;
+    }
+
+    r->sq_map = mmap(NULL, r->sq_map_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_map == MAP_FAILED)
+        goto fail;
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        r->cq_map = r->sq_map;
+    } else {
+        r->cq_map = mmap(NULL, r->cq_map_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         r->fd, IORING_OFF_CQ_RING);
+        if (r->cq_map == MAP_FAILED)
+            goto fail;
+    }
+    r->sqes_sz = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED)
+        goto fail;
+
+    char *sq = r->sq_map, *cq = r->cq_map;
+    r->sq_head  = (unsigned *)(sq + p.sq_off.head);
+    r->sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    r->sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *)(sq + p.sq_off.array);
+    r->cq_head  = (unsigned *)(cq + p.cq_off.head);
+    r->cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    r->cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    r->cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    r->sq_tail_local = *r->sq_tail;
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->space, NULL);
+    return 0;
+
+fail:
+    ring_unmap(r);
+    close(r->fd);
+    r->fd = -1;
+    return -ENOMEM;
+}
+
+/* Every opcode the backend issues must be supported, or we fall back */
+static int ring_probe(ur_ring_t *r)
+{
+    static const int needed[] = {
+        IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE,
+        IORING_OP_READV, IORING_OP_WRITEV, IORING_OP_READ_FIXED,
+        IORING_OP_WRITE_FIXED, IORING_OP_FSYNC,
+    };
+    size_t sz = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *p = calloc(1, sz);
+    if (!p)
+        return 0;
+    int ok = sys_uring_register(r->fd, IORING_REGISTER_PROBE, p, 256) == 0;
+    for (size_t i = 0; ok && i < sizeof(needed) / sizeof(needed[0]); i++)
+        ok = needed[i] <= p->last_op && (p->ops[needed[i]].flags & IO_URING_OP_SUPPORTED);
+    free(p);
+    return ok;
+}
+
+/* In-flight requests are capped by the SQ size, which keeps both rings
+ * from overflowing (the CQ is twice as large); one slot stays free for
+ * the completer's kick */
+static int ring_full(const ur_ring_t *r)
+{
+    return r->inflight >= r->entries - 1;
+}
+
+/* Give w its result: wake the thread waiting for it, or put an async
+ * request on r->completed for the completer (returns 1). Called with
+ * r->lock held */
+static int ring_finish(ur_ring_t *r, ur_waiter_t *w, int res)
+{
+    w->res = res;
+    if (w->complete) {
+        w->next = NULL;
+        if (r->completed_tail)
+            r->completed_tail->next = w;
+        else
+            r->completed = w;
+        r->completed_tail = w;
+        r->async_pending--;
+        return 1;
+    }
+    w->done = 1;
+    pthread_cond_signal(&w->cond);
+    return 0;
+}
+
+/* Hand out every completion the kernel has posted, waking the threads
+ * that were waiting on them. Async requests go on r->completed for the
+ * completer. Called with r->lock held */
+static void ring_reap(ur_ring_t *r)
+{
+    unsigned head = *r->cq_head;
+    unsigned tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail)
+        return;
+
+    int was_full = ring_full(r);
+    int wake_completer = 0;
+    for (; head != tail; head++) {
+        struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+        ur_waiter_t *w = (ur_waiter_t *)(uintptr_t)cqe->user_data;
+        r->inflight--;
+        if (w == &r->kick) {
+            /* Fired, or cancelled because its submitter exited: re-armed
+             * by the completer when it next sleeps in the kernel */
+            r->kick_armed = 0;
+            r->kick_posted = 0;
+            continue;
+        }
+        r->in_kernel--;
+        wake_completer |= ring_finish(r, w, cqe->res);
+        if (--w->owner->mine == 0 && w->owner != w)
+            pthread_cond_signal(&w->owner->cond);
+    }
+    __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    if (was_full)
+        pthread_cond_broadcast(&r->space);
+    if (wake_completer && r->completer_sleeping)
+        pthread_cond_signal(&r->completer_cond);
+}
+
+static void ring_kick(ur_ring_t *r)
+{
+    uint64_t one = 1;
+    if (write(r->kick_fd, &one, sizeof(one)) < 0) {
+        /* the counter is saturated, so a wakeup is already pending */
+    }
+}
+
+/* If a role is vacant (queued SQEs and nobody submitting, requests in the
+ * kernel and nobody waiting for them), wake one sleeping caller to take
+ * it, or else the completer */
+static void ring_handoff(ur_ring_t *r)
+{
+    if (!(r->unsubmitted && !r->submitting) && !(r->in_kernel && !r->reaping))
+        return;
+    if (r->idle)
+        pthread_cond_signal(&r->idle->cond);
+    else if (r->completer_sleeping)
+        pthread_cond_signal(&r->completer_cond);
+    else if (r->completer_reaping)
+        ring_kick(r);
+}
+
+static ur_waiter_t *sqe_waiter(const ur_ring_t *r, unsigned pos)
+{
+    return (ur_waiter_t *)(uintptr_t)r->sqes[pos & *r->sq_mask].user_data;
+}
+
+/* io_uring_enter failed with something other than EINTR, EAGAIN or EBUSY,
+ * which only happens if the ring itself broke. A failed enter consumed
+ * no SQEs, so everything unsubmitted is taken back off the SQ and fails
+ * with -EIO; the backend uses plain syscalls from now on. Requests
+ * already in the kernel still complete and are reaped by polling the CQ
+ * (ring_wait). Called with r->lock held */
+static void ring_break(ur_ring_t *r, int err)
+{
+    if (!atomic_exchange(&r->broken, 1))
+        fprintf(stderr, "posix_uring: io_uring_enter: %s, falling back to syscalls\n",
+                strerror(err));
+
+    int was_full = ring_full(r);
+    int wake_completer = 0;
+    unsigned first = r->sq_tail_local - r->unsubmitted;
+    for (unsigned pos = first; pos != r->sq_tail_local; pos++) {
+        ur_waiter_t *w = sqe_waiter(r, pos);
+        r->inflight--;
+        if (w == &r->kick)
+            r->kick_armed = 0;
+        else
+            wake_completer |= ring_finish(r, w, -EIO);
+    }
+    r->sq_tail_local = first;
+    __atomic_store_n(r->sq_tail, first, __ATOMIC_RELEASE);
+    r->unsubmitted = 0;
+    if (was_full)
+        pthread_cond_broadcast(&r->space);
+    if (wake_completer && r->completer_sleeping)
+        pthread_cond_signal(&r->completer_cond);
+}
+
+static int ring_enter_failed(ur_ring_t *r, int err)
+{
+    if (err == EINTR || err == EAGAIN || err == EBUSY)
+        return 0;
+    ring_break(r, err);
+    return 1;
+}
+
+/* Submit everything queued; self owns it until it completes (except the
+ * kick, which is never waited for). Called with r->lock held and no other
+ * submit in progress */
+static void ring_submit(ur_ring_t *r, ur_waiter_t *self)
+{
+    unsigned n = r->unsubmitted;
+    unsigned first = r->sq_tail_local - n;
+    for (unsigned i = 0; i < n; i++) {
+        ur_waiter_t *w = sqe_waiter(r, first + i);
+        if (w != &r->kick) {
+            w->owner = self;
+            self->mine++;
+        }
+    }
+    r->unsubmitted = 0;
+    r->submitting = 1;
+    pthread_mutex_unlock(&r->lock);
+
+    int ret = sys_uring_enter(r->fd, n, 0, 0);
+    int err = ret < 0 ? errno : 0;
+
+    pthread_mutex_lock(&r->lock);
+    r->submitting = 0;
+    r->submits++;
+    if (ret < 0)
+        ret = 0;
+    /* The kernel consumes from the head; anything left goes out next time */
+    for (unsigned i = 0; i < n; i++) {
+        int kick = sqe_waiter(r, first + i) == &r->kick;
+        if (i >= (unsigned)ret) {
+            r->unsubmitted++;
+            if (!kick)
+                self->mine--;
+        } else if (kick) {
+            r->kick_posted = 1;
+        } else {
+            r->in_kernel++;
+        }
+    }
+    if (err)
+        ring_enter_failed(r, err);
+
+    /* Pick up completions posted inline, unless a reaper is asleep in the
+     * kernel: it waits for the CQ tail to pass the head it saw, and if we
+     * consumed what it was waiting for it would sleep on an idle ring */
+    if (!r->reaping)
+        ring_reap(r);
+}
+
+/* Sleep in the kernel until at least one completion, then hand them out;
+ * on a broken ring, sleep a little and look at the CQ instead. Called
+ * with r->lock held and no other thread reaping */
+static void ring_wait(ur_ring_t *r)
+{
+    r->reaping = 1;
+    pthread_mutex_unlock(&r->lock);
+    int ret = 0, err = 0;
+    if (atomic_load(&r->broken)) {
+        usleep(1000);
+    } else {
+        ret = sys_uring_enter(r->fd, 0, 1, IORING_ENTER_GETEVENTS);
+        err = ret < 0 ? errno : 0;
+    }
+    pthread_mutex_lock(&r->lock);
+    r->reaping = 0;
+    if (ret < 0)
+        ring_enter_failed(r, err);
+    ring_reap(r);
+}
+
+static void ring_sleep(ur_ring_t *r, ur_waiter_t *self)
+{
+    self->next = r->idle;
+    r->idle = self;
+    pthread_cond_wait(&self->cond, &r->lock);
+    for (ur_waiter_t **pp = &r->idle; *pp; pp = &(*pp)->next) {
+        if (*pp == self) {
+            *pp = self->next;
+            break;
+        }
+    }
+}
+
+/* Append sqe to the SQ with w as its user_data. Caller holds r->lock and
+ * has checked for space */
+static void ring_queue(ur_ring_t *r, const struct io_uring_sqe *sqe, ur_waiter_t *w)
+{
+    unsigned idx = r->sq_tail_local & *r->sq_mask;
+    r->sqes[idx] = *sqe;
+    r->sqes[idx].user_data = (uint64_t)(uintptr_t)w;
+    r->sq_array[idx] = idx;
+    r->sq_tail_local++;
+    __atomic_store_n(r->sq_tail, r->sq_tail_local, __ATOMIC_RELEASE);
+    r->unsubmitted++;
+    r->inflight++;
+}
+
+/* Queue one SQE and wait for its result (a byte count or -errno; -EIO
+ * if the ring broke first) */
+static int ring_call(ur_ring_t *r, const struct io_uring_sqe *sqe)
+{
+    ur_waiter_t self;
+    memset(&self, 0, sizeof(self));
+    pthread_cond_init(&self.cond, NULL);
+
+    pthread_mutex_lock(&r->lock);
+    while (ring_full(r) && !atomic_load(&r->broken))
+        pthread_cond_wait(&r->space, &r->lock);
+    if (atomic_load(&r->broken)) {
+        pthread_mutex_unlock(&r->lock);
+        pthread_cond_destroy(&self.cond);
+        return -EIO;
+    }
+    ring_queue(r, sqe, &self);
+    r->requests++;
+
+    for (;;) {
+        if (self.done && !self.mine)
+            break;
+        if (r->unsubmitted && !r->submitting)
+            ring_submit(r, &self);
+        else if (r->in_kernel && !r->reaping)
+            ring_wait(r);
+        else
+            ring_sleep(r, &self);
+    }
+    ring_handoff(r);
+
+    pthread_mutex_unlock(&r->lock);
+    pthread_cond_destroy(&self.cond);
+    return self.res;
+}
+
+/* ---- async requests ---- */
+
+/* Keep a read posted on the eventfd while the completer has async work,
+ * so it can sleep in the kernel and still be woken for new requests.
+ * Called with r->lock held; ring_full leaves a slot for it */
+static void ring_arm_kick(ur_ring_t *r)
+{
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = r->kick_fd;
+    sqe.addr = (uint64_t)(uintptr_t)&r->kick_buf;
+    sqe.len = sizeof(r->kick_buf);
+    ring_queue(r, &sqe, &r->kick);
+    r->kick_armed = 1;
+}
+
+/* Submits async requests nobody else is submitting, waits for them when
+ * nobody else is waiting, and runs their completions. Like any other
+ * submitter it stays until the requests it sent have completed */
+static void *ring_completer(void *arg)
+{
+    ur_ring_t *r = arg;
+    ur_waiter_t self;
+    memset(&self, 0, sizeof(self));
+    pthread_cond_init(&self.cond, NULL);
+
+    pthread_mutex_lock(&r->lock);
+    for (;;) {
+        if (r->completed) {
+            ur_waiter_t *w = r->completed;
+            r->completed = r->completed_tail = NULL;
+            pthread_mutex_unlock(&r->lock);
+            while (w) {
+                ur_waiter_t *next = w->next;
+                w->complete(w);
+                w = next;
+            }
+            pthread_mutex_lock(&r->lock);
+            continue;
+        }
+        int busy = r->async_pending || self.mine;
+        int broken = atomic_load(&r->broken);
+        if (r->completer_stop && !busy)
+            break;
+        if (busy && !r->kick_armed && !broken)
+            ring_arm_kick(r);
+        if (r->unsubmitted && !r->submitting) {
+            ring_submit(r, &self);
+        } else if (busy && !r->reaping && (r->kick_posted || broken)) {
+            /* Completions or the kick wake it; a submitter that leaves
+             * SQEs behind kicks it (ring_handoff) */
+            r->completer_reaping = 1;
+            ring_wait(r);
+            r->completer_reaping = 0;
+        } else {
+            /* It may have just left the kernel with a caller's request
+             * still there and that caller asleep, counting on it */
+            ring_handoff(r);
+            r->completer_sleeping = 1;
+            pthread_cond_wait(&r->completer_cond, &r->lock);
+            r->completer_sleeping = 0;
+        }
+    }
+    ring_handoff(r);
+    pthread_mutex_unlock(&r->lock);
+    pthread_cond_destroy(&self.cond);
+    return NULL;
+}
+
+/* Called with r->lock held */
+static int ring_start_completer(ur_ring_t *r)
+{
+    r->kick_fd = eventfd(0, EFD_CLOEXEC);
+    if (r->kick_fd < 0)
+        return -errno;
+    pthread_cond_init(&r->completer_cond, NULL);
+    int err = pthread_create(&r->completer, NULL, ring_completer, r);
+    if (err) {
+        pthread_cond_destroy(&r->completer_cond);
+        close(r->kick_fd);
+        return -err;
+    }
+    r->completer_started = 1;
+    return 0;
+}
+
+/* Queue sqe without waiting; w->complete runs on the completer once it
+ * finishes. -EAGAIN if the ring is full (the caller should fall back to a
+ * blocking call rather than wait here, it may be the completer itself),
+ * -EIO if it broke */
+static int ring_call_async(ur_ring_t *r, const struct io_uring_sqe *sqe, ur_waiter_t *w)
+{
+    pthread_mutex_lock(&r->lock);
+    if (atomic_load(&r->broken)) {
+        pthread_mutex_unlock(&r->lock);
+        return -EIO;
+    }
+    if (!r->completer_started) {
+        int ret = ring_start_completer(r);
+        if (ret < 0) {
+            pthread_mutex_unlock(&r->lock);
+            return ret;
+        }
+    }
+    if (ring_full(r)) {
+        pthread_mutex_unlock(&r->lock);
+        return -EAGAIN;
+    }
+    ring_queue(r, sqe, w);
+    r->requests++;
+    r->async_pending++;
+
+    /* Whoever is submitting will pick it up; otherwise get the completer
+     * to, wherever it is sleeping */
+    if (!r->submitting) {
+        if (r->completer_sleeping)
+            pthread_cond_signal(&r->completer_cond);
+        else if (r->completer_reaping)
+            ring_kick(r);
+    }
+    pthread_mutex_unlock(&r->lock);
+    return 0;
+}
+
+static void ring_destroy(ur_ring_t *r)
+{
+    if (r->completer_started) {
+        pthread_mutex_lock(&r->lock);
+        r->completer_stop = 1;
+        if (r->completer_sleeping)
+            pthread_cond_signal(&r->completer_cond);
+        else if (r->completer_reaping)
+            ring_kick(r);
+        pthread_mutex_unlock(&r->lock);
+        pthread_join(r->completer, NULL);
+        pthread_cond_destroy(&r->completer_cond);
+        close(r->kick_fd);
+    }
+    ring_unmap(r);
+    close(r->fd);
+    pthread_mutex_destroy(&r->lock);
+    pthread_cond_destroy(&r->space);
+}
+
+/* -------------------------------------------------------------------------- */
+/* BACKEND STATE */
+/* -------------------------------------------------------------------------- */
+
+typedef struct uring_backend {
+    int rootfd;                       /* O_PATH handle on the backing dir */
+    int uring;                        /* 0: plain syscalls */
+    ur_ring_t ring;
+
+    int fixed_files;                  /* registered file table in place */
+    pthread_mutex_t slot_lock;
+    int free_slots[UR_FILES];
+    int nfree_slots;
+
+    int fixed_bufs;                   /* registered buffer pool in place */
+    char *bufs;
+    pthread_mutex_t buf_lock;
+    int free_bufs[UR_NBUFS];
+    int nfree_bufs;
+} uring_backend_t;
+
+typedef struct uring_file {
+    int fd;
+    int slot;                         /* registered file index, or -1 */
+    int odirect;                      /* opened O_DIRECT: stage via fixed buffers */
+} uring_file_t;
+
+/* Requests go through the ring: there is one and it has not broken */
+static int ring_up(const uring_backend_t *b)
+{
+    return b->uring && !atomic_load(&b->ring.broken);
+}
+
+static _Atomic int g_force_fallback;
+
+void posix_uring_force_fallback(int on)
+{
+    atomic_store(&g_force_fallback, on);
+}
+
+void posix_uring_fail_enter(int err)
+{
+    atomic_store(&g_fail_enter, err);
+}
+
+int posix_uring_active(void *backend_data)
+{
+    uring_backend_t *b = backend_data;
+    return b && ring_up(b);
+}
+
+void posix_uring_get_stats(void *backend_data, uint64_t *requests, uint64_t *submits)
+{
+    uring_backend_t *b = backend_data;
+    uint64_t rq = 0, en = 0;
+    if (b && b->uring) {
+        pthread_mutex_lock(&b->ring.lock);
+        rq = b->ring.requests;
+        en = b->ring.submits;
+        pthread_mutex_unlock(&b->ring.lock);
+    }
+    if (requests)
+        *requests = rq;
+    if (submits)
+        *submits = en;
+}
+
+/* Paths are resolved relative to the root fd; never let one escape it
+ * by being absolute */
+static const char *rel_path(const char *relpath)
+{
+    while (*relpath == '/')
+        relpath++;
+    return *relpath ? relpath : ".";
+}
+
+static void register_files(uring_backend_t *b)
+{
+    static int sparse[UR_FILES];
+    for (int i = 0; i < UR_FILES; i++)
+        sparse[i] = -1;
+    if (sys_uring_register(b->ring.fd, IORING_REGISTER_FILES, sparse, UR_FILES) != 0)
+        return;
+    for (int i = 0; i < UR_FILES; i++)
+        b->free_slots[i] = UR_FILES - 1 - i;
+    b->nfree_slots = UR_FILES;
+    b->fixed_files = 1;
+}
+
+static void register_buffers(uring_backend_t *b)
+{
+    struct iovec iov[UR_NBUFS];
+    b->bufs = aligned_alloc(4096, (size_t)UR_NBUFS * UR_BUFSZ);
+    if (!b->bufs)
+        return;
+    for (int i = 0; i < UR_NBUFS; i++) {
+        iov[i].iov_base = b->bufs + (size_t)i * UR_BUFSZ;
+        iov[i].iov_len = UR_BUFSZ;
+        b->free_bufs[i] = i;
+    }
+    /* Pinned memory counts against RLIMIT_MEMLOCK on older kernels */
+    if (sys_uring_register(b->ring.fd, IORING_REGISTER_BUFFERS, iov, UR_NBUFS) != 0) {
+        free(b->bufs);
+        b->bufs = NULL;
+        return;
+    }
+    b->nfree_bufs = UR_NBUFS;
+    b->fixed_bufs = 1;
+}
+
+/* Install fd in a free registered slot; -1 if the table is full */
+static int slot_install(uring_backend_t *b, int fd)
+{
+    if (!b->fixed_files)
+        return -1;
+    pthread_mutex_lock(&b->slot_lock);
+    int slot = b->nfree_slots ? b->free_slots[--b->nfree_slots] : -1;
+    pthread_mutex_unlock(&b->slot_lock);
+    if (slot < 0)
+        return -1;
+
+    struct io_uring_files_update up;
+    memset(&up, 0, sizeof(up));
+    up.offset = (unsigned)slot;
+    up.fds = (uint64_t)(uintptr_t)&fd;
+    if (sys_uring_register(b->ring.fd, IORING_REGISTER_FILES_UPDATE, &up, 1) != 1) {
+        pthread_mutex_lock(&b->slot_lock);
+        b->free_slots[b->nfree_slots++] = slot;
+        pthread_mutex_unlock(&b->slot_lock);
+        return -1;
+    }
+    return slot;
+}
+
+static void slot_remove(uring_backend_t *b, int slot)
+{
+    int none = -1;
+    struct io_uring_files_update up;
+    memset(&up, 0, sizeof(up));
+    up.offset = (unsigned)slot;
+    up.fds = (uint64_t)(uintptr_t)&none;
+    sys_uring_register(b->ring.fd, IORING_REGISTER_FILES_UPDATE, &up, 1);
+
+    pthread_mutex_lock(&b->slot_lock);
+    b->free_slots[b->nfree_slots++] = slot;
+    pthread_mutex_unlock(&b->slot_lock);
+}
+
+static int buf_get(uring_backend_t *b)
+{
+    pthread_mutex_lock(&b->buf_lock);
+    int i = b->nfree_bufs ? b->free_bufs[--b->nfree_bufs] : -1;
+    pthread_mutex_unlock(&b->buf_lock);
+    return i;
+}
+
+static void buf_put(uring_backend_t *b, int i)
+{
+    pthread_mutex_lock(&b->buf_lock);
+    b->free_bufs[b->nfree_bufs++] = i;
+    pthread_mutex_unlock(&b->buf_lock);
+}
+
+static void sqe_target(struct io_uring_sqe *sqe, const uring_file_t *f)
+{
+    if (f->slot >= 0) {
+        sqe->fd = f->slot;
+        sqe->flags |= IOSQE_FIXED_FILE;
+    } else {
+        sqe->fd = f->fd;
+    }
+}
+
+static void statx_to_stat(const struct statx *sx, struct stat *st)
+{
+    memset(st, 0, sizeof(*st));
+    st->st_dev = makedev(sx->stx_dev_major, sx->stx_dev_minor);
+    st->st_ino = sx->stx_ino;
+    st->st_mode = sx->stx_mode;
+    st->st_nlink = sx->stx_nlink;
+    st->st_uid = sx->stx_uid;
+    st->st_gid = sx->stx_gid;
+    st->st_rdev = makedev(sx->stx_rdev_major, sx->stx_rdev_minor);
+    st->st_size = (off_t)sx->stx_size;
+    st->st_blksize = sx->stx_blksize;
+    st->st_blocks = (blkcnt_t)sx->stx_blocks;
+    st->st_atim.tv_sec = sx->stx_atime.tv_sec;
+    st->st_atim.tv_nsec = sx->stx_atime.tv_nsec;
+    st->st_mtim.tv_sec = sx->stx_mtime.tv_sec;
+    st->st_mtim.tv_nsec = sx->stx_mtime.tv_nsec;
+    st->st_ctim.tv_sec = sx->stx_ctime.tv_sec;
+    st->st_ctim.tv_nsec = sx->stx_ctime.tv_nsec;
+}
+
+/* -------------------------------------------------------------------------- */
+/* BACKEND OPS */
+/* -------------------------------------------------------------------------- */
+
+static int uring_init(const char *root_path, void **backend_data)
+{
+    if (!root_path || !backend_data)
+        return -EINVAL;
+
+    uring_backend_t *b = calloc(1, sizeof(*b));
+    if (!b)
+        return -ENOMEM;
+    b->rootfd = open(root_path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (b->rootfd < 0) {
+        int err = errno;
+        free(b);
+        return -err;
+    }
+    pthread_mutex_init(&b->slot_lock, NULL);
+    pthread_mutex_init(&b->buf_lock, NULL);
+
+    if (!atomic_load(&g_force_fallback) && ring_init(&b->ring) == 0) {
+        if (ring_probe(&b->ring)) {
+            b->uring = 1;
+            register_files(b);
+            register_buffers(b);
+        } else {
+            ring_destroy(&b->ring);
+        }
+    }
+
+    *backend_data = b;
+    return 0;
+}
+
+static int uring_shutdown(void *backend_data)
+{
+    uring_backend_t *b = backend_data;
+    if (!b)
+        return -EINVAL;
+    if (b->uring)
+        ring_destroy(&b->ring);     /* closing the ring drops registrations */
+    free(b->bufs);
+    close(b->rootfd);
+    pthread_mutex_destroy(&b->slot_lock);
+    pthread_mutex_destroy(&b->buf_lock);
+    free(b);
+    return 0;
+}
+
+static int uring_open(void *backend_data, const char *relpath, int flags, void **handle)
+{
+    uring_backend_t *b = backend_data;
+    if (!b || !relpath || !handle)
+        return -EINVAL;
+
+    const char *p = rel_path(relpath);
+    int fd;
+    if (ring_up(b)) {
+        struct io_uring_sqe sqe;
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_OPENAT;
+        sqe.fd = b->rootfd;
+        sqe.addr = (uint64_t)(uintptr_t)p;
+        sqe.len = 0644;
+        sqe.open_flags = (unsigned)(flags | O_CLOEXEC);
+        fd = ring_call(&b->ring, &sqe);
+    } else {
+        fd = openat(b->rootfd, p, flags | O_CLOEXEC, 0644);
+        if (fd < 0)
+            fd = -errno;
+    }
+    if (fd < 0)
+        return fd;
+
+    uring_file_t *f = malloc(sizeof(*f));
+    if (!f) {
+        close(fd);
+        return -ENOMEM;
+    }
+    f->fd = fd;
+    f->odirect = (flags & O_DIRECT) != 0;
+    f->slot = ring_up(b) ? slot_install(b, fd) : -1;
+    *handle = f;
+    return 0;
+}
+
+static int uring_close(void *backend_data, void *handle)
+{
+    uring_backend_t *b = backend_data;
+    uring_file_t *f = handle;
+    if (!b || !f)
+        return -EINVAL;
+    if (f->slot >= 0)
+        slot_remove(b, f->slot);
+    int ret = close(f->fd) == 0 ? 0 : -errno;
+    free(f);
+    return ret;
+}
+
+/* Fill sqe for a read or write; returns the registered buffer the data
+ * is staged through, or -1 */
+static int rw_prep(uring_backend_t *b, uring_file_t *f, int is_write, void *buf,
+                   size_t count, off_t offset, struct io_uring_sqe *sqe)
+{
+    if (count > UINT32_MAX)
+        count = UINT32_MAX;
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe_target(sqe, f);
+    sqe->off = (uint64_t)offset;
+    sqe->len = (unsigned)count;
+
+    /* Direct I/O up to a buffer's size is staged through a registered buffer */
+    int bi = (b->fixed_bufs && f->odirect && count <= UR_BUFSZ) ? buf_get(b) : -1;
+    if (bi >= 0) {
+        char *staged = b->bufs + (size_t)bi * UR_BUFSZ;
+        if (is_write)
+            memcpy(staged, buf, count);
+        sqe->opcode = is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->addr = (uint64_t)(uintptr_t)staged;
+        sqe->buf_index = (uint16_t)bi;
+    } else {
+        sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->addr = (uint64_t)(uintptr_t)buf;
+    }
+    return bi;
+}
+
+/* Copy a staged read back to the caller and release the buffer */
+static void rw_unstage(uring_backend_t *b, int bi, void *dst, int res)
+{
+    if (dst && res > 0)
+        memcpy(dst, b->bufs + (size_t)bi * UR_BUFSZ, (size_t)res);
+    buf_put(b, bi);
+}
+
+static ssize_t uring_rw(uring_backend_t *b, uring_file_t *f, int is_write,
+                        void *buf, size_t count, off_t offset)
+{
+    if (!ring_up(b)) {
+        ssize_t n = is_write ? pwrite(f->fd, buf, count, offset)
+                             : pread(f->fd, buf, count, offset);
+        return n < 0 ? -errno : n;
+    }
+
+    struct io_uring_sqe sqe;
+    int bi = rw_prep(b, f, is_write, buf, count, offset, &sqe);
+    int res = ring_call(&b->ring, &sqe);
+    if (bi >= 0)
+        rw_unstage(b, bi, is_write ? NULL : buf, res);
+    return res;
+}
+
+static ssize_t uring_read(void *backend_data, void *handle, void *buf,
+                          size_t count, off_t offset)
+{
+    if (!backend_data || !handle || !buf)
+        return -EINVAL;
+    return uring_rw(backend_data, handle, 0, buf, count, offset);
+}
+
+static ssize_t uring_write(void *backend_data, void *handle, const void *buf,
+                           size_t count, off_t offset)
+{
+    if (!backend_data || !handle || !buf)
+        return -EINVAL;
+    return uring_rw(backend_data, handle, 1, (void *)buf, count, offset);
+}
+
+typedef struct uring_async {
+    ur_waiter_t w;                    /* first: CQEs carry &w */
+    uring_backend_t *b;
+    int bi;                           /* staging buffer, or -1 */
+    void *dst;                        /* staged read: the caller's buffer */
+    vfs_async_done_t done;
+    void *arg;
+} uring_async_t;
+
+/* Runs on the ring's completer thread */
+static void uring_async_complete(ur_waiter_t *w)
+{
+    uring_async_t *a = (uring_async_t *)w;
+    if (a->bi >= 0)
+        rw_unstage(a->b, a->bi, a->dst, w->res);
+    a->done(a->arg, w->res);
+    free(a);
+}
+
+static int uring_rw_async(uring_backend_t *b, uring_file_t *f, int is_write, void *buf,
+                          size_t count, off_t offset, vfs_async_done_t done, void *arg)
+{
+    /* The fallback has no way to wait without a thread; the core's pool is one */
+    if (!ring_up(b))
+        return -EOPNOTSUPP;
+
+    uring_async_t *a = calloc(1, sizeof(*a));
+    if (!a)
+        return -ENOMEM;
+    struct io_uring_sqe sqe;
+    a->w.complete = uring_async_complete;
+    a->b = b;
+    a->bi = rw_prep(b, f, is_write, buf, count, offset, &sqe);
+    a->dst = is_write ? NULL : buf;
+    a->done = done;
+    a->arg = arg;
+
+    int ret = ring_call_async(&b->ring, &sqe, &a->w);
+    if (ret < 0) {
+        if (a->bi >= 0)
+            buf_put(b, a->bi);
+        free(a);
+    }
+    return ret;
+}
+
+static int uring_read_async(void *backend_data, void *handle, void *buf, size_t count,
+                            off_t offset, vfs_async_done_t done, void *arg)
+{
+    if (!backend_data || !handle || !buf || !done)
+        return -EINVAL;
+    return uring_rw_async(backend_data, handle, 0, buf, count, offset, done, arg);
+}
+
+static int uring_write_async(void *backend_data, void *handle, const void *buf, size_t count,
+                             off_t offset, vfs_async_done_t done, void *arg)
+{
+    if (!backend_data || !handle || !buf || !done)
+        return -EINVAL;
+    return uring_rw_async(backend_data, handle, 1, (void *)buf, count, offset, done, arg);
+}
+
+static ssize_t uring_rwv(uring_backend_t *b, uring_file_t *f, int is_write,
+                         const struct iovec *iov, int iovcnt, off_t offset)
+{
+    if (!ring_up(b)) {
+        ssize_t n = is_write ? pwritev(f->fd, iov, iovcnt, offset)
+                             : preadv(f->fd, iov, iovcnt, offset);
+        return n < 0 ? -errno : n;
+    }
+
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe_target(&sqe, f);
+    sqe.addr = (uint64_t)(uintptr_t)iov;
+    sqe.len = (unsigned)iovcnt;
+    sqe.off = (uint64_t)offset;
+    return ring_call(&b->ring, &sqe);
+}
+
+static ssize_t uring_readv(void *backend_data, void *handle, const struct iovec *iov,
+                           int iovcnt, off_t offset)
+{
+    if (!backend_data || !handle || !iov)
+        return -EINVAL;
+    return uring_rwv(backend_data, handle, 0, iov, iovcnt, offset);
+}
+
+static ssize_t uring_writev(void *backend_data, void *handle, const struct iovec *iov,
+                            int iovcnt, off_t offset)
+{
+    if (!backend_data || !handle || !iov)
+        return -EINVAL;
+    return uring_rwv(backend_data, handle, 1, iov, iovcnt, offset);
+}
+
+static int uring_fsync(void *backend_data, void *handle, int datasync)
+{
+    uring_backend_t *b = backend_data;
+    uring_file_t *f = handle;
+    if (!b || !f)
+        return -EINVAL;
+
+    if (!ring_up(b)) {
+        int ret = datasync ? fdatasync(f->fd) : fsync(f->fd);
+        return ret < 0 ? -errno : 0;
+    }
+
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_FSYNC;
+    sqe_target(&sqe, f);
+    sqe.fsync_flags = datasync ? IORING_FSYNC_DATASYNC : 0;
+    return ring_call(&b->ring, &sqe);
+}
+
+/* Staged O_DIRECT handles need aligned transfers, which splice can't promise */
+static int uring_get_fd(void *backend_data, void *handle)
+{
+    uring_file_t *f = handle;
+    if (!backend_data || !f)
+        return -EINVAL;
+    return f->odirect ? -EOPNOTSUPP : f->fd;
+}
+
+static int uring_stat(void *backend_data, const char *relpath, struct stat *st)
+{
+    uring_backend_t *b = backend_data;
+    if (!b || !relpath || !st)
+        return -EINVAL;
+
+    const char *p = rel_path(relpath);
+    if (!ring_up(b))
+        return fstatat(b->rootfd, p, st, 0) == 0 ? 0 : -errno;
+
+    struct statx sx;
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_STATX;
+    sqe.fd = b->rootfd;
+    sqe.addr = (uint64_t)(uintptr_t)p;
+    sqe.len = STATX_BASIC_STATS;
+    sqe.off = (uint64_t)(uintptr_t)&sx;      /* addr2: the statx buffer */
+    int ret = ring_call(&b->ring, &sqe);
+    if (ret < 0)
+        return ret;
+    statx_to_stat(&sx, st);
+    return 0;
+}
+
+/* ---- readdir ---- */
+
+/* Attributes for a wave of directory entries, fetched by statx requests
+ * that are all in flight at once */
+typedef struct ur_statx_wave {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int pending;
+} ur_statx_wave_t;
+
+typedef struct ur_statx_req {
+    ur_waiter_t w;                    /* first: CQEs carry &w */
+    ur_statx_wave_t *wave;
+    struct statx sx;
+} ur_statx_req_t;
+
+/* Runs on the ring's completer thread */
+static void statx_wave_complete(ur_waiter_t *w)
+{
+    ur_statx_wave_t *wave = ((ur_statx_req_t *)w)->wave;
+    pthread_mutex_lock(&wave->lock);
+    if (--wave->pending == 0)
+        pthread_cond_signal(&wave->cond);
+    pthread_mutex_unlock(&wave->lock);
+}
+
+/* stat names[0..n) relative to dfd into st[], ok[i] set where it worked */
+static void statx_wave(uring_backend_t *b, int dfd, struct dirent64 **des, int n,
+                       struct stat *st, int *ok)
+{
+    ur_statx_req_t reqs[UR_STATX_WAVE];
+    ur_statx_wave_t wave = { .pending = 1 };
+    pthread_mutex_init(&wave.lock, NULL);
+    pthread_cond_init(&wave.cond, NULL);
+
+    int queued[UR_STATX_WAVE] = { 0 };
+    for (int i = 0; ring_up(b) && i < n; i++) {
+        struct io_uring_sqe sqe;
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_STATX;
+        sqe.fd = dfd;
+        sqe.addr = (uint64_t)(uintptr_t)des[i]->d_name;
+        sqe.len = STATX_BASIC_STATS;
+        sqe.statx_flags = AT_SYMLINK_NOFOLLOW;  /* like d_type: the link itself */
+        sqe.off = (uint64_t)(uintptr_t)&reqs[i].sx;
+        memset(&reqs[i].w, 0, sizeof(reqs[i].w));
+        reqs[i].w.complete = statx_wave_complete;
+        reqs[i].wave = &wave;
+        pthread_mutex_lock(&wave.lock);
+        wave.pending++;
+        pthread_mutex_unlock(&wave.lock);
+        if (ring_call_async(&b->ring, &sqe, &reqs[i].w) == 0) {
+            queued[i] = 1;
+        } else {
+            pthread_mutex_lock(&wave.lock);
+            wave.pending--;
+            pthread_mutex_unlock(&wave.lock);
+        }
+    }
+    pthread_mutex_lock(&wave.lock);
+    wave.pending--;
+    while (wave.pending > 0)
+        pthread_cond_wait(&wave.cond, &wave.lock);
+    pthread_mutex_unlock(&wave.lock);
+
+    for (int i = 0; i < n; i++) {
+        if (queued[i]) {
+            ok[i] = reqs[i].w.res == 0;
+            if (ok[i])
+                statx_to_stat(&reqs[i].sx, &st[i]);
+        } else {
+            /* no ring, or it was full */
+            ok[i] = fstatat(dfd, des[i]->d_name, &st[i], AT_SYMLINK_NOFOLLOW) == 0;
+        }
+    }
+    pthread_cond_destroy(&wave.cond);
+    pthread_mutex_destroy(&wave.lock);
+}
+
+/*
+ * An open directory, its getdents64 buffer and, for readdir-plus, the
+ * attributes of the wave of entries starting at pos. Cookies are d_off
+ * values; a listing that goes on from the last one's cookie continues in
+ * the buffer, and in the wave, so a caller whose buffer fills mid-wave
+ * doesn't have the rest of it fetched again.
+ */
+typedef struct uring_dir {
+    int fd;
+    pthread_mutex_t lock;
+    char *dents;
+    size_t len, pos;                  /* bytes in dents, next entry */
+    off_t cookie;                     /* position of the entry at pos */
+    int wave_n, wave_i;               /* entries in the wave, next one */
+    struct stat st[UR_STATX_WAVE];
+    int ok[UR_STATX_WAVE];
+} uring_dir_t;
+
+static int uring_opendir(void *backend_data, const char *relpath, void **dir)
+{
+    uring_backend_t *b = backend_data;
+    if (!b || !relpath || !dir)
+        return -EINVAL;
+
+    int fd = openat(b->rootfd, rel_path(relpath), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return -errno;
+    uring_dir_t *d = calloc(1, sizeof(*d));
+    if (d)
+        d->dents = malloc(UR_DENTS_BUFSZ);
+    if (!d || !d->dents) {
+        free(d);
+        close(fd);
+        return -ENOMEM;
+    }
+    d->fd = fd;
+    pthread_mutex_init(&d->lock, NULL);
+    *dir = d;
+    return 0;
+}
+
+/* Attributes for the entries from d->pos on, up to a wave or the buffer's end */
+static void dir_fetch_wave(uring_backend_t *b, uring_dir_t *d)
+{
+    struct dirent64 *des[UR_STATX_WAVE];
+    int n = 0;
+    for (size_t pos = d->pos; pos < d->len && n < UR_STATX_WAVE; n++) {
+        des[n] = (struct dirent64 *)(d->dents + pos);
+        pos += des[n]->d_reclen;
+    }
+    memset(d->ok, 0, sizeof(d->ok));
+    statx_wave(b, d->fd, des, n, d->st, d->ok);
+    d->wave_n = n;
+    d->wave_i = 0;
+}
+
+/* Entries are read in bulk and typed from d_type; full attributes are
+ * fetched only for VFS_READDIR_PLUS, a wave of statx requests at a time */
+static int uring_readdir(void *backend_data, void *dir, void *buf, void *filler,
+                         off_t offset, int flags)
+{
+    uring_backend_t *b = backend_data;
+    uring_dir_t *d = dir;
+    if (!b || !d || !filler || offset < 0)
+        return -EINVAL;
+
+    ur_fill_dir_t fill = (ur_fill_dir_t)filler;
+    int plus = flags & VFS_READDIR_PLUS;
+    int ret = 0;
+    pthread_mutex_lock(&d->lock);
+    if (offset != d->cookie) {
+        if (lseek(d->fd, offset, SEEK_SET) < 0) {
+            ret = -errno;
+            pthread_mutex_unlock(&d->lock);
+            return ret;
+        }
+        d->len = d->pos = 0;
+        d->cookie = offset;
+        d->wave_n = d->wave_i = 0;
+    }
+    if (!plus)
+        d->wave_n = d->wave_i = 0;
+
+    for (;;) {
+        if (d->pos == d->len) {
+            ssize_t n = getdents64(d->fd, d->dents, UR_DENTS_BUFSZ);
+            if (n < 0)
+                ret = -errno;
+            d->len = n > 0 ? (size_t)n : 0;
+            d->pos = 0;
+            d->wave_n = d->wave_i = 0;
+            if (n <= 0)
+                break;
+        }
+        if (plus && d->wave_i == d->wave_n)
+            dir_fetch_wave(b, d);
+
+        struct dirent64 *de = (struct dirent64 *)(d->dents + d->pos);
+        struct stat st;
+        int ok = plus && d->ok[d->wave_i];
+        if (ok) {
+            st = d->st[d->wave_i];
+        } else {
+            memset(&st, 0, sizeof(st));
+            st.st_ino = de->d_ino;
+            st.st_mode = DTTOIF(de->d_type);
+            if (de->d_type == DT_UNKNOWN &&
+                fstatat(d->fd, de->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                st.st_mode = 0;
+        }
+        /* non-zero: the caller's buffer is full; this entry comes first next time */
+        if (fill(buf, de->d_name, &st, de->d_off, ok ? VFS_FILL_DIR_PLUS : 0) != 0)
+            break;
+        d->pos += de->d_reclen;
+        d->cookie = de->d_off;
+        if (plus)
+            d->wave_i++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ret;
+}
+
+static int uring_releasedir(void *backend_data, void *dir)
+{
+    uring_dir_t *d = dir;
+    if (!backend_data || !d)
+        return -EINVAL;
+    int ret = close(d->fd) == 0 ? 0 : -errno;
+    pthread_mutex_destroy(&d->lock);
+    free(d->dents);
+    free(d);
+    return ret;
+}
+
+/* mkdir is not on the data path and stays synchronous */
+static int uring_mkdir(void *backend_data, const char *relpath, mode_t mode)
+{
+    uring_backend_t *b = backend_data;
+    if (!b || !relpath)
+        return -EINVAL;
+    return mkdirat(b->rootfd, rel_path(relpath), mode) == 0 ? 0 : -errno;
+}
+
+static const vfs_backend_ops_t posix_uring_backend_ops = {
+    .name     = "posix_uring",
+    .init     = uring_init,
+    .shutdown = uring_shutdown,
+    .open     = uring_open,
+    .close    = uring_close,
+    .read     = uring_read,
+    .write    = uring_write,
+    .readv    = uring_readv,
+    .writev   = uring_writev,
+    .fsync    = uring_fsync,
+    .read_async  = uring_read_async,
+    .write_async = uring_write_async,
+    .get_fd   = uring_get_fd,
+    .stat     = uring_stat,
+    .opendir  = uring_opendir,
+    .readdir  = uring_readdir,
+    .releasedir = uring_releasedir,
+    .mkdir    = uring_mkdir,
+};
+
+const vfs_backend_ops_t *get_posix_uring_backend_ops(void)
+{
+    return &posix_uring_backend_ops;
+}
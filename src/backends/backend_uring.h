@@ -0,0 +1,31 @@
+#ifndef BACKEND_URING_H
+#define BACKEND_URING_H
+
+#include <stdint.h>
+
+struct vfs_backend_ops;
+
+/* "posix_uring": the posix backend with opens, reads, writes, statx and
+ * fsync submitted through io_uring. Requests from all threads using a
+ * mount share one ring and are batched into as few io_uring_enter calls
+ * as possible. Without io_uring (old kernel, seccomp, sysctl) the backend
+ * runs the same operations as plain syscalls, and so it does after an
+ * io_uring_enter error that means the ring itself is broken.
+ */
+const struct vfs_backend_ops *get_posix_uring_backend_ops(void);
+
+/* Make mounts created from now on skip io_uring (tests and benchmarks) */
+void posix_uring_force_fallback(int on);
+
+/* Make the next io_uring_enter on any ring fail with err (tests) */
+void posix_uring_fail_enter(int err);
+
+/* 1 if the mount behind backend_data submits through io_uring, 0 if it
+ * fell back to plain syscalls, at mount time or since its ring broke */
+int posix_uring_active(void *backend_data);
+
+/* Requests submitted on this mount, and the io_uring_enter calls that
+ * submitted them; the ratio is the average batch size */
+void posix_uring_get_stats(void *backend_data, uint64_t *requests, uint64_t *submits);
+
+#endif /* BACKEND_URING_H */
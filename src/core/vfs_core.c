@@ -6,22 +6,41 @@
  * - path resolution
  */
 
+#define _GNU_SOURCE
 #include "vfs_core.h"
+#include "vfs_rcu.h"
+#include "vfs_slab.h"
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <time.h>
 
 /* -------------------------------------------------------------------------- */
 /* GLOBAL STATE */
 /* -------------------------------------------------------------------------- */
 static pthread_mutex_t g_vfs_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Signalled under g_vfs_lock when a mount's last pin goes while an unmount
+ * waits for pins to drain; g_mount_drains counts the waiters */
+static pthread_cond_t g_mount_drained = PTHREAD_COND_INITIALIZER;
+static _Atomic int g_mount_drains;
 
 vfs_mount_entry_t *mount_table_head = NULL;
-static uint64_t g_next_ino = 1000;
 static int g_vfs_inited = 0;
 
+/* How long a failed backend lookup is remembered (0 disables) */
+#define VFS_DEFAULT_NEG_TTL_MS 1000
+static _Atomic uint64_t g_neg_ttl_ns = VFS_DEFAULT_NEG_TTL_MS * 1000000ULL;
+
+static uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 /* -------------------------------------------------------------------------- */
 /* BACKEND REGISTRY */
 /* -------------------------------------------------------------------------- */
@@ -81,164 +100,474 @@ static const vfs_backend_ops_t *vfs_find_backend(const char *name) {
 }
 
 /* -------------------------------------------------------------------------- */
-/* File handle table (simple)                                                  */
+/* File handle table                                                           */
 /* -------------------------------------------------------------------------- */
-#define VFS_MAX_FH 1024
+/*
+ * Entries live in fixed-size segments that are allocated on demand and
+ * never freed, so a slot address stays valid for the life of the process.
+ * Free slots form a lock-free stack (the head carries an ABA tag); alloc
+ * and free are O(1) and only growing the table takes a mutex.
+ *
+ * A handle is (generation << FH_IDX_BITS) | slot. The entry's tag holds the
+ * live handle value, so fh_get() spots a stale or reused handle with one
+ * atomic load, and close is a compare-and-swap of the tag to 0. Slots are
+ * recycled LIFO; a handle kept past 2047 reuses of its slot may alias.
+ * As with close(2), closing a handle while another thread is still using
+ * it is a caller bug.
+ */
+#define FH_SEG_SHIFT   10
+#define FH_SEG_SIZE    (1u << FH_SEG_SHIFT)
+#define FH_MAX_SEGS    1024
+#define FH_IDX_BITS    20                       /* FH_SEG_SIZE * FH_MAX_SEGS slots */
+#define FH_IDX_MASK    ((1u << FH_IDX_BITS) - 1)
+#define FH_GEN_MASK    ((1u << (31 - FH_IDX_BITS)) - 1)
+#define FH_NONE        UINT32_MAX               /* end of the free list */
+
 typedef struct vfs_fh_entry {
-    int in_use;
+    _Atomic int tag;                /* live handle value, 0 when free */
+    uint32_t gen;                   /* generation of the next handle */
+    _Atomic uint32_t next_free;     /* free-list link */
     vfs_dentry_t *dentry;
     int flags;
+    int access;                     /* R_OK/W_OK granted at open */
     off_t pos;
-    pthread_mutex_t lock;
+    /* Bound at open so the data path never consults the mount table. The
+     * handle stays valid while the dentry pin keeps the inode alive, even
+     * if the inode has since moved on to a wider one. */
+    vfs_mount_entry_t *mount;
+    void *backend_handle;           /* NULL: in-memory file */
+    int own_handle;                 /* backend_handle is ours alone, closed with us */
+    struct vfs_dir_stream *dir;     /* set for vfs_opendir handles */
 } vfs_fh_entry_t;
 
-static vfs_fh_entry_t g_fh_table[VFS_MAX_FH];
+static struct {
+    _Atomic(vfs_fh_entry_t *) segs[FH_MAX_SEGS];
+    _Atomic uint64_t free_head;     /* ABA tag << 32 | slot (FH_NONE: empty) */
+    unsigned int nsegs;             /* under grow_lock */
+    pthread_mutex_t grow_lock;
+} g_fh = {
+    .free_head = FH_NONE,
+    .grow_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static vfs_fh_entry_t *fh_entry(uint32_t idx)
+{
+    vfs_fh_entry_t *seg = atomic_load_explicit(&g_fh.segs[idx >> FH_SEG_SHIFT],
+                                               memory_order_acquire);
+    return seg ? &seg[idx & (FH_SEG_SIZE - 1)] : NULL;
+}
+
+/* Push the chain first..last (already linked through next_free) */
+static void fh_push(uint32_t first, vfs_fh_entry_t *last)
+{
+    uint64_t head = atomic_load_explicit(&g_fh.free_head, memory_order_relaxed);
+    uint64_t next;
+    do {
+        atomic_store_explicit(&last->next_free, (uint32_t)head, memory_order_relaxed);
+        next = ((head >> 32) + 1) << 32 | first;
+    } while (!atomic_compare_exchange_weak_explicit(&g_fh.free_head, &head, next,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
 
-static void fh_table_init_once(void)
+/* Pop a free slot; FH_NONE when the list is empty */
+static uint32_t fh_pop(void)
 {
-    static int inited = 0;
-    if (inited) return;
-    for (int i = 0; i < VFS_MAX_FH; i++) {
-        g_fh_table[i].in_use = 0;
-        g_fh_table[i].dentry = NULL;
-        g_fh_table[i].flags = 0;
-        g_fh_table[i].pos = 0;
-        pthread_mutex_init(&g_fh_table[i].lock, NULL);
+    uint64_t head = atomic_load_explicit(&g_fh.free_head, memory_order_acquire);
+    for (;;) {
+        uint32_t idx = (uint32_t)head;
+        if (idx == FH_NONE)
+            return FH_NONE;
+        /* Slots are never freed, so reading a stale link is harmless: the
+         * tag makes the exchange fail if the head moved meanwhile. */
+        uint32_t nxt = atomic_load_explicit(&fh_entry(idx)->next_free, memory_order_relaxed);
+        uint64_t next = ((head >> 32) + 1) << 32 | nxt;
+        if (atomic_compare_exchange_weak_explicit(&g_fh.free_head, &head, next,
+                                                  memory_order_acquire,
+                                                  memory_order_acquire))
+            return idx;
     }
-    inited = 1;
 }
 
-static int fh_alloc(vfs_dentry_t *d, int flags)
+/* Add a segment of free slots. Returns 0, or -EMFILE at the size limit. */
+static int fh_grow(void)
 {
-    fh_table_init_once();
-    for (int i = 0; i < VFS_MAX_FH; i++) {
-        if (!g_fh_table[i].in_use) {
-            pthread_mutex_lock(&g_fh_table[i].lock);
-            if (!g_fh_table[i].in_use) {
-                g_fh_table[i].in_use = 1;
-                g_fh_table[i].dentry = d;
-                g_fh_table[i].flags = flags;
-                g_fh_table[i].pos = 0;
-                pthread_mutex_unlock(&g_fh_table[i].lock);
-                return i + 1; /* handle id */
-            }
-            pthread_mutex_unlock(&g_fh_table[i].lock);
-        }
+    int ret = 0;
+    pthread_mutex_lock(&g_fh.grow_lock);
+    if ((uint32_t)atomic_load(&g_fh.free_head) != FH_NONE)
+        goto out;                   /* somebody freed or grew meanwhile */
+    if (g_fh.nsegs == FH_MAX_SEGS) {
+        ret = -EMFILE;
+        goto out;
     }
-    return -EMFILE;
+    vfs_fh_entry_t *seg = calloc(FH_SEG_SIZE, sizeof(*seg));
+    if (!seg) {
+        ret = -ENOMEM;
+        goto out;
+    }
+    uint32_t base = g_fh.nsegs << FH_SEG_SHIFT;
+    for (uint32_t i = 0; i < FH_SEG_SIZE; i++) {
+        seg[i].gen = 1;
+        atomic_init(&seg[i].next_free, base + i + 1);
+    }
+    atomic_store_explicit(&g_fh.segs[g_fh.nsegs], seg, memory_order_release);
+    g_fh.nsegs++;
+    fh_push(base, &seg[FH_SEG_SIZE - 1]);
+out:
+    pthread_mutex_unlock(&g_fh.grow_lock);
+    return ret;
+}
+
+/* Access an open with these flags grants; checked against the inode once,
+ * at open, and afterwards only against the handle */
+static int open_access(int flags)
+{
+    switch (flags & O_ACCMODE) {
+    case O_WRONLY: return W_OK;
+    case O_RDWR:   return R_OK | W_OK;
+    default:       return R_OK;
+    }
+}
+
+static int fh_alloc(vfs_dentry_t *d, int flags, vfs_mount_entry_t *m, void *handle,
+                    int own_handle)
+{
+    uint32_t idx;
+    while ((idx = fh_pop()) == FH_NONE) {
+        int r = fh_grow();
+        if (r < 0)
+            return r;
+    }
+
+    vfs_fh_entry_t *e = fh_entry(idx);
+    e->dentry = d;
+    e->flags = flags;
+    e->access = open_access(flags);
+    e->pos = 0;
+    e->mount = m;
+    e->backend_handle = handle;
+    e->own_handle = own_handle;
+    e->dir = NULL;
+    atomic_fetch_add(&m->open_handles, 1);
+
+    int fh = (int)((e->gen << FH_IDX_BITS) | idx);
+    atomic_store_explicit(&e->tag, fh, memory_order_release);
+    return fh;
 }
 
 static vfs_fh_entry_t *fh_get(int fh)
 {
-    if (fh <= 0) return NULL;
-    int idx = fh - 1;
-    if (idx < 0 || idx >= VFS_MAX_FH) return NULL;
-    if (!g_fh_table[idx].in_use) return NULL;
-    return &g_fh_table[idx];
+    if (fh <= 0)
+        return NULL;
+    vfs_fh_entry_t *e = fh_entry((uint32_t)fh & FH_IDX_MASK);
+    if (!e || atomic_load_explicit(&e->tag, memory_order_acquire) != fh)
+        return NULL;
+    return e;
 }
 
-static void fh_free(int fh)
+static void dir_stream_free(vfs_mount_entry_t *m, struct vfs_dir_stream *s);
+
+/* Returns 0, or -EBADF if fh is not (or no longer) open */
+static int fh_free(int fh)
 {
     vfs_fh_entry_t *e = fh_get(fh);
-    if (!e) return;
-    pthread_mutex_lock(&e->lock);
+    if (!e)
+        return -EBADF;
+    int expected = fh;
+    if (!atomic_compare_exchange_strong(&e->tag, &expected, 0))
+        return -EBADF;              /* lost a race with another close */
+
     vfs_dentry_t *d = e->dentry;
-    e->in_use = 0;
+    vfs_mount_entry_t *m = e->mount;
+    struct vfs_dir_stream *dir = e->dir;
+    void *own = e->own_handle ? e->backend_handle : NULL;
     e->dentry = NULL;
-    e->flags = 0;
-    e->pos = 0;
-    pthread_mutex_unlock(&e->lock);
-    
+    e->mount = NULL;
+    e->backend_handle = NULL;
+    e->own_handle = 0;
+    e->dir = NULL;
+    e->gen = (e->gen + 1) & FH_GEN_MASK;
+    if (!e->gen)
+        e->gen = 1;
+    fh_push((uint32_t)fh & FH_IDX_MASK, e);
+
+    /* the stream goes back to the backend before the mount may go away */
+    if (dir)
+        dir_stream_free(m, dir);
+    if (own && m->backend_ops->close)
+        m->backend_ops->close(m->backend_data, own);
     /* Release dentry reference held by file handle */
-    if (d) {
+    if (d)
         vfs_dentry_release(d);
+    /* last: once the count drops, an unmount may tear m down */
+    if (m)
+        atomic_fetch_sub_explicit(&m->open_handles, 1, memory_order_release);
+    return 0;
+}
+
+/* Close every handle still open (shutdown) */
+static void fh_close_all(void)
+{
+    for (unsigned int s = 0; s < FH_MAX_SEGS; s++) {
+        vfs_fh_entry_t *seg = atomic_load(&g_fh.segs[s]);
+        if (!seg)
+            break;
+        for (uint32_t i = 0; i < FH_SEG_SIZE; i++) {
+            int fh = atomic_load(&seg[i].tag);
+            if (fh)
+                fh_free(fh);
+        }
     }
 }
 
+
 /* -------------------------------------------------------------------------- */
 /* PATH NORMALIZATION */
 /* -------------------------------------------------------------------------- */
 
-static char *normalize_path_alloc(const char *path)
+/*
+ * Normalize an absolute path into a caller-provided buffer: collapses
+ * repeated slashes, drops "." and resolves ".." lexically (never above "/").
+ * Works in a single pass over the input with no heap allocation.
+ */
+int vfs_path_normalize(const char *path, char *out, size_t out_size)
 {
-    if (!path || path[0] != '/')
-        return NULL;
-
-    char *buf = strdup(path);
-    if (!buf)
-        return NULL;
-
-    size_t len = strlen(buf);
-    char **stack = calloc(len + 1, sizeof(char *));
-    if (!stack) {
-        free(buf);
-        return NULL;
-    }
+    if (!path || path[0] != '/' || !out || out_size < 2)
+        return -EINVAL;
 
-    size_t top = 0;
-    char *p = buf;
+    size_t o = 0;
+    out[o++] = '/';
 
-    while (*p) {
+    const char *p = path;
+    for (;;) {
         while (*p == '/')
             p++;
         if (!*p)
             break;
 
-        char *seg = p;
-
+        const char *seg = p;
         while (*p && *p != '/')
             p++;
+        size_t len = (size_t)(p - seg);
 
-        char saved = *p;
-        *p = '\0';
+        if (len == 1 && seg[0] == '.')
+            continue;
 
-        if (strcmp(seg, ".") == 0) {
-            /* skip */
-        } else if (strcmp(seg, "..") == 0) {
-            if (top > 0) top--;
-        } else {
-            stack[top++] = seg;
+        if (len == 2 && seg[0] == '.' && seg[1] == '.') {
+            /* pop the last component */
+            while (o > 1 && out[o - 1] != '/')
+                o--;
+            if (o > 1)
+                o--;
+            continue;
         }
 
-        *p = saved;
+        size_t need = (o > 1 ? 1 : 0) + len;
+        if (o + need + 1 > out_size)
+            return -ENAMETOOLONG;
+        if (o > 1)
+            out[o++] = '/';
+        memcpy(out + o, seg, len);
+        o += len;
     }
 
-    /* If root */
-    if (top == 0) {
-        free(stack);
-        free(buf);
-        return strdup("/");
-    }
+    out[o] = '\0';
+    return (int)o;
+}
 
-    /* Build output string */
-    size_t out_len = 1; /* leading '/' */
-    for (size_t i = 0; i < top; i++)
-        out_len += strlen(stack[i]) + 1;
+void vfs_path_iter_init(vfs_path_iter_t *it, const char *path)
+{
+    it->p = path ? path : "";
+}
 
-    char *res = calloc(1, out_len + 1);
-    if (!res) {
-        free(stack);
-        free(buf);
-        return NULL;
+int vfs_path_iter_next(vfs_path_iter_t *it, const char **name, size_t *len)
+{
+    const char *p = it->p;
+    while (*p == '/')
+        p++;
+    if (!*p) {
+        it->p = p;
+        return 0;
     }
 
-    char *q = res;
-    *q++ = '/';
+    const char *end = p;
+    while (*end && *end != '/')
+        end++;
+
+    *name = p;
+    *len = (size_t)(end - p);
+    it->p = end;
+    return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* MEMORY ACCOUNTING */
+/* -------------------------------------------------------------------------- */
+/*
+ * Approximate footprint of the dentry/inode caches. Dentries are uncharged
+ * when they are unlinked, not when the RCU-deferred free finally runs, so
+ * the shrinker sees its progress immediately.
+ */
+#define VFS_DEFAULT_DCACHE_BUDGET (64u << 20)
+
+static struct {
+    _Atomic size_t   dentries;
+    _Atomic size_t   dentries_peak;
+    _Atomic size_t   inodes;
+    _Atomic size_t   inodes_peak;
+    _Atomic size_t   bytes;
+    _Atomic size_t   budget;
+    _Atomic uint64_t evictions;
+} g_mem = {
+    .budget = VFS_DEFAULT_DCACHE_BUDGET,
+};
+
+static void peak_update(_Atomic size_t *peak, size_t v)
+{
+    size_t cur = atomic_load_explicit(peak, memory_order_relaxed);
+    while (v > cur &&
+           !atomic_compare_exchange_weak_explicit(peak, &cur, v, memory_order_relaxed,
+                                                  memory_order_relaxed))
+        ;
+}
+
+static void mem_charge(_Atomic size_t *count, _Atomic size_t *peak, size_t bytes)
+{
+    size_t n = atomic_fetch_add_explicit(count, 1, memory_order_relaxed) + 1;
+    peak_update(peak, n);
+    atomic_fetch_add_explicit(&g_mem.bytes, bytes, memory_order_relaxed);
+}
+
+static void mem_uncharge(_Atomic size_t *count, size_t bytes)
+{
+    atomic_fetch_sub_explicit(count, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&g_mem.bytes, bytes, memory_order_relaxed);
+}
+
+/* Inodes and dentries come from slab caches, not one malloc per object */
+static vfs_slab_cache_t g_inode_slab;
+static vfs_slab_cache_t g_dentry_slab;
+static pthread_once_t g_slab_once = PTHREAD_ONCE_INIT;
+
+static void slab_init_once(void)
+{
+    vfs_slab_init(&g_inode_slab, "vfs_inode", sizeof(vfs_inode_t));
+    vfs_slab_init(&g_dentry_slab, "vfs_dentry", sizeof(vfs_dentry_t));
+}
+
+/* Bytes a dentry costs beyond the slab object: only out-of-line names */
+static size_t dentry_name_bytes(size_t len)
+{
+    return len < VFS_DNAME_INLINE ? 0 : len + 1;
+}
+
+void vfs_get_slab_stats(vfs_slab_stats_t *inodes, vfs_slab_stats_t *dentries)
+{
+    pthread_once(&g_slab_once, slab_init_once);
+    if (inodes)
+        vfs_slab_get_stats(&g_inode_slab, inodes);
+    if (dentries)
+        vfs_slab_get_stats(&g_dentry_slab, dentries);
+}
+
+/* -------------------------------------------------------------------------- */
+/* INODE NUMBERS */
+/* -------------------------------------------------------------------------- */
+/*
+ * Synthetic inode numbers come from a global counter, but each thread grabs
+ * a whole batch at a time so create-heavy threads do not fight over one
+ * cache line. Numbers are unique, not dense: a thread that exits leaves the
+ * rest of its batch unused.
+ *
+ * Stable numbers (VFS_MOUNT_STABLE_INO) have the top bit set so they never
+ * collide with synthetic ones: bits 48-62 identify (mount, backend st_dev),
+ * bits 0-47 carry the backend st_ino.
+ */
+#define VFS_INO_FIRST  1000
+#define VFS_INO_BATCH  1024
+#define VFS_INO_STABLE (1ULL << 63)
+
+static _Atomic uint64_t g_ino_next = VFS_INO_FIRST;
+static __thread uint64_t tls_ino_next, tls_ino_end;
 
-    for (size_t i = 0; i < top; i++) {
-        size_t n = strlen(stack[i]);
-        memcpy(q, stack[i], n);
-        q += n;
-        if (i + 1 < top)
-            *q++ = '/';
+static uint64_t ino_alloc(void)
+{
+    if (tls_ino_next == tls_ino_end) {
+        tls_ino_next = atomic_fetch_add_explicit(&g_ino_next, VFS_INO_BATCH,
+                                                 memory_order_relaxed);
+        tls_ino_end = tls_ino_next + VFS_INO_BATCH;
     }
-    *q = '\0';
+    return tls_ino_next++;
+}
 
-    free(stack);
-    free(buf);
-    return res;
+static uint64_t mix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+/* Inode number for a backend object that survives remounts */
+static uint64_t ino_stable(uint32_t mount_id, dev_t dev, ino_t ino)
+{
+    uint64_t dev_id = mix64(((uint64_t)mount_id << 32) ^ (uint64_t)dev);
+    uint64_t lo = (uint64_t)ino;
+    if (lo >> 48)           /* huge st_ino: fold it in, accept the hash */
+        lo = mix64(lo ^ dev_id);
+    return VFS_INO_STABLE | ((dev_id & 0x7fffULL) << 48) | (lo & 0xffffffffffffULL);
+}
+
+static uint64_t mount_ino(const vfs_mount_entry_t *m, const struct stat *st)
+{
+    if (m->flags & VFS_MOUNT_STABLE_INO)
+        return ino_stable(m->mount_id, st->st_dev, st->st_ino);
+    return ino_alloc();
+}
+
+/* -------------------------------------------------------------------------- */
+/* OBJECT LOCKS */
+/* -------------------------------------------------------------------------- */
+/*
+ * Inodes and dentries do not embed a mutex. The few fields that need one
+ * (a directory's child list, an inode's backend handle and cached
+ * attributes) are guarded by a lock picked from a striped table by object
+ * address. Unrelated objects may share a stripe, so a thread must never
+ * hold two locks of the same table at once; dentry -> inode nesting is fine.
+ */
+#define OBJ_LOCK_STRIPES 256
+
+typedef struct {
+    pthread_mutex_t lock;
+} __attribute__((aligned(64))) obj_lock_t;
+
+static obj_lock_t g_inode_locks[OBJ_LOCK_STRIPES] = {
+    [0 ... OBJ_LOCK_STRIPES - 1] = { PTHREAD_MUTEX_INITIALIZER }
+};
+static obj_lock_t g_dentry_locks[OBJ_LOCK_STRIPES] = {
+    [0 ... OBJ_LOCK_STRIPES - 1] = { PTHREAD_MUTEX_INITIALIZER }
+};
+
+static pthread_mutex_t *obj_lock(obj_lock_t *table, const void *obj)
+{
+    return &table[mix64((uint64_t)(uintptr_t)obj) & (OBJ_LOCK_STRIPES - 1)].lock;
 }
 
+static void inode_lock(vfs_inode_t *ino)   { pthread_mutex_lock(obj_lock(g_inode_locks, ino)); }
+static void inode_unlock(vfs_inode_t *ino) { pthread_mutex_unlock(obj_lock(g_inode_locks, ino)); }
+
+static void dentry_lock(vfs_dentry_t *d)    { pthread_mutex_lock(obj_lock(g_dentry_locks, d)); }
+static void dentry_unlock(vfs_dentry_t *d)  { pthread_mutex_unlock(obj_lock(g_dentry_locks, d)); }
+static int dentry_trylock(vfs_dentry_t *d)  { return pthread_mutex_trylock(obj_lock(g_dentry_locks, d)); }
+
+/* The lookup and I/O paths only touch the first cache line */
+_Static_assert(offsetof(vfs_inode_t, attr_expires) + sizeof(uint64_t) <= 64,
+               "hot inode fields must fit in one cache line");
+_Static_assert(offsetof(vfs_dentry_t, reclaimable) < 64,
+               "hot dentry fields must fit in one cache line");
+
 /* -------------------------------------------------------------------------- */
 /* INODE HELPERS */
 /* -------------------------------------------------------------------------- */
@@ -246,7 +575,8 @@ static char *normalize_path_alloc(const char *path)
 vfs_inode_t *vfs_inode_create(uint64_t ino, mode_t mode,
                               uid_t uid, gid_t gid, off_t size)
 {
-    vfs_inode_t *n = calloc(1, sizeof(*n));
+    pthread_once(&g_slab_once, slab_init_once);
+    vfs_inode_t *n = vfs_slab_alloc(&g_inode_slab);
     if (!n)
         return NULL;
 
@@ -255,787 +585,3242 @@ vfs_inode_t *vfs_inode_create(uint64_t ino, mode_t mode,
     n->uid = uid;
     n->gid = gid;
     n->size = size;
-    n->refcount = 1;
+    atomic_init(&n->refcount, 1);
 
-    pthread_mutex_init(&n->lock, NULL);
+    mem_charge(&g_mem.inodes, &g_mem.inodes_peak, sizeof(*n));
     return n;
 }
 
 void vfs_inode_acquire(vfs_inode_t *ino)
 {
     if (!ino) return;
-    pthread_mutex_lock(&ino->lock);
-    ino->refcount++;
-    pthread_mutex_unlock(&ino->lock);
-}
-
-void vfs_inode_release(vfs_inode_t *ino)
-{
-    if (!ino) return;
-
-    int free_now = 0;
-    pthread_mutex_lock(&ino->lock);
-    if (--ino->refcount == 0)
-        free_now = 1;
-    pthread_mutex_unlock(&ino->lock);
-
-    if (free_now) {
-        pthread_mutex_destroy(&ino->lock);
-        free(ino);
-    }
+    atomic_fetch_add_explicit(&ino->refcount, 1, memory_order_relaxed);
 }
 
 /* -------------------------------------------------------------------------- */
-/* DENTRY HELPERS */
+/* INODE TABLE */
 /* -------------------------------------------------------------------------- */
+/*
+ * Backend inodes are hashed by (mount, backend st_dev, backend st_ino), so
+ * every path that reaches the same backend file (hard links, repeated
+ * lookups after an eviction, O_CREAT opens) shares one vfs_inode_t with its
+ * cached attributes and backend handle.
+ *
+ * The table does not hold references. An inode is unhashed by the release
+ * that drops its last reference, under the same stripe lock lookups take,
+ * so a lookup never revives a dying inode; releases that leave other
+ * references behind skip the table entirely. Lookups only happen on dcache
+ * misses, so plain locking is good enough here.
+ */
+#define ITABLE_INITIAL_BUCKETS 1024
+#define ITABLE_STRIPES         64
 
-vfs_dentry_t *vfs_dentry_create(const char *name,
-                                vfs_dentry_t *parent,
-                                vfs_inode_t *inode)
+static struct {
+    vfs_inode_t    **buckets;
+    size_t           nbuckets;           /* power of two */
+    _Atomic size_t   count;
+    pthread_rwlock_t resize_lock;        /* write-held while rehashing */
+    struct {
+        pthread_mutex_t lock;
+    } __attribute__((aligned(64))) stripes[ITABLE_STRIPES];
+} g_itable = {
+    .resize_lock = PTHREAD_RWLOCK_INITIALIZER,
+};
+
+static pthread_once_t g_itable_once = PTHREAD_ONCE_INIT;
+
+/* How long cached backend attributes are trusted (0: always ask the backend) */
+#define VFS_DEFAULT_ATTR_TTL_MS 1000
+static _Atomic uint64_t g_attr_ttl_ns = VFS_DEFAULT_ATTR_TTL_MS * 1000000ULL;
+
+static void itable_init_once(void)
 {
-    vfs_dentry_t *d = calloc(1, sizeof(*d));
-    if (!d)
-        return NULL;
-
-    d->name = strdup(name ? name : "");
-    d->parent = parent;
-    d->inode  = inode;
+    for (int i = 0; i < ITABLE_STRIPES; i++)
+        pthread_mutex_init(&g_itable.stripes[i].lock, NULL);
+    g_itable.buckets = calloc(ITABLE_INITIAL_BUCKETS, sizeof(g_itable.buckets[0]));
+    g_itable.nbuckets = g_itable.buckets ? ITABLE_INITIAL_BUCKETS : 0;
+}
 
-    if (inode)
-        vfs_inode_acquire(inode);
+static size_t itable_hash(const struct vfs_mount *m, dev_t dev, ino_t ino)
+{
+    return (size_t)mix64((uint64_t)(uintptr_t)m ^ mix64((uint64_t)dev) ^ (uint64_t)ino);
+}
 
-    pthread_mutex_init(&d->lock, NULL);
-    return d;
+/* Caller holds resize_lock (read) and the stripe lock of the bucket */
+static vfs_inode_t **itable_bucket(const struct vfs_mount *m, dev_t dev, ino_t ino,
+                                   pthread_mutex_t **stripe_lock)
+{
+    size_t h = itable_hash(m, dev, ino) & (g_itable.nbuckets - 1);
+    if (stripe_lock)
+        *stripe_lock = &g_itable.stripes[h % ITABLE_STRIPES].lock;
+    return &g_itable.buckets[h];
 }
 
-void vfs_dentry_add_child(vfs_dentry_t *parent, vfs_dentry_t *child)
+static void itable_grow(void)
 {
-    if (!parent || !child)
+    pthread_rwlock_wrlock(&g_itable.resize_lock);
+    size_t old_n = g_itable.nbuckets;
+    if (atomic_load(&g_itable.count) <= old_n * 2) {
+        pthread_rwlock_unlock(&g_itable.resize_lock);
+        return;
+    }
+    vfs_inode_t **nb = calloc(old_n * 2, sizeof(*nb));
+    if (!nb) {
+        pthread_rwlock_unlock(&g_itable.resize_lock);
         return;
+    }
+    vfs_inode_t **ob = g_itable.buckets;
+    g_itable.buckets = nb;
+    g_itable.nbuckets = old_n * 2;
+    for (size_t i = 0; i < old_n; i++) {
+        vfs_inode_t *n = ob[i];
+        while (n) {
+            vfs_inode_t *next = n->hash_next;
+            vfs_inode_t **b = itable_bucket(n->mount, n->backend_dev, n->backend_ino, NULL);
+            n->hash_next = *b;
+            *b = n;
+            n = next;
+        }
+    }
+    pthread_rwlock_unlock(&g_itable.resize_lock);
+    free(ob);
+}
 
-    pthread_mutex_lock(&parent->lock);
-    child->sibling = parent->child;
-    parent->child = child;
-    child->parent = parent;
-    pthread_mutex_unlock(&parent->lock);
+/* Close every backend handle the inode still owns */
+static void inode_close_handles(vfs_inode_t *ino)
+{
+    const vfs_backend_ops_t *ops = ino->mount ? ino->mount->backend_ops : NULL;
+    vfs_retired_handle_t *r = ino->retired;
+    while (r) {
+        vfs_retired_handle_t *next = r->next;
+        if (ops && ops->close)
+            ops->close(ino->mount->backend_data, r->handle);
+        free(r);
+        r = next;
+    }
+    if (ino->backend_handle && ops && ops->close)
+        ops->close(ino->mount->backend_data, ino->backend_handle);
 }
 
-void vfs_dentry_remove_child(vfs_dentry_t *parent, vfs_dentry_t *child)
+/* Drop a reference that is not the last one; fails when it would be */
+static int inode_put_not_last(vfs_inode_t *ino)
 {
-    if (!parent || !child)
-        return;
+    int c = atomic_load_explicit(&ino->refcount, memory_order_relaxed);
+    while (c > 1) {
+        if (atomic_compare_exchange_weak_explicit(&ino->refcount, &c, c - 1,
+                                                  memory_order_release,
+                                                  memory_order_relaxed))
+            return 1;
+    }
+    return 0;
+}
 
-    pthread_mutex_lock(&parent->lock);
-    vfs_dentry_t **cur = &parent->child;
-    while (*cur) {
-        if (*cur == child) {
-            *cur = child->sibling;
-            child->sibling = NULL;
-            child->parent = NULL;
-            break;
+void vfs_inode_release(vfs_inode_t *ino)
+{
+    if (!ino) return;
+
+    int free_now = 0;
+    if (ino->mount) {
+        if (inode_put_not_last(ino))
+            return;
+        /* Hashed: the final put and the unhash must be atomic wrt lookups */
+        pthread_mutex_t *sl;
+        pthread_rwlock_rdlock(&g_itable.resize_lock);
+        vfs_inode_t **b = itable_bucket(ino->mount, ino->backend_dev, ino->backend_ino, &sl);
+        pthread_mutex_lock(sl);
+        free_now = atomic_fetch_sub(&ino->refcount, 1) == 1;
+        if (free_now) {
+            while (*b && *b != ino)
+                b = &(*b)->hash_next;
+            if (*b)
+                *b = ino->hash_next;
+            atomic_fetch_sub(&g_itable.count, 1);
         }
-        cur = &(*cur)->sibling;
+        pthread_mutex_unlock(sl);
+        pthread_rwlock_unlock(&g_itable.resize_lock);
+    } else {
+        free_now = atomic_fetch_sub(&ino->refcount, 1) == 1;
+    }
+
+    if (free_now) {
+        inode_close_handles(ino);
+        mem_uncharge(&g_mem.inodes, sizeof(*ino));
+        vfs_slab_free(&g_inode_slab, ino);
     }
-    pthread_mutex_unlock(&parent->lock);
 }
 
-static void destroy_dentry_only(vfs_dentry_t *d)
+/* Cache st as ino's attributes. Caller holds inode_lock(ino). */
+static void inode_set_attr_locked(vfs_inode_t *ino, const struct stat *st)
 {
-    pthread_mutex_destroy(&d->lock);
-    if (d->inode)
-        vfs_inode_release(d->inode);
-    free(d->name);
-    free(d);
+    ino->mode = st->st_mode;
+    ino->uid = st->st_uid;
+    ino->gid = st->st_gid;
+    ino->size = st->st_size;
+    ino->nlink = (uint32_t)st->st_nlink;
+    ino->blksize = (uint32_t)st->st_blksize;
+    ino->blocks = (uint64_t)st->st_blocks;
+    ino->rdev = (uint64_t)st->st_rdev;
+    ino->atime = st->st_atim;
+    ino->mtime = st->st_mtim;
+    ino->ctime = st->st_ctim;
+    ino->attr_expires = monotonic_ns() + atomic_load(&g_attr_ttl_ns);
 }
 
-void vfs_dentry_destroy(vfs_dentry_t *dentry)
+/* Rebuild a stat from the cached attributes. Caller holds inode_lock(ino). */
+static void inode_get_attr_locked(const vfs_inode_t *ino, struct stat *st)
 {
-    if (!dentry)
-        return;
+    memset(st, 0, sizeof(*st));
+    st->st_dev = ino->backend_dev;
+    st->st_ino = ino->ino;
+    st->st_mode = ino->mode;
+    st->st_nlink = ino->nlink;
+    st->st_uid = ino->uid;
+    st->st_gid = ino->gid;
+    st->st_rdev = (dev_t)ino->rdev;
+    st->st_size = ino->size;
+    st->st_blksize = ino->blksize;
+    st->st_blocks = (blkcnt_t)ino->blocks;
+    st->st_atim = ino->atime;
+    st->st_mtim = ino->mtime;
+    st->st_ctim = ino->ctime;
+}
 
-    /* Detach from parent if present */
-    if (dentry->parent) {
-        vfs_dentry_remove_child(dentry->parent, dentry);
+/*
+ * Find the live inode for backend object st on mount m, or create and hash
+ * a new one. Either way the attributes are refreshed from st and a new
+ * reference is returned.
+ */
+static vfs_inode_t *itable_get(struct vfs_mount *m, const struct stat *st)
+{
+    pthread_once(&g_itable_once, itable_init_once);
+    if (!g_itable.nbuckets)
+        return NULL;
+
+    pthread_mutex_t *sl;
+    pthread_rwlock_rdlock(&g_itable.resize_lock);
+    vfs_inode_t **b = itable_bucket(m, st->st_dev, st->st_ino, &sl);
+    pthread_mutex_lock(sl);
+
+    vfs_inode_t *n;
+    int created = 0;
+    for (n = *b; n; n = n->hash_next) {
+        if (n->mount == m && n->backend_dev == st->st_dev && n->backend_ino == st->st_ino)
+            break;
+    }
+    if (n) {
+        atomic_fetch_add_explicit(&n->refcount, 1, memory_order_relaxed);
+        inode_lock(n);
+        inode_set_attr_locked(n, st);
+        inode_unlock(n);
+    } else {
+        n = vfs_inode_create(mount_ino(m, st), st->st_mode, st->st_uid, st->st_gid, st->st_size);
+        if (n) {
+            n->mount = m;
+            n->backend_dev = st->st_dev;
+            n->backend_ino = st->st_ino;
+            inode_set_attr_locked(n, st);
+            n->hash_next = *b;
+            *b = n;
+            created = 1;
+        }
     }
+    pthread_mutex_unlock(sl);
+    size_t nbuckets = g_itable.nbuckets;
+    pthread_rwlock_unlock(&g_itable.resize_lock);
 
-    /* Destroy subtree rooted at this dentry */
-    vfs_dentry_destroy_tree(dentry);
+    if (created && atomic_fetch_add(&g_itable.count, 1) + 1 > nbuckets * 2)
+        itable_grow();
+    return n;
 }
 
-void vfs_dentry_release(vfs_dentry_t *dentry)
+void vfs_set_attr_ttl_ms(unsigned int ttl_ms)
 {
-    if (!dentry) return;
-    
-    /* For orphaned dentries (no parent), free them directly */
-    if (!dentry->parent) {
-        destroy_dentry_only(dentry);
-        return;
-    }
-    
-    /* For dentries with parents, they'll be cleaned up with the tree */
-    /* This is a no-op for now - could implement ref counting later */
+    atomic_store(&g_attr_ttl_ns, (uint64_t)ttl_ms * 1000000ULL);
 }
 
-void vfs_dentry_destroy_tree(vfs_dentry_t *root)
+unsigned int vfs_get_attr_ttl_ms(void)
 {
-    if (!root) return;
-
-    vfs_dentry_t *c = root->child;
-    while (c) {
-        vfs_dentry_t *next = c->sibling;
-        vfs_dentry_destroy_tree(c);
-        c = next;
-    }
-    destroy_dentry_only(root);
+    return (unsigned int)(atomic_load(&g_attr_ttl_ns) / 1000000ULL);
 }
 
 /* -------------------------------------------------------------------------- */
-/* MOUNTING */
+/* DENTRY CACHE                                                               */
 /* -------------------------------------------------------------------------- */
+/*
+ * Global hash of linked dentries keyed by (parent pointer, name).
+ *
+ * Writers serialize per bucket stripe and bump that stripe's sequence
+ * counter around every chain update; chain pointers are published with
+ * release stores. Readers can therefore walk chains without taking any lock
+ * (inside an RCU read-side section) and simply retry when a sequence counter
+ * moved underneath them. The rwlock is only taken for writing while the
+ * bucket array is rehashed, which also bumps resize_seq.
+ */
+#define DCACHE_INITIAL_BUCKETS 1024
+#define DCACHE_STRIPES         64
+#define DCACHE_RCU_RETRIES     4
 
-vfs_mount_entry_t *vfs_mount_create(const char *mountpoint,
-                                const char *backend_root)
-{
-    vfs_mount_entry_t *m = calloc(1, sizeof(*m));
-    if (!m)
-        return NULL;
+#define DENTRY_HASHED      0x1  /* linked into the dcache right now */
+#define DENTRY_RCU_VISIBLE 0x2  /* was hashed once: free after a grace period */
 
-    m->mountpoint = strdup(mountpoint);
-    m->backend_root = strdup(backend_root);
-    m->backend_ops = NULL;  /* No backend by default */
-    m->backend_data = NULL;
+typedef struct dcache_table {
+    size_t nbuckets;                      /* always a power of two */
+    _Atomic(vfs_dentry_t *) buckets[];
+} dcache_table_t;
 
-    /* Create synthetic root inode + dentry */
-    uint64_t ino = g_next_ino++;
-    vfs_inode_t *ri = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
-    m->root_dentry = vfs_dentry_create("/", NULL, ri);
-    vfs_inode_release(ri);
+typedef struct dcache_stripe {
+    pthread_mutex_t lock;
+    _Atomic unsigned seq;                 /* odd while a chain is changing */
+} __attribute__((aligned(64))) dcache_stripe_t;
 
-    pthread_mutex_lock(&g_vfs_lock);
-    m->next = mount_table_head;
-    mount_table_head = m;
-    pthread_mutex_unlock(&g_vfs_lock);
+static struct {
+    _Atomic(dcache_table_t *) table;
+    _Atomic unsigned          resize_seq;
+    _Atomic size_t            count;
+    pthread_rwlock_t          resize_lock;
+    dcache_stripe_t           stripes[DCACHE_STRIPES];
+
+    _Atomic int               rcu_walk;   /* optimistic lockless walks on/off */
+    _Atomic uint64_t          rcu_retries;
+    _Atomic uint64_t          rcu_fallbacks;
+    _Atomic uint64_t          backend_lookups;
+} g_dcache = {
+    .resize_lock = PTHREAD_RWLOCK_INITIALIZER,
+    .rcu_walk    = 1,
+};
+
+static pthread_once_t g_dcache_once = PTHREAD_ONCE_INIT;
 
-    return m;
+/*
+ * Unused (refcount 0) reclaimable dentries, most recently used at the head.
+ * Entries that get pinned again stay on the list until the shrinker finds
+ * them, which keeps the lookup path free of LRU lock traffic.
+ * Lock order: dentry->lock before g_lru.lock; the shrinker only trylocks
+ * a parent while holding g_lru.lock.
+ */
+#define DENTRY_DEAD (-1)        /* refcount of an entry claimed for eviction */
+
+static struct {
+    pthread_mutex_t  lock;
+    vfs_dentry_t     head;      /* sentinel: head.lru_next is the newest */
+    _Atomic size_t   count;
+    pthread_mutex_t  shrink_lock; /* one shrinker at a time */
+} g_lru = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .head = { .lru_prev = &g_lru.head, .lru_next = &g_lru.head },
+    .shrink_lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static dcache_table_t *dcache_table_alloc(size_t nbuckets)
+{
+    dcache_table_t *t = calloc(1, sizeof(*t) + nbuckets * sizeof(t->buckets[0]));
+    if (t)
+        t->nbuckets = nbuckets;
+    return t;
 }
 
-int vfs_mount_destroy(vfs_mount_entry_t *m)
+static void dcache_init_once(void)
 {
-    if (!m)
-        return -EINVAL;
+    for (int i = 0; i < DCACHE_STRIPES; i++)
+        pthread_mutex_init(&g_dcache.stripes[i].lock, NULL);
+    atomic_store(&g_dcache.table, dcache_table_alloc(DCACHE_INITIAL_BUCKETS));
+}
 
-    pthread_mutex_lock(&g_vfs_lock);
-    vfs_mount_entry_t **cur = &mount_table_head;
-    while (*cur) {
-        if (*cur == m) {
+/* FNV-1a over the component bytes */
+uint32_t vfs_name_hash(const char *name, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static size_t dcache_slot(const vfs_dentry_t *parent, uint32_t name_hash)
+{
+    uint64_t k = (uint64_t)(uintptr_t)parent ^ ((uint64_t)name_hash << 17);
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    return (size_t)k;
+}
+
+/* Seqcount write side; caller holds the stripe lock (or the resize wrlock) */
+static void seq_write_begin(_Atomic unsigned *seq)
+{
+    atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void seq_write_end(_Atomic unsigned *seq)
+{
+    atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+static void dcache_grow(void)
+{
+    pthread_rwlock_wrlock(&g_dcache.resize_lock);
+    dcache_table_t *old = atomic_load_explicit(&g_dcache.table, memory_order_relaxed);
+    if (atomic_load(&g_dcache.count) <= old->nbuckets * 2) {
+        /* someone else already grew the table */
+        pthread_rwlock_unlock(&g_dcache.resize_lock);
+        return;
+    }
+
+    size_t new_n = old->nbuckets * 2;
+    dcache_table_t *nt = dcache_table_alloc(new_n);
+    if (!nt) {
+        /* keep working with longer chains */
+        pthread_rwlock_unlock(&g_dcache.resize_lock);
+        return;
+    }
+
+    /* Rehashing rewrites hash_next of live entries: lockless readers that
+     * stray onto a foreign chain will see resize_seq move and retry. */
+    seq_write_begin(&g_dcache.resize_seq);
+    for (size_t i = 0; i < old->nbuckets; i++) {
+        vfs_dentry_t *d = atomic_load_explicit(&old->buckets[i], memory_order_relaxed);
+        while (d) {
+            vfs_dentry_t *next = atomic_load_explicit(&d->hash_next, memory_order_relaxed);
+            size_t b = dcache_slot(d->parent, d->name_hash) & (new_n - 1);
+            atomic_store_explicit(&d->hash_next,
+                                  atomic_load_explicit(&nt->buckets[b], memory_order_relaxed),
+                                  memory_order_relaxed);
+            atomic_store_explicit(&nt->buckets[b], d, memory_order_relaxed);
+            d = next;
+        }
+    }
+    atomic_store_explicit(&g_dcache.table, nt, memory_order_release);
+    seq_write_end(&g_dcache.resize_seq);
+    pthread_rwlock_unlock(&g_dcache.resize_lock);
+
+    vfs_rcu_defer_free(old, free);
+}
+
+static void dcache_insert(vfs_dentry_t *d)
+{
+    pthread_once(&g_dcache_once, dcache_init_once);
+    if (!d->parent || (d->flags & DENTRY_HASHED))
+        return;
+
+    pthread_rwlock_rdlock(&g_dcache.resize_lock);
+    dcache_table_t *t = atomic_load_explicit(&g_dcache.table, memory_order_relaxed);
+    if (!t) {
+        pthread_rwlock_unlock(&g_dcache.resize_lock);
+        return;
+    }
+    size_t b = dcache_slot(d->parent, d->name_hash) & (t->nbuckets - 1);
+    dcache_stripe_t *s = &g_dcache.stripes[b % DCACHE_STRIPES];
+    pthread_mutex_lock(&s->lock);
+    seq_write_begin(&s->seq);
+    atomic_store_explicit(&d->hash_next,
+                          atomic_load_explicit(&t->buckets[b], memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store_explicit(&t->buckets[b], d, memory_order_release);
+    seq_write_end(&s->seq);
+    d->flags |= DENTRY_HASHED | DENTRY_RCU_VISIBLE;
+    pthread_mutex_unlock(&s->lock);
+    size_t nbuckets = t->nbuckets;
+    pthread_rwlock_unlock(&g_dcache.resize_lock);
+
+    if (atomic_fetch_add(&g_dcache.count, 1) + 1 > nbuckets * 2)
+        dcache_grow();
+}
+
+static void dcache_remove(vfs_dentry_t *d)
+{
+    if (!(d->flags & DENTRY_HASHED))
+        return;
+
+    pthread_rwlock_rdlock(&g_dcache.resize_lock);
+    dcache_table_t *t = atomic_load_explicit(&g_dcache.table, memory_order_relaxed);
+    size_t b = dcache_slot(d->parent, d->name_hash) & (t->nbuckets - 1);
+    dcache_stripe_t *s = &g_dcache.stripes[b % DCACHE_STRIPES];
+    pthread_mutex_lock(&s->lock);
+    _Atomic(vfs_dentry_t *) *cur = &t->buckets[b];
+    vfs_dentry_t *c;
+    while ((c = atomic_load_explicit(cur, memory_order_relaxed))) {
+        if (c == d) {
+            /* d->hash_next stays intact for readers still standing on d */
+            seq_write_begin(&s->seq);
+            atomic_store_explicit(cur, atomic_load_explicit(&d->hash_next, memory_order_relaxed),
+                                  memory_order_release);
+            seq_write_end(&s->seq);
+            break;
+        }
+        cur = &c->hash_next;
+    }
+    d->flags &= ~DENTRY_HASHED;
+    pthread_mutex_unlock(&s->lock);
+    pthread_rwlock_unlock(&g_dcache.resize_lock);
+
+    atomic_fetch_sub(&g_dcache.count, 1);
+}
+
+static int dentry_matches(const vfs_dentry_t *d, const vfs_dentry_t *parent,
+                          uint32_t h, const char *name, size_t len)
+{
+    return d->parent == parent && d->name_hash == h &&
+           d->name_len == len && memcmp(d->name, name, len) == 0;
+}
+
+vfs_dentry_t *vfs_dcache_lookup(const vfs_dentry_t *parent,
+                                const char *name, size_t len)
+{
+    if (!parent || !name)
+        return NULL;
+
+    pthread_once(&g_dcache_once, dcache_init_once);
+
+    uint32_t h = vfs_name_hash(name, len);
+    vfs_dentry_t *found = NULL;
+
+    pthread_rwlock_rdlock(&g_dcache.resize_lock);
+    dcache_table_t *t = atomic_load_explicit(&g_dcache.table, memory_order_relaxed);
+    if (t) {
+        size_t b = dcache_slot(parent, h) & (t->nbuckets - 1);
+        dcache_stripe_t *s = &g_dcache.stripes[b % DCACHE_STRIPES];
+        pthread_mutex_lock(&s->lock);
+        for (vfs_dentry_t *d = atomic_load_explicit(&t->buckets[b], memory_order_relaxed); d;
+             d = atomic_load_explicit(&d->hash_next, memory_order_relaxed)) {
+            if (dentry_matches(d, parent, h, name, len)) {
+                found = d;
+                break;
+            }
+        }
+        pthread_mutex_unlock(&s->lock);
+    }
+    pthread_rwlock_unlock(&g_dcache.resize_lock);
+
+    return found;
+}
+
+/*
+ * Lockless single-component lookup. Must run inside vfs_rcu_read_lock().
+ * Sets *retry when a concurrent chain update or resize may have hidden the
+ * entry; the result is only trustworthy when *retry stays 0.
+ */
+static vfs_dentry_t *dcache_lookup_rcu(const vfs_dentry_t *parent,
+                                       const char *name, size_t len, int *retry)
+{
+    uint32_t h = vfs_name_hash(name, len);
+
+    unsigned rs = atomic_load_explicit(&g_dcache.resize_seq, memory_order_acquire);
+    if (rs & 1) {
+        *retry = 1;
+        return NULL;
+    }
+    dcache_table_t *t = atomic_load_explicit(&g_dcache.table, memory_order_acquire);
+    if (!t) {
+        *retry = 1;
+        return NULL;
+    }
+
+    size_t b = dcache_slot(parent, h) & (t->nbuckets - 1);
+    dcache_stripe_t *s = &g_dcache.stripes[b % DCACHE_STRIPES];
+    unsigned seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if (seq & 1) {
+        *retry = 1;
+        return NULL;
+    }
+
+    vfs_dentry_t *found = NULL;
+    for (vfs_dentry_t *d = atomic_load_explicit(&t->buckets[b], memory_order_acquire); d;
+         d = atomic_load_explicit(&d->hash_next, memory_order_acquire)) {
+        if (dentry_matches(d, parent, h, name, len)) {
+            found = d;
+            break;
+        }
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&s->seq, memory_order_relaxed) != seq ||
+        atomic_load_explicit(&g_dcache.resize_seq, memory_order_relaxed) != rs) {
+        *retry = 1;
+        return NULL;
+    }
+    return found;
+}
+
+/*
+ * Optimistic walk of the components left in *it, starting at root.
+ * Returns the deepest cached dentry and leaves *it positioned before the
+ * first component that is not cached (expired negative entries count as
+ * not cached). A live negative entry stops the walk with *negative set.
+ * Returns NULL if a concurrent modification was detected and the walk
+ * must be retried.
+ */
+static vfs_dentry_t *dcache_walk_rcu(vfs_dentry_t *root, vfs_path_iter_t *it,
+                                     int *negative)
+{
+    vfs_dentry_t *cur = root;
+    vfs_path_iter_t before = *it;
+    const char *name;
+    size_t len;
+
+    while (vfs_path_iter_next(it, &name, &len)) {
+        int retry = 0;
+        vfs_dentry_t *next = dcache_lookup_rcu(cur, name, len, &retry);
+        if (retry)
+            return NULL;
+        if (next && !next->inode) {
+            if (monotonic_ns() < next->neg_expires) {
+                *negative = 1;
+                return next;
+            }
+            next = NULL;    /* expired: let the locked walk revalidate */
+        }
+        if (!next) {
+            *it = before;
+            break;
+        }
+        cur = next;
+        before = *it;
+    }
+    return cur;
+}
+
+void vfs_dcache_set_rcu_walk(int enabled)
+{
+    atomic_store(&g_dcache.rcu_walk, enabled ? 1 : 0);
+}
+
+void vfs_dcache_get_stats(vfs_dcache_stats_t *out)
+{
+    if (!out)
+        return;
+    pthread_once(&g_dcache_once, dcache_init_once);
+
+    pthread_rwlock_rdlock(&g_dcache.resize_lock);
+    dcache_table_t *t = atomic_load_explicit(&g_dcache.table, memory_order_relaxed);
+    out->buckets = t ? t->nbuckets : 0;
+    pthread_rwlock_unlock(&g_dcache.resize_lock);
+
+    out->entries = atomic_load(&g_dcache.count);
+    out->rcu_retries = atomic_load(&g_dcache.rcu_retries);
+    out->rcu_fallbacks = atomic_load(&g_dcache.rcu_fallbacks);
+    out->backend_lookups = atomic_load(&g_dcache.backend_lookups);
+    out->dentries = atomic_load(&g_mem.dentries);
+    out->dentries_peak = atomic_load(&g_mem.dentries_peak);
+    out->inodes = atomic_load(&g_mem.inodes);
+    out->inodes_peak = atomic_load(&g_mem.inodes_peak);
+    out->unused = atomic_load(&g_lru.count);
+    out->bytes = atomic_load(&g_mem.bytes);
+    out->evictions = atomic_load(&g_mem.evictions);
+}
+
+void vfs_set_negative_ttl_ms(unsigned int ttl_ms)
+{
+    atomic_store(&g_neg_ttl_ns, (uint64_t)ttl_ms * 1000000ULL);
+}
+
+unsigned int vfs_get_negative_ttl_ms(void)
+{
+    return (unsigned int)(atomic_load(&g_neg_ttl_ns) / 1000000ULL);
+}
+
+/* -------------------------------------------------------------------------- */
+/* DENTRY HELPERS */
+/* -------------------------------------------------------------------------- */
+
+/* Allocate a dentry named by the first len bytes of name */
+static vfs_dentry_t *dentry_alloc(const char *name, size_t len,
+                                  vfs_dentry_t *parent, vfs_inode_t *inode)
+{
+    pthread_once(&g_slab_once, slab_init_once);
+    vfs_dentry_t *d = vfs_slab_alloc(&g_dentry_slab);
+    if (!d)
+        return NULL;
+
+    if (len < VFS_DNAME_INLINE) {
+        memcpy(d->inline_name, name, len);
+        d->inline_name[len] = '\0';
+        d->name = d->inline_name;
+    } else if (!(d->name = strndup(name, len))) {
+        vfs_slab_free(&g_dentry_slab, d);
+        return NULL;
+    }
+    d->name_len = (uint32_t)len;
+    d->name_hash = vfs_name_hash(d->name, d->name_len);
+    d->parent = parent;
+    d->inode  = inode;
+
+    if (inode)
+        vfs_inode_acquire(inode);
+
+    mem_charge(&g_mem.dentries, &g_mem.dentries_peak, sizeof(*d) + dentry_name_bytes(len));
+    return d;
+}
+
+vfs_dentry_t *vfs_dentry_create(const char *name,
+                                vfs_dentry_t *parent,
+                                vfs_inode_t *inode)
+{
+    if (!name)
+        name = "";
+    return dentry_alloc(name, strlen(name), parent, inode);
+}
+
+/* Link child under parent and into the dcache. Caller holds dentry_lock(parent). */
+static void dentry_link_locked(vfs_dentry_t *parent, vfs_dentry_t *child)
+{
+    child->sibling = parent->child;
+    if (parent->child)
+        parent->child->sibling_pprev = &child->sibling;
+    parent->child = child;
+    child->sibling_pprev = &parent->child;
+    child->parent = parent;
+    atomic_fetch_add(&parent->refcount, 1);    /* children pin their parent */
+    dcache_insert(child);
+}
+
+/* O(1) unlink from parent's child list and the dcache. Caller holds dentry_lock(parent). */
+static void dentry_unlink_locked(vfs_dentry_t *child)
+{
+    vfs_dentry_t *parent = child->parent;
+    int linked = child->sibling_pprev != NULL;
+
+    dcache_remove(child);
+    if (linked) {
+        *child->sibling_pprev = child->sibling;
+        if (child->sibling)
+            child->sibling->sibling_pprev = child->sibling_pprev;
+    }
+    child->sibling = NULL;
+    child->sibling_pprev = NULL;
+    child->parent = NULL;
+
+    if (linked && parent)
+        vfs_dentry_release(parent);
+}
+
+void vfs_dentry_add_child(vfs_dentry_t *parent, vfs_dentry_t *child)
+{
+    if (!parent || !child)
+        return;
+
+    dentry_lock(parent);
+    dentry_link_locked(parent, child);
+    dentry_unlock(parent);
+}
+
+void vfs_dentry_remove_child(vfs_dentry_t *parent, vfs_dentry_t *child)
+{
+    if (!parent || !child)
+        return;
+
+    dentry_lock(parent);
+    if (child->parent == parent && child->sibling_pprev)
+        dentry_unlink_locked(child);
+    dentry_unlock(parent);
+}
+
+static void free_dentry(void *arg)
+{
+    vfs_dentry_t *d = arg;
+    if (d->inode)
+        vfs_inode_release(d->inode);
+    if (d->name != d->inline_name)
+        free(d->name);
+    vfs_slab_free(&g_dentry_slab, d);
+}
+
+static void lru_del_locked(vfs_dentry_t *d)
+{
+    d->lru_prev->lru_next = d->lru_next;
+    d->lru_next->lru_prev = d->lru_prev;
+    d->lru_prev = d->lru_next = NULL;
+    atomic_fetch_sub_explicit(&g_lru.count, 1, memory_order_relaxed);
+}
+
+static void lru_add_locked(vfs_dentry_t *d)
+{
+    d->lru_next = g_lru.head.lru_next;
+    d->lru_prev = &g_lru.head;
+    g_lru.head.lru_next->lru_prev = d;
+    g_lru.head.lru_next = d;
+    atomic_fetch_add_explicit(&g_lru.count, 1, memory_order_relaxed);
+}
+
+static void destroy_dentry_only(vfs_dentry_t *d)
+{
+    dcache_remove(d);
+    if (d->reclaimable) {
+        pthread_mutex_lock(&g_lru.lock);
+        if (d->lru_prev)
+            lru_del_locked(d);
+        pthread_mutex_unlock(&g_lru.lock);
+    }
+    mem_uncharge(&g_mem.dentries, sizeof(*d) + dentry_name_bytes(d->name_len));
+    /* Lockless walkers may still be looking at a dentry that was hashed */
+    if (d->flags & DENTRY_RCU_VISIBLE)
+        vfs_rcu_defer_free(d, free_dentry);
+    else
+        free_dentry(d);
+}
+
+void vfs_dentry_destroy(vfs_dentry_t *dentry)
+{
+    if (!dentry)
+        return;
+
+    /* Detach from parent if present */
+    if (dentry->parent) {
+        vfs_dentry_remove_child(dentry->parent, dentry);
+    }
+
+    /* Destroy subtree rooted at this dentry */
+    vfs_dentry_destroy_tree(dentry);
+}
+
+/* Pin d unless the shrinker already claimed it */
+static int dentry_tryget(vfs_dentry_t *d)
+{
+    int c = atomic_load_explicit(&d->refcount, memory_order_relaxed);
+    do {
+        if (c < 0)
+            return 0;
+    } while (!atomic_compare_exchange_weak(&d->refcount, &c, c + 1));
+    return 1;
+}
+
+void vfs_dentry_release(vfs_dentry_t *dentry)
+{
+    if (!dentry) return;
+
+    /* Once the count hits zero the shrinker may claim the entry at any
+     * moment; the read-side section keeps its memory valid until we are
+     * done looking at it. */
+    vfs_rcu_read_lock();
+    if (atomic_fetch_sub(&dentry->refcount, 1) != 1) {
+        vfs_rcu_read_unlock();
+        return;
+    }
+    if (!dentry->reclaimable && !dentry->parent) {
+        /* orphan (e.g. a file created through a backend): nobody can
+         * find it any more */
+        vfs_rcu_read_unlock();
+        destroy_dentry_only(dentry);
+        return;
+    }
+    if (dentry->reclaimable) {
+        pthread_mutex_lock(&g_lru.lock);
+        if (atomic_load(&dentry->refcount) == 0) {
+            if (dentry->lru_prev)
+                lru_del_locked(dentry);     /* re-used: move to the head */
+            lru_add_locked(dentry);
+        }
+        pthread_mutex_unlock(&g_lru.lock);
+    }
+    vfs_rcu_read_unlock();
+}
+
+/*
+ * Evict up to nr unused dentries from the cold end of the LRU, stopping
+ * early once the memory footprint drops to `target` bytes. Must not be
+ * called with any dentry lock held or inside an RCU read-side section.
+ */
+static size_t dcache_shrink_to(size_t target, size_t nr)
+{
+    size_t evicted = 0;
+    size_t scan = atomic_load(&g_lru.count) * 2 + 1;
+
+    while (evicted < nr && scan-- > 0 &&
+           atomic_load_explicit(&g_mem.bytes, memory_order_relaxed) > target) {
+        pthread_mutex_lock(&g_lru.lock);
+        vfs_dentry_t *d = g_lru.head.lru_prev;
+        if (d == &g_lru.head) {
+            pthread_mutex_unlock(&g_lru.lock);
+            break;
+        }
+        if (atomic_load(&d->refcount) != 0) {
+            lru_del_locked(d);          /* pinned again since it was queued */
+            pthread_mutex_unlock(&g_lru.lock);
+            continue;
+        }
+
+        /* d pins its parent, so the parent stays valid while d is queued */
+        vfs_dentry_t *parent = d->parent;
+        if (dentry_trylock(parent) != 0) {
+            lru_del_locked(d);          /* busy directory: try it later */
+            lru_add_locked(d);
+            pthread_mutex_unlock(&g_lru.lock);
+            continue;
+        }
+        int zero = 0;
+        if (!atomic_compare_exchange_strong(&d->refcount, &zero, DENTRY_DEAD)) {
+            lru_del_locked(d);
+            pthread_mutex_unlock(&g_lru.lock);
+            dentry_unlock(parent);
+            continue;
+        }
+        lru_del_locked(d);
+        pthread_mutex_unlock(&g_lru.lock);
+
+        dentry_unlink_locked(d);        /* may queue the parent in turn */
+        dentry_unlock(parent);
+        destroy_dentry_only(d);
+        atomic_fetch_add_explicit(&g_mem.evictions, 1, memory_order_relaxed);
+        evicted++;
+    }
+    return evicted;
+}
+
+/* Enforce the memory budget; cheap when under it */
+static void dcache_maybe_shrink(void)
+{
+    size_t budget = atomic_load_explicit(&g_mem.budget, memory_order_relaxed);
+    if (!budget || atomic_load_explicit(&g_mem.bytes, memory_order_relaxed) <= budget)
+        return;
+    if (pthread_mutex_trylock(&g_lru.shrink_lock) != 0)
+        return;                         /* someone else is already at it */
+    /* shrink a little below the budget so we do not run on every miss */
+    dcache_shrink_to(budget - budget / 8, SIZE_MAX);
+    pthread_mutex_unlock(&g_lru.shrink_lock);
+}
+
+void vfs_dcache_set_budget(size_t bytes)
+{
+    atomic_store(&g_mem.budget, bytes);
+    dcache_maybe_shrink();
+}
+
+size_t vfs_dcache_get_budget(void)
+{
+    return atomic_load(&g_mem.budget);
+}
+
+size_t vfs_dcache_shrink(size_t nr)
+{
+    pthread_mutex_lock(&g_lru.shrink_lock);
+    size_t n = dcache_shrink_to(0, nr);
+    pthread_mutex_unlock(&g_lru.shrink_lock);
+    return n;
+}
+
+void vfs_dentry_destroy_tree(vfs_dentry_t *root)
+{
+    if (!root) return;
+
+    vfs_dentry_t *c = root->child;
+    while (c) {
+        vfs_dentry_t *next = c->sibling;
+        vfs_dentry_destroy_tree(c);
+        c = next;
+    }
+    destroy_dentry_only(root);
+}
+
+/* -------------------------------------------------------------------------- */
+/* MOUNTING */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Mount lookup goes through an immutable trie of mountpoint components,
+ * rebuilt from the mount list on every mount/unmount and published with a
+ * single pointer store. Readers walk it inside an RCU read-side section
+ * without taking g_vfs_lock; the longest match costs O(path depth).
+ * Component names point into the mountpoint strings, so a mount is only
+ * torn down after the trie that still names it has been retired.
+ *
+ * find_best_mount() pins the mount it returns (m->users) before leaving
+ * the read-side section, and the operation drops the pin with mount_put()
+ * when it is done with the mount. Unmounting first hides the mount from
+ * new lookups, waits out readers of the old trie, sleeps until the last
+ * pin is dropped (mount_drain()), and only then looks at open_handles:
+ * every handle is bound by a pinned operation, so the count can no longer
+ * grow by that point.
+ */
+typedef struct mount_trie_node {
+    const char *name;                   /* component, points into a mountpoint */
+    size_t len;
+    vfs_mount_entry_t *mount;           /* mounted exactly here, or NULL */
+    struct mount_trie_node *child;
+    struct mount_trie_node *sibling;
+} mount_trie_node_t;
+
+typedef struct mount_trie {
+    size_t used;
+    mount_trie_node_t nodes[];          /* nodes[0] is "/" */
+} mount_trie_t;
+
+static _Atomic(mount_trie_t *) g_mount_trie;
+
+/* Build a trie of the current mount list. Caller holds g_vfs_lock. */
+static mount_trie_t *mount_trie_build_locked(void)
+{
+    vfs_path_iter_t it;
+    const char *name;
+    size_t len;
+    size_t n = 1;
+
+    for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next) {
+        if (m->unmounting)
+            continue;
+        vfs_path_iter_init(&it, m->mountpoint);
+        while (vfs_path_iter_next(&it, &name, &len))
+            n++;
+    }
+
+    mount_trie_t *t = calloc(1, sizeof(*t) + n * sizeof(t->nodes[0]));
+    if (!t)
+        return NULL;
+    t->used = 1;
+
+    /* The list is newest first, and the newest mount on a path wins */
+    for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next) {
+        if (m->unmounting)
+            continue;
+        mount_trie_node_t *node = &t->nodes[0];
+        vfs_path_iter_init(&it, m->mountpoint);
+        while (vfs_path_iter_next(&it, &name, &len)) {
+            mount_trie_node_t *c = node->child;
+            while (c && !(c->len == len && memcmp(c->name, name, len) == 0))
+                c = c->sibling;
+            if (!c) {
+                c = &t->nodes[t->used++];
+                c->name = name;
+                c->len = len;
+                c->sibling = node->child;
+                node->child = c;
+            }
+            node = c;
+        }
+        if (!node->mount)
+            node->mount = m;
+    }
+    return t;
+}
+
+/* Swap in a trie of the current mount list and return the old one, which
+ * readers may still be walking. On allocation failure no trie is published
+ * and lookups fall back to scanning the list. Caller holds g_vfs_lock. */
+static mount_trie_t *mount_trie_publish_locked(void)
+{
+    mount_trie_t *t = mount_trie_build_locked();
+    return atomic_exchange_explicit(&g_mount_trie, t, memory_order_acq_rel);
+}
+
+static void mount_trie_free(void *t)
+{
+    free(t);
+}
+
+/* Mount without a backend, not yet visible to lookups */
+static vfs_mount_entry_t *mount_alloc(const char *mountpoint, const char *backend_root)
+{
+    vfs_mount_entry_t *m = calloc(1, sizeof(*m));
+    if (!m)
+        return NULL;
+
+    m->mountpoint = strdup(mountpoint);
+    m->backend_root = strdup(backend_root);
+    m->backend_ops = NULL;  /* No backend by default */
+    m->backend_data = NULL;
+    /* Same mountpoint + backend root => same id, across remounts */
+    m->mount_id = vfs_name_hash(mountpoint, strlen(mountpoint)) * 31u +
+                  vfs_name_hash(backend_root, strlen(backend_root));
+
+    /* Create synthetic root inode + dentry */
+    uint64_t ino = ino_alloc();
+    vfs_inode_t *ri = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
+    m->root_dentry = vfs_dentry_create("/", NULL, ri);
+    vfs_inode_release(ri);
+    atomic_store(&m->root_dentry->refcount, 1);     /* the mount's pin */
+    return m;
+}
+
+static void mount_publish(vfs_mount_entry_t *m)
+{
+    pthread_mutex_lock(&g_vfs_lock);
+    m->next = mount_table_head;
+    mount_table_head = m;
+    mount_trie_t *old = mount_trie_publish_locked();
+    pthread_mutex_unlock(&g_vfs_lock);
+
+    if (old)
+        vfs_rcu_defer_free(old, mount_trie_free);
+}
+
+vfs_mount_entry_t *vfs_mount_create(const char *mountpoint,
+                                const char *backend_root)
+{
+    vfs_mount_entry_t *m = mount_alloc(mountpoint, backend_root);
+    if (m)
+        mount_publish(m);
+    return m;
+}
+
+/* Free an unlinked mount. Inodes close their backend handles as they die,
+ * so the tree has to be gone before the backend is shut down. */
+static void mount_teardown(vfs_mount_entry_t *m)
+{
+    vfs_dentry_destroy_tree(m->root_dentry);
+    /* Dentries unlinked above may still sit in the RCU queue */
+    vfs_rcu_barrier();
+
+    /* Shutdown backend if present */
+    if (m->backend_ops && m->backend_ops->shutdown && m->backend_data) {
+        m->backend_ops->shutdown(m->backend_data);
+    }
+
+    free(m->mountpoint);
+    free(m->backend_root);
+    free(m);
+}
+
+static void mount_get(vfs_mount_entry_t *m)
+{
+    atomic_fetch_add_explicit(&m->users, 1, memory_order_relaxed);
+}
+
+/* Drop a pin. m may be torn down as soon as the count reaches 0, so only
+ * globals are touched after that */
+static void mount_put(vfs_mount_entry_t *m)
+{
+    if (atomic_fetch_sub(&m->users, 1) == 1 && atomic_load(&g_mount_drains)) {
+        pthread_mutex_lock(&g_vfs_lock);
+        pthread_cond_broadcast(&g_mount_drained);
+        pthread_mutex_unlock(&g_vfs_lock);
+    }
+}
+
+/* Sleep until no operation pins m, which no lookup can reach any more */
+static void mount_drain(vfs_mount_entry_t *m)
+{
+    /* seq_cst with mount_put(): either it sees the waiter or we see 0 */
+    atomic_fetch_add(&g_mount_drains, 1);
+    pthread_mutex_lock(&g_vfs_lock);
+    while (atomic_load(&m->users))
+        pthread_cond_wait(&g_mount_drained, &g_vfs_lock);
+    pthread_mutex_unlock(&g_vfs_lock);
+    atomic_fetch_sub(&g_mount_drains, 1);
+}
+
+/* Hide m from new lookups; returns the retired trie. Caller holds
+ * g_vfs_lock and has checked that m is listed and not yet unmounting. */
+static mount_trie_t *mount_hide_locked(vfs_mount_entry_t *m)
+{
+    m->unmounting = 1;
+    return mount_trie_publish_locked();
+}
+
+/*
+ * Finish unmounting a mount hidden by mount_hide_locked(): wait until no
+ * lookup can still reach it and no operation still uses it, then tear it
+ * down. With handles open it is made visible again and -EBUSY returned.
+ */
+static int mount_retire(vfs_mount_entry_t *m, mount_trie_t *old)
+{
+    /* Nobody may be walking a trie that names m once it is freed */
+    vfs_rcu_synchronize();
+    free(old);
+    mount_drain(m);
+
+    pthread_mutex_lock(&g_vfs_lock);
+    /* Open handles call straight into the backend: it has to stay */
+    if (atomic_load_explicit(&m->open_handles, memory_order_acquire) > 0) {
+        m->unmounting = 0;
+        old = mount_trie_publish_locked();
+        pthread_mutex_unlock(&g_vfs_lock);
+        if (old)
+            vfs_rcu_defer_free(old, mount_trie_free);
+        return -EBUSY;
+    }
+    for (vfs_mount_entry_t **cur = &mount_table_head; *cur; cur = &(*cur)->next) {
+        if (*cur == m) {
             *cur = m->next;
             break;
         }
-        cur = &(*cur)->next;
     }
-    pthread_mutex_unlock(&g_vfs_lock);
+    pthread_mutex_unlock(&g_vfs_lock);
+
+    mount_teardown(m);
+    return 0;
+}
+
+int vfs_mount_destroy(vfs_mount_entry_t *m)
+{
+    if (!m)
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_vfs_lock);
+    vfs_mount_entry_t *cur = mount_table_head;
+    while (cur && cur != m)
+        cur = cur->next;
+    if (!cur || m->unmounting) {
+        pthread_mutex_unlock(&g_vfs_lock);
+        return -ENOENT;
+    }
+    mount_trie_t *old = mount_hide_locked(m);
+    pthread_mutex_unlock(&g_vfs_lock);
+
+    return mount_retire(m, old);
+}
+
+/* Longest-prefix match by scanning the list (no trie published) */
+static vfs_mount_entry_t *find_best_mount_slow(const char *path)
+{
+    vfs_mount_entry_t *best = NULL;
+    size_t best_len = 0;
+
+    pthread_mutex_lock(&g_vfs_lock);
+    for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next) {
+        if (m->unmounting)
+            continue;
+        size_t ml = strlen(m->mountpoint);
+
+        if (ml == 1 && m->mountpoint[0] == '/') {
+            /* fallback root mount */
+            if (!best) {
+                best = m;
+                best_len = 1;
+            }
+            continue;
+        }
+
+        if (strncmp(path, m->mountpoint, ml) == 0 &&
+            (path[ml] == '\0' || path[ml] == '/'))
+        {
+            if (ml > best_len) {
+                best = m;
+                best_len = ml;
+            }
+        }
+    }
+    if (best)
+        mount_get(best);
+    pthread_mutex_unlock(&g_vfs_lock);
+
+    return best;
+}
+
+/* Longest-prefix match of a normalized path, pinned: the caller drops the
+ * pin with mount_put() once it no longer uses the mount */
+static vfs_mount_entry_t *find_best_mount(const char *path)
+{
+    vfs_rcu_read_lock();
+    const mount_trie_t *t = atomic_load_explicit(&g_mount_trie, memory_order_acquire);
+    if (!t) {
+        vfs_rcu_read_unlock();
+        return find_best_mount_slow(path);
+    }
+
+    const mount_trie_node_t *node = &t->nodes[0];
+    vfs_mount_entry_t *best = node->mount;
+    vfs_path_iter_t it;
+    const char *name;
+    size_t len;
+
+    vfs_path_iter_init(&it, path);
+    while (vfs_path_iter_next(&it, &name, &len)) {
+        const mount_trie_node_t *c = node->child;
+        while (c && !(c->len == len && memcmp(c->name, name, len) == 0))
+            c = c->sibling;
+        if (!c)
+            break;
+        node = c;
+        if (node->mount)
+            best = node->mount;
+    }
+    if (best)
+        mount_get(best);
+    vfs_rcu_read_unlock();
+    return best;
+}
+
+/* Relative path of a normalized path within its mount.
+ * Returns a pointer into `norm` ("." for the mount root); never allocates.
+ */
+static const char *mount_relpath(const char *norm, const vfs_mount_entry_t *mount)
+{
+    const char *rel = norm;
+    size_t ml = strlen(mount->mountpoint);
+
+    if (ml > 1 && !strncmp(norm, mount->mountpoint, ml))
+        rel = norm + ml;
+
+    while (*rel == '/')
+        rel++;
+    return rel[0] ? rel : ".";
+}
+
+/* -------------------------------------------------------------------------- */
+/* PATH RESOLUTION */
+/* -------------------------------------------------------------------------- */
+
+
+static int negative_expired(const vfs_dentry_t *d)
+{
+    return monotonic_ns() >= d->neg_expires;
+}
+
+/* Unlink an unused d from parent and free it after a grace period. Caller
+ * holds dentry_lock(parent) and is not inside an RCU read-side section. */
+static void dentry_drop_locked(vfs_dentry_t *d)
+{
+    int zero = 0;
+    if (!atomic_compare_exchange_strong(&d->refcount, &zero, DENTRY_DEAD))
+        return;             /* pinned: leave it to its holder */
+    dentry_unlink_locked(d);
+    destroy_dentry_only(d);
+}
+
+/*
+ * Instantiate child `name` of parent with inode (NULL for a negative entry),
+ * replacing a negative entry if one is cached. A positive entry is returned
+ * pinned in *out; if one already existed it is returned (pinned) together
+ * with -EEXIST. Negative entries are never pinned and out may be NULL.
+ * `reclaimable` marks entries the shrinker may evict.
+ */
+static int dentry_instantiate(vfs_dentry_t *parent, const char *name, size_t len,
+                              vfs_inode_t *inode, int reclaimable, vfs_dentry_t **out)
+{
+    dentry_lock(parent);
+    vfs_dentry_t *d = vfs_dcache_lookup(parent, name, len);
+    if (d && d->inode) {
+        dentry_tryget(d);   /* cannot fail: eviction needs the parent lock */
+        dentry_unlock(parent);
+        if (out)
+            *out = d;
+        else
+            vfs_dentry_release(d);
+        return -EEXIST;
+    }
+    if (d)
+        dentry_drop_locked(d);
+
+    d = dentry_alloc(name, len, parent, inode);
+    if (!d) {
+        dentry_unlock(parent);
+        return -ENOMEM;
+    }
+    d->reclaimable = reclaimable;
+    if (inode) {
+        atomic_store(&d->refcount, 1);
+    } else {
+        d->neg_expires = monotonic_ns() + atomic_load(&g_neg_ttl_ns);
+        pthread_mutex_lock(&g_lru.lock);
+        lru_add_locked(d);
+        pthread_mutex_unlock(&g_lru.lock);
+    }
+    dentry_link_locked(parent, d);
+    dentry_unlock(parent);
+
+    if (inode && out)
+        *out = d;
+    return 0;
+}
+
+/*
+ * Cache miss for component name/len of parent: ask the backend whether
+ * base[0 .. name+len) exists and cache the answer, positive or negative.
+ * A positive result is returned pinned.
+ */
+static int lookup_miss(vfs_mount_entry_t *m, vfs_dentry_t *parent, const char *base,
+                       const char *name, size_t len, vfs_dentry_t **out)
+{
+    if (!m->backend_ops || !m->backend_ops->stat)
+        return -ENOENT;     /* in-memory mounts are authoritative */
+
+    char sub[VFS_PATH_MAX];
+    size_t n = (size_t)(name + len - base);
+    memcpy(sub, base, n);
+    sub[n] = '\0';
+
+    struct stat st;
+    int r = m->backend_ops->stat(m->backend_data, sub, &st);
+    atomic_fetch_add_explicit(&g_dcache.backend_lookups, 1, memory_order_relaxed);
+
+    if (r == 0) {
+        vfs_inode_t *ino = itable_get(m, &st);
+        if (!ino)
+            return -ENOMEM;
+        r = dentry_instantiate(parent, name, len, ino, 1, out);
+        vfs_inode_release(ino);
+        if (r == -EEXIST)
+            r = 0;          /* raced with another lookup; use its entry */
+        if (r == 0)
+            dcache_maybe_shrink();
+        return r;
+    }
+
+    if (r == -ENOENT && atomic_load(&g_neg_ttl_ns) > 0) {
+        r = dentry_instantiate(parent, name, len, NULL, 1, out);
+        if (r == -EEXIST)
+            return 0;       /* created concurrently after all */
+        dcache_maybe_shrink();
+        return r < 0 ? r : -ENOENT;
+    }
+    return r;
+}
+
+/*
+ * One locked step of a walk: child name/len of the pinned directory cur,
+ * where base is the relative path the component belongs to. The child is
+ * returned pinned; cur keeps its pin.
+ */
+static int walk_component(vfs_mount_entry_t *m, vfs_dentry_t *cur, const char *base,
+                          const char *name, size_t len, vfs_dentry_t **out)
+{
+    if (!S_ISDIR(cur->inode->mode))
+        return -ENOTDIR;
+
+    dentry_lock(cur);
+    vfs_dentry_t *found = vfs_dcache_lookup(cur, name, len);
+    if (found && !found->inode) {
+        if (!negative_expired(found)) {
+            dentry_unlock(cur);
+            return -ENOENT;
+        }
+        dentry_drop_locked(found);
+        found = NULL;
+    }
+    if (found)
+        dentry_tryget(found);   /* cannot fail under the parent lock */
+    dentry_unlock(cur);
+
+    if (!found)
+        return lookup_miss(m, cur, base, name, len, out);
+    *out = found;
+    return 0;
+}
+
+/*
+ * Walk `rel` (as returned by mount_relpath) below the root of mount m.
+ * The result is pinned; drop it with vfs_dentry_release().
+ */
+static int resolve_in_mount(vfs_mount_entry_t *m, const char *rel, vfs_dentry_t **out)
+{
+    vfs_dentry_t *cur = NULL;
+    const char *base = (rel[0] == '.' && !rel[1]) ? "" : rel;
+    vfs_path_iter_t it;
+    vfs_path_iter_init(&it, base);
+
+    /* Optimistic lockless walk over cached components */
+    if (atomic_load_explicit(&g_dcache.rcu_walk, memory_order_relaxed)) {
+        for (int tries = 0; ; tries++) {
+            vfs_path_iter_t attempt = it;
+            int negative = 0;
+            vfs_rcu_read_lock();
+            vfs_dentry_t *d = dcache_walk_rcu(m->root_dentry, &attempt, &negative);
+            /* pin before leaving the read side; a lost race with the
+             * shrinker is just another retry */
+            if (d && !negative && !dentry_tryget(d))
+                d = NULL;
+            vfs_rcu_read_unlock();
+            if (negative)
+                return -ENOENT;     /* answered from memory */
+            if (d) {
+                cur = d;
+                it = attempt;
+                break;
+            }
+            if (tries + 1 >= DCACHE_RCU_RETRIES) {
+                atomic_fetch_add_explicit(&g_dcache.rcu_fallbacks, 1, memory_order_relaxed);
+                break;
+            }
+            atomic_fetch_add_explicit(&g_dcache.rcu_retries, 1, memory_order_relaxed);
+        }
+    }
+
+    if (!cur) {
+        cur = m->root_dentry;       /* pinned by the mount, never evicted */
+        dentry_tryget(cur);
+        vfs_path_iter_init(&it, base);
+    }
+
+    /* Locked walk for whatever the fast path could not resolve */
+    const char *name;
+    size_t len;
+    while (vfs_path_iter_next(&it, &name, &len)) {
+        vfs_dentry_t *found = NULL;
+        int r = walk_component(m, cur, base, name, len, &found);
+        vfs_dentry_release(cur);
+        if (r != 0)
+            return r;
+        cur = found;
+    }
+
+    *out = cur;
+    return 0;
+}
+
+/* Last component of a relative path */
+static const char *rel_leaf(const char *rel)
+{
+    const char *last = strrchr(rel, '/');
+    return last ? last + 1 : rel;
+}
+
+/*
+ * resolve_in_mount(), or when the caller holds dir, the parent directory
+ * of rel's last component, a single step from there
+ */
+static int resolve_leaf(vfs_mount_entry_t *m, const char *rel, vfs_dentry_t *dir,
+                        vfs_dentry_t **out)
+{
+    if (!dir)
+        return resolve_in_mount(m, rel, out);
+    const char *leaf = rel_leaf(rel);
+    return walk_component(m, dir, rel, leaf, strlen(leaf), out);
+}
+
+/* Drop a cached negative entry for leaf in the pinned directory dir */
+static void dentry_forget_negative(vfs_dentry_t *dir, const char *leaf)
+{
+    dentry_lock(dir);
+    vfs_dentry_t *d = vfs_dcache_lookup(dir, leaf, strlen(leaf));
+    if (d && !d->inode)
+        dentry_drop_locked(d);
+    dentry_unlock(dir);
+}
+
+/* The backend just created rel: forget a cached "does not exist" for it */
+static void dcache_forget_negative(vfs_mount_entry_t *m, const char *rel)
+{
+    const char *leaf = rel_leaf(rel);
+    vfs_dentry_t *dir = m->root_dentry;
+    vfs_path_iter_t it;
+    const char *name;
+    size_t len;
+
+    dentry_tryget(dir);
+    vfs_path_iter_init(&it, rel);
+    while (vfs_path_iter_next(&it, &name, &len) && name < leaf) {
+        dentry_lock(dir);
+        vfs_dentry_t *next = vfs_dcache_lookup(dir, name, len);
+        if (next && next->inode)
+            dentry_tryget(next);
+        else
+            next = NULL;
+        dentry_unlock(dir);
+        vfs_dentry_release(dir);
+        if (!next)
+            return;         /* parent not cached: nothing to forget */
+        dir = next;
+    }
+
+    dentry_forget_negative(dir, leaf);
+    vfs_dentry_release(dir);
+}
+
+/*
+ * Create `norm` (normalized, inside mount m) as a new in-memory node with
+ * the given mode. Fails with -EEXIST if it already exists; the new (or
+ * existing) dentry is returned pinned either way.
+ */
+static int create_in_mount(vfs_mount_entry_t *m, const char *norm, mode_t mode,
+                           vfs_dentry_t **out)
+{
+    const char *leaf = strrchr(norm, '/') + 1;
+    if (!*leaf)
+        return -EEXIST;     /* "/" always exists */
+
+    char parent_path[VFS_PATH_MAX];
+    size_t plen = (size_t)(leaf - norm - 1);
+    memcpy(parent_path, norm, plen ? plen : 1);
+    parent_path[plen ? plen : 1] = '\0';
+
+    vfs_dentry_t *parent = NULL;
+    int r;
+    if (strlen(parent_path) < strlen(m->mountpoint))
+        return -EEXIST;     /* leaf is the mountpoint itself */
+    r = resolve_in_mount(m, mount_relpath(parent_path, m), &parent);
+    if (r != 0)
+        return r;
+    if (!S_ISDIR(parent->inode->mode)) {
+        vfs_dentry_release(parent);
+        return -ENOTDIR;
+    }
+
+    vfs_inode_t *ino = vfs_inode_create(ino_alloc(), mode, 0, 0, 0);
+    if (!ino) {
+        vfs_dentry_release(parent);
+        return -ENOMEM;
+    }
+    r = dentry_instantiate(parent, leaf, strlen(leaf), ino, 0, out);
+    vfs_inode_release(ino);
+    vfs_dentry_release(parent);
+    return r;
+}
+
+/* vfs_resolve_path() that keeps the result and its mount pinned */
+static int resolve_pinned(const char *path, vfs_dentry_t **out, vfs_mount_entry_t **mount)
+{
+    if (!path || !out)
+        return -EINVAL;
+
+    if (!g_vfs_inited)
+        return -EIO;
+
+    char norm[VFS_PATH_MAX];
+    if (vfs_path_normalize(path, norm, sizeof(norm)) < 0)
+        return -EINVAL;
+
+    vfs_mount_entry_t *m = find_best_mount(norm);
+    if (!m)
+        return -ENOENT;
+
+    int ret = resolve_in_mount(m, mount_relpath(norm, m), out);
+    if (ret != 0)
+        mount_put(m);
+    else
+        *mount = m;
+    return ret;
+}
+
+int vfs_resolve_path(const char *path, vfs_dentry_t **out)
+{
+    vfs_dentry_t *d = NULL;
+    vfs_mount_entry_t *m;
+    int ret = resolve_pinned(path, &d, &m);
+    if (ret != 0)
+        return ret;
+    vfs_dentry_release(d);
+    mount_put(m);
+    *out = d;
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* PERMISSION CHECKS                                                           */
+/* -------------------------------------------------------------------------- */
+
+static int check_inode_perm(const vfs_inode_t *ino, uid_t req_uid, gid_t req_gid, int mask)
+{
+    if (!ino) return -ENOENT;
+
+    /* Determine applicable class */
+    int have_r = 0, have_w = 0, have_x = 0;
+
+    if (req_uid == 0) {
+        have_r = 1;
+        have_w = 1;
+        have_x = ((ino->mode & (S_IXUSR|S_IXGRP|S_IXOTH)) != 0);
+    } else if (req_uid == ino->uid) {
+        have_r = (ino->mode & S_IRUSR) != 0;
+        have_w = (ino->mode & S_IWUSR) != 0;
+        have_x = (ino->mode & S_IXUSR) != 0;
+    } else if (req_gid == ino->gid) {
+        have_r = (ino->mode & S_IRGRP) != 0;
+        have_w = (ino->mode & S_IWGRP) != 0;
+        have_x = (ino->mode & S_IXGRP) != 0;
+    } else {
+        have_r = (ino->mode & S_IROTH) != 0;
+        have_w = (ino->mode & S_IWOTH) != 0;
+        have_x = (ino->mode & S_IXOTH) != 0;
+    }
+
+    int need_r = (mask & R_OK) ? 1 : 0;
+    int need_w = (mask & W_OK) ? 1 : 0;
+    int need_x = (mask & X_OK) ? 1 : 0;
+
+    if (need_r && !have_r) return -EACCES;
+    if (need_w && !have_w) return -EACCES;
+    if (need_x && !have_x) return -EACCES;
+    return 0;
+}
+
+int vfs_permission_check(const char *path, uid_t uid, gid_t gid, int mask)
+{
+    if (!path) return -EINVAL;
+    vfs_dentry_t *d = NULL;
+    vfs_mount_entry_t *m;
+    int ret = resolve_pinned(path, &d, &m);
+    if (ret != 0) return ret;
+    ret = d ? check_inode_perm(d->inode, uid, gid, mask) : -ENOENT;
+    if (d) vfs_dentry_release(d);
+    mount_put(m);
+    return ret;
+}
+/* INIT + SHUTDOWN */
+/* -------------------------------------------------------------------------- */
+
+int vfs_init(void)
+{
+    pthread_mutex_lock(&g_vfs_lock);
+    if (g_vfs_inited) {
+        pthread_mutex_unlock(&g_vfs_lock);
+        return 0;
+    }
+    g_vfs_inited = 1;
+    pthread_mutex_unlock(&g_vfs_lock);
+
+    /* Register POSIX backend */
+    extern const vfs_backend_ops_t *get_posix_backend_ops(void);
+    const vfs_backend_ops_t *posix_ops = get_posix_backend_ops();
+    if (posix_ops) {
+        int ret = vfs_register_backend(posix_ops);
+        if (ret < 0 && ret != -EEXIST) {
+            fprintf(stderr, "vfs_init: failed to register posix backend: %d\n", ret);
+        } else {
+            fprintf(stderr, "[vfs_init] POSIX backend registered successfully\n");
+        }
+    }
+
+    /* Same layout as posix, I/O through io_uring (plain syscalls without it) */
+    extern const vfs_backend_ops_t *get_posix_uring_backend_ops(void);
+    int ret = vfs_register_backend(get_posix_uring_backend_ops());
+    if (ret < 0 && ret != -EEXIST)
+        fprintf(stderr, "vfs_init: failed to register posix_uring backend: %d\n", ret);
+
+    /* Create default mount + sample tree */
+    vfs_mount_entry_t *rootm = vfs_mount_create("/", ".");
+    if (!rootm)
+        return -ENOMEM;
+
+    /* Some populated sample entries */
+    uint64_t ino;
+
+    ino = ino_alloc();
+    vfs_inode_t *d1i = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
+    vfs_dentry_t *d1 = vfs_dentry_create("dir1", rootm->root_dentry, d1i);
+    vfs_inode_release(d1i);
+    vfs_dentry_add_child(rootm->root_dentry, d1);
+
+    ino = ino_alloc();
+    vfs_inode_t *d2i = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
+    vfs_dentry_t *d2 = vfs_dentry_create("dir2", d1, d2i);
+    vfs_inode_release(d2i);
+    vfs_dentry_add_child(d1, d2);
+
+    ino = ino_alloc();
+    vfs_inode_t *fi = vfs_inode_create(ino, S_IFREG | 0644, 0, 0, 0);
+    vfs_dentry_t *f = vfs_dentry_create("file", d2, fi);
+    vfs_inode_release(fi);
+    vfs_dentry_add_child(d2, f);
+
+    ino = ino_alloc();
+    vfs_inode_t *d3i = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
+    vfs_dentry_t *d3 = vfs_dentry_create("dir3", d1, d3i);
+    vfs_inode_release(d3i);
+    vfs_dentry_add_child(d1, d3);
+
+    ino = ino_alloc();
+    vfs_inode_t *f2i = vfs_inode_create(ino, S_IFREG | 0644, 0, 0, 0);
+    vfs_dentry_t *f2 = vfs_dentry_create("file2", d3, f2i);
+    vfs_inode_release(f2i);
+    vfs_dentry_add_child(d3, f2);
+
+    return 0;
+}
+
+static void aio_stop_workers(void);
+
+int vfs_shutdown(void)
+{
+    /* Requests in flight still use handles and mounts */
+    vfs_async_drain();
+    aio_stop_workers();
+
+    pthread_mutex_lock(&g_vfs_lock);
+
+    if (!g_vfs_inited) {
+        pthread_mutex_unlock(&g_vfs_lock);
+        return 0;
+    }
+
+    g_vfs_inited = 0;
+
+    /* Clean up file handle table (drops pins before the trees go away) */
+    fh_close_all();
+
+    /* No trie at all: late lookups take the (now empty) list scan */
+    mount_trie_t *old = atomic_exchange(&g_mount_trie, NULL);
+    vfs_mount_entry_t *mounts = mount_table_head;
+    mount_table_head = NULL;
+    pthread_mutex_unlock(&g_vfs_lock);
+
+    vfs_rcu_synchronize();
+    free(old);
+
+    /* Operations that found a mount before it went finish with it first */
+    while (mounts) {
+        vfs_mount_entry_t *m = mounts;
+        mounts = m->next;
+        mount_drain(m);
+        mount_teardown(m);
+    }
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Public API stubs (shim implementations)                                      */
+/* These return -ENOSYS for now so other layers can compile and link.         */
+/* -------------------------------------------------------------------------- */
+
+static int access_covers(int have, int want)
+{
+    return (have & O_ACCMODE) == O_RDWR || (have & O_ACCMODE) == (want & O_ACCMODE);
+}
+
+/* Open-file-status flags that change how every transfer on a handle
+ * behaves; opens may only share a backend handle if these match */
+#define HANDLE_STATUS_FLAGS (O_APPEND | O_SYNC | O_DSYNC | O_DIRECT | O_NOATIME)
+
+static int status_matches(int have, int want)
+{
+    return (have & HANDLE_STATUS_FLAGS) == (want & HANDLE_STATUS_FLAGS);
+}
+
+/*
+ * Find the backend handle an open with `flags` uses: the inode's shared
+ * one, or, when its status flags differ from those of the handle the
+ * inode already shares, one of its own (*own set; closed with the file
+ * handle). `fresh` is a handle the caller already opened with flags (the
+ * O_CREAT path) or NULL. A shared handle with too narrow an access mode
+ * is replaced by an O_RDWR one; the old handle may still be in use by a
+ * concurrent read/write, so it is parked and only closed together with
+ * the inode.
+ */
+static int inode_bind_handle(vfs_mount_entry_t *m, vfs_inode_t *ino,
+                             const char *relpath, int flags, void *fresh,
+                             void **out, int *own)
+{
+    const vfs_backend_ops_t *ops = m->backend_ops;
+    int ret;
+
+    *own = 0;
+    /* Truncation is a side effect of open(2): always perform it */
+    if (!fresh && (flags & O_TRUNC)) {
+        ret = ops->open(m->backend_data, relpath, flags & ~(O_CREAT | O_EXCL), &fresh);
+        if (ret < 0)
+            return ret;
+    }
+    if (flags & (O_TRUNC | O_CREAT)) {
+        inode_lock(ino);
+        ino->attr_expires = 0;
+        inode_unlock(ino);
+    }
+
+    inode_lock(ino);
+    int have = ino->backend_handle ? ino->backend_flags : -1;
+    void *shared = ino->backend_handle;
+    inode_unlock(ino);
+
+    if (have >= 0 && !status_matches(have, flags)) {
+        if (!fresh) {
+            ret = ops->open(m->backend_data, relpath,
+                            flags & ~(O_CREAT | O_EXCL | O_TRUNC), &fresh);
+            if (ret < 0)
+                return ret;
+        }
+        *out = fresh;
+        *own = 1;
+        return 0;
+    }
+    if (have >= 0 && access_covers(have, flags)) {
+        if (fresh && ops->close)
+            ops->close(m->backend_data, fresh);
+        *out = shared;
+        return 0;
+    }
+
+    /* Needed mode: ours, or read/write if another mode is already in use */
+    int acc = (have >= 0) ? O_RDWR : (flags & O_ACCMODE);
+    if (fresh && !access_covers(flags, acc)) {
+        if (ops->close)
+            ops->close(m->backend_data, fresh);
+        fresh = NULL;
+    }
+    if (!fresh) {
+        int oflags = (flags & ~(O_ACCMODE | O_CREAT | O_EXCL | O_TRUNC)) | acc;
+        ret = ops->open(m->backend_data, relpath, oflags, &fresh);
+        if (ret < 0)
+            return ret;
+    } else {
+        acc = flags & O_ACCMODE;
+    }
+
+    inode_lock(ino);
+    if (ino->backend_handle && !status_matches(ino->backend_flags, flags)) {
+        /* a concurrent open installed a handle for other status flags */
+        inode_unlock(ino);
+        *out = fresh;
+        *own = 1;
+        return 0;
+    }
+    if (ino->backend_handle && access_covers(ino->backend_flags, acc)) {
+        /* a concurrent open installed a good enough handle first */
+        *out = ino->backend_handle;
+        inode_unlock(ino);
+        if (ops->close)
+            ops->close(m->backend_data, fresh);
+        return 0;
+    }
+    if (ino->backend_handle) {
+        vfs_retired_handle_t *r = malloc(sizeof(*r));
+        if (!r) {
+            inode_unlock(ino);
+            if (ops->close)
+                ops->close(m->backend_data, fresh);
+            return -ENOMEM;
+        }
+        r->handle = ino->backend_handle;
+        r->next = ino->retired;
+        ino->retired = r;
+    }
+    ino->backend_handle = fresh;
+    ino->backend_flags = acc | (flags & HANDLE_STATUS_FLAGS);
+    inode_unlock(ino);
+    *out = fresh;
+    return 0;
+}
+
+/*
+ * vfs_open() of norm, inside mount. dir, if not NULL, is the pinned parent
+ * directory of norm's last component (vfs_submit_batch keeps one).
+ */
+static int open_in_mount(vfs_mount_entry_t *mount, const char *norm, int flags,
+                         vfs_dentry_t *dir)
+{
+    const char *relpath = mount_relpath(norm, mount);
+
+    /* Check if mount has backend - for O_CREAT, dispatch directly to backend */
+    if (mount->backend_ops && mount->backend_ops->open && (flags & O_CREAT)) {
+        /* Create through the backend, then look the result up like any
+         * other file so it joins the dcache and the inode table */
+        void *backend_handle = NULL;
+        int ret = mount->backend_ops->open(mount->backend_data, relpath, flags, &backend_handle);
+        if (ret < 0) return ret;
+        if (dir)
+            dentry_forget_negative(dir, rel_leaf(relpath));
+        else
+            dcache_forget_negative(mount, relpath);
+
+        vfs_dentry_t *d = NULL;
+        ret = resolve_leaf(mount, relpath, dir, &d);
+        if (ret == 0 && S_ISDIR(d->inode->mode)) {
+            vfs_dentry_release(d);
+            ret = -EISDIR;
+        }
+        if (ret != 0) {
+            if (mount->backend_ops->close)
+                mount->backend_ops->close(mount->backend_data, backend_handle);
+            return ret;
+        }
+        int own;
+        ret = inode_bind_handle(mount, d->inode, relpath, flags, backend_handle,
+                                &backend_handle, &own);
+        if (ret < 0) {
+            vfs_dentry_release(d);
+            return ret;
+        }
+
+        /* allocate a handle; it takes over our pin on d */
+        int fh = fh_alloc(d, flags, mount, backend_handle, own);
+        if (fh < 0) {
+            if (own && mount->backend_ops->close)
+                mount->backend_ops->close(mount->backend_data, backend_handle);
+            vfs_dentry_release(d);
+        }
+        return fh;
+    }
+
+    /* In-memory mount: O_CREAT makes a regular file node */
+    if (flags & O_CREAT) {
+        vfs_dentry_t *nd = NULL;
+        int ret = create_in_mount(mount, norm, S_IFREG | 0644, &nd);
+        if (nd)
+            vfs_dentry_release(nd);
+        if (ret == -EEXIST && (flags & O_EXCL))
+            return -EEXIST;
+        if (ret != 0 && ret != -EEXIST)
+            return ret;
+    }
+
+    /* Normal path: resolve and open existing file */
+    vfs_dentry_t *d = NULL;
+    int ret = resolve_leaf(mount, relpath, dir, &d);
+    if (ret != 0 || !d)
+        return ret ? ret : -ENOENT;
+
+    /* Directories cannot be opened for read/write as files */
+    if (d->inode && S_ISDIR(d->inode->mode)) {
+        vfs_dentry_release(d);
+        return -EISDIR;
+    }
+
+    /* permission check: the handle keeps this decision for its lifetime */
+    int perm = check_inode_perm(d->inode, 0, 0, open_access(flags)); /* uid=0/gid=0 default */
+    if (perm != 0) {
+        vfs_dentry_release(d);
+        return perm;
+    }
+
+    /* For existing files with backend, get backend handle */
+    void *handle = NULL;
+    int own = 0;
+    if (mount->backend_ops && mount->backend_ops->open) {
+        ret = inode_bind_handle(mount, d->inode, relpath, flags, NULL, &handle, &own);
+        if (ret < 0) {
+            vfs_dentry_release(d);
+            return ret;
+        }
+    }
+
+    /* allocate a handle; it takes over our pin on d */
+    int fh = fh_alloc(d, flags, mount, handle, own);
+    if (fh < 0) {
+        if (own && mount->backend_ops->close)
+            mount->backend_ops->close(mount->backend_data, handle);
+        vfs_dentry_release(d);
+    }
+
+    return fh;
+}
+
+int vfs_open(const char *path, int flags)
+{
+    if (!path)
+        return -EINVAL;
+
+    if (!g_vfs_inited)
+        return -EIO;
+
+    char norm[VFS_PATH_MAX];
+    if (vfs_path_normalize(path, norm, sizeof(norm)) < 0)
+        return -EINVAL;
+
+    vfs_mount_entry_t *mount = find_best_mount(norm);
+    if (!mount)
+        return -ENOENT;
+    int ret = open_in_mount(mount, norm, flags, NULL);
+    mount_put(mount);
+    return ret;
+}
+
+int vfs_close(int fh)
+{
+    return fh_free(fh);
+}
+
+ssize_t vfs_read(int fh, void *buf, size_t count, off_t offset)
+{
+    if (!buf)
+        return -EINVAL;
+
+    /* Access was checked at open; directories cannot be opened */
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !(e->access & R_OK))
+        return -EBADF;
+
+    /* Backend file: straight to the mount the handle was opened on */
+    if (e->backend_handle) {
+        const vfs_mount_entry_t *m = e->mount;
+        if (!m->backend_ops->read)
+            return -EINVAL;
+        return m->backend_ops->read(m->backend_data, e->backend_handle,
+                                    buf, count, offset);
+    }
+
+    /* Fallback: simple zero-filled content model */
+    vfs_dentry_t *d = e->dentry;
+    inode_lock(d->inode);
+    off_t size = d->inode->size;
+    inode_unlock(d->inode);
+    if (offset >= size)
+        return 0;
+
+    size_t avail = (size - offset) > 0 ? (size - offset) : 0;
+    size_t n = (count < avail) ? count : avail;
+    memset(buf, 0, n);
+    return (ssize_t)n;
+}
+
+/* A backend write of `written` bytes at offset went through: update the
+ * size; size and times changed behind the attribute cache */
+static void inode_note_write(vfs_inode_t *ino, off_t offset, ssize_t written)
+{
+    if (written <= 0)
+        return;
+    off_t new_size = offset + written;
+    inode_lock(ino);
+    if (new_size > ino->size)
+        ino->size = new_size;
+    ino->attr_expires = 0;
+    inode_unlock(ino);
+}
+
+ssize_t vfs_write(int fh, const void *buf, size_t count, off_t offset)
+{
+    if (!buf)
+        return -EINVAL;
+
+    /* Access was checked at open; directories cannot be opened */
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !(e->access & W_OK))
+        return -EBADF;
+
+    vfs_dentry_t *d = e->dentry;
+
+    /* Backend file: straight to the mount the handle was opened on */
+    if (e->backend_handle) {
+        const vfs_mount_entry_t *m = e->mount;
+        if (!m->backend_ops->write)
+            return -EINVAL;
+        ssize_t written = m->backend_ops->write(m->backend_data, e->backend_handle,
+                                                buf, count, offset);
+        inode_note_write(d->inode, offset, written);
+        return written;
+    }
+
+    /* Fallback: Grow file size to simulate write; concurrent writers
+     * serialize on the inode lock, as backend writes do */
+    off_t end = offset + (off_t)count;
+    inode_lock(d->inode);
+    if (end > d->inode->size)
+        d->inode->size = end;
+    inode_unlock(d->inode);
+
+    /* We don't store content; pretend we wrote all bytes */
+    return (ssize_t)count;
+}
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024            /* Linux UIO_MAXIOV */
+#endif
+
+/* Backends without a vectored op: one call per buffer, stopping at the
+ * first short transfer or error */
+static ssize_t iov_fallback(int fh, const struct iovec *iov, int iovcnt,
+                            off_t offset, int is_write)
+{
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        ssize_t r = is_write
+            ? vfs_write(fh, iov[i].iov_base, iov[i].iov_len, offset + total)
+            : vfs_read(fh, iov[i].iov_base, iov[i].iov_len, offset + total);
+        if (r < 0)
+            return total ? total : r;
+        total += r;
+        if ((size_t)r < iov[i].iov_len)
+            break;
+    }
+    return total;
+}
+
+ssize_t vfs_readv(int fh, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    if ((!iov && iovcnt) || iovcnt < 0 || iovcnt > IOV_MAX)
+        return -EINVAL;
+
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !(e->access & R_OK))
+        return -EBADF;
+
+    if (e->backend_handle && e->mount->backend_ops->readv)
+        return e->mount->backend_ops->readv(e->mount->backend_data, e->backend_handle,
+                                            iov, iovcnt, offset);
+    return iov_fallback(fh, iov, iovcnt, offset, 0);
+}
+
+ssize_t vfs_writev(int fh, const struct iovec *iov, int iovcnt, off_t offset)
+{
+    if ((!iov && iovcnt) || iovcnt < 0 || iovcnt > IOV_MAX)
+        return -EINVAL;
+
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !(e->access & W_OK))
+        return -EBADF;
+
+    if (e->backend_handle && e->mount->backend_ops->writev) {
+        ssize_t written = e->mount->backend_ops->writev(e->mount->backend_data,
+                                                        e->backend_handle,
+                                                        iov, iovcnt, offset);
+        inode_note_write(e->dentry->inode, offset, written);
+        return written;
+    }
+    return iov_fallback(fh, iov, iovcnt, offset, 1);
+}
+
+int vfs_fsync(int fh, int datasync)
+{
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e)
+        return -EBADF;
+
+    /* In-memory files and backends without fsync have nothing to flush */
+    if (!e->backend_handle || !e->mount->backend_ops->fsync)
+        return 0;
+    return e->mount->backend_ops->fsync(e->mount->backend_data, e->backend_handle, datasync);
+}
+
+int vfs_get_fd(int fh, int access)
+{
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !access || (access & ~(R_OK | W_OK)) || (e->access & access) != access)
+        return -EBADF;
+    if (!e->backend_handle || !e->mount->backend_ops->get_fd)
+        return -EOPNOTSUPP;
+    return e->mount->backend_ops->get_fd(e->mount->backend_data, e->backend_handle);
+}
+
+void vfs_fd_written(int fh, off_t offset, ssize_t written)
+{
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (e && e->backend_handle)
+        inode_note_write(e->dentry->inode, offset, written);
+}
+
+void vfs_fd_read(int fh, off_t offset, size_t count)
+{
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (e && e->backend_handle && e->mount->backend_ops->note_read)
+        e->mount->backend_ops->note_read(e->mount->backend_data, e->backend_handle,
+                                         offset, count);
+}
+
+/* ---- Server-side copy ---- */
+
+#define COPY_CHUNK (256 * 1024)
+
+/* Copy through a bounce buffer, for in-memory files, pairs on different
+ * mounts and backends that cannot copy the range themselves */
+static ssize_t copy_by_hand(int fh_in, off_t off_in, int fh_out, off_t off_out, size_t len)
+{
+    size_t chunk = len < COPY_CHUNK ? len : COPY_CHUNK;
+    char *buf = malloc(chunk);
+    if (!buf)
+        return -ENOMEM;
+
+    size_t done = 0;
+    ssize_t err = 0;
+    while (done < len) {
+        size_t want = len - done < chunk ? len - done : chunk;
+        ssize_t r = vfs_read(fh_in, buf, want, off_in + (off_t)done);
+        if (r <= 0) {
+            err = r;
+            break;
+        }
+        ssize_t w = vfs_write(fh_out, buf, (size_t)r, off_out + (off_t)done);
+        if (w < 0) {
+            err = w;
+            break;
+        }
+        done += (size_t)w;
+        if (w < r || (size_t)r < want)
+            break;
+    }
+    free(buf);
+    return done ? (ssize_t)done : err;
+}
 
-    /* Shutdown backend if present */
-    if (m->backend_ops && m->backend_ops->shutdown && m->backend_data) {
-        m->backend_ops->shutdown(m->backend_data);
-    }
+ssize_t vfs_copy_range(int fh_in, off_t off_in, int fh_out, off_t off_out, size_t len,
+                       int flags)
+{
+    if (flags || off_in < 0 || off_out < 0)
+        return -EINVAL;
+    vfs_fh_entry_t *in = fh_get(fh_in), *out = fh_get(fh_out);
+    if (!in || !(in->access & R_OK) || !out || !(out->access & W_OK))
+        return -EBADF;
+    if (len > SSIZE_MAX)
+        len = SSIZE_MAX;
+    if (off_in > LLONG_MAX - (off_t)len || off_out > LLONG_MAX - (off_t)len)
+        return -EOVERFLOW;
+    /* as copy_file_range(2): no overlapping ranges within one file */
+    if (in->dentry->inode == out->dentry->inode &&
+        off_in < off_out + (off_t)len && off_out < off_in + (off_t)len)
+        return -EINVAL;
+    if (len == 0)
+        return 0;
 
-    vfs_dentry_destroy_tree(m->root_dentry);
-    free(m->mountpoint);
-    free(m->backend_root);
-    free(m);
-    return 0;
+    const vfs_backend_ops_t *ops = in->mount->backend_ops;
+    if (in->backend_handle && out->backend_handle && in->mount == out->mount &&
+        ops->copy_range) {
+        ssize_t n = ops->copy_range(in->mount->backend_data, in->backend_handle, off_in,
+                                    out->backend_handle, off_out, len);
+        if (n >= 0)
+            inode_note_write(out->dentry->inode, off_out, n);
+        if (n != -EOPNOTSUPP && n != -EXDEV)
+            return n;
+    }
+    return copy_by_hand(fh_in, off_in, fh_out, off_out, len);
 }
 
-/* Longest-prefix match */
-static vfs_mount_entry_t *find_best_mount(const char *path)
+/* vfs_stat() of norm, inside mount; dir as for open_in_mount() */
+static int stat_in_mount(vfs_mount_entry_t *mount, const char *norm, struct stat *st,
+                         vfs_dentry_t *dir)
 {
-    vfs_mount_entry_t *best = NULL;
-    size_t best_len = 0;
+    const char *relpath = mount_relpath(norm, mount);
 
-    pthread_mutex_lock(&g_vfs_lock);
-    for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next) {
-        size_t ml = strlen(m->mountpoint);
+    /* Resolve through the dcache first: cached misses never reach the backend */
+    vfs_dentry_t *d = NULL;
+    int ret = resolve_leaf(mount, relpath, dir, &d);
+    if (ret != 0 || !d)
+        return ret ? ret : -ENOENT;
 
-        if (ml == 1 && m->mountpoint[0] == '/') {
-            /* fallback root mount */
-            if (!best) {
-                best = m;
-                best_len = 1;
-            }
-            continue;
-        }
+    vfs_inode_t *ino = d->inode;
 
-        if (strncmp(path, m->mountpoint, ml) == 0 &&
-            (path[ml] == '\0' || path[ml] == '/'))
-        {
-            if (ml > best_len) {
-                best = m;
-                best_len = ml;
+    /* Attributes cached by a recent lookup or stat of the same backend inode */
+    inode_lock(ino);
+    if (ino->attr_expires && atomic_load(&g_attr_ttl_ns) &&
+        monotonic_ns() < ino->attr_expires) {
+        inode_get_attr_locked(ino, st);
+        inode_unlock(ino);
+        vfs_dentry_release(d);
+        return 0;
+    }
+    inode_unlock(ino);
+
+    /* Check if backend can provide fresh attributes */
+    if (mount->backend_ops && mount->backend_ops->stat) {
+        ret = mount->backend_ops->stat(mount->backend_data, relpath, st);
+        if (ret == 0 || ret == -ENOENT) {
+            if (ret == 0) {
+                if (ino->mount) {
+                    inode_lock(ino);
+                    inode_set_attr_locked(ino, st);
+                    inode_unlock(ino);
+                }
+                st->st_ino = ino->ino;          /* the VFS number, not the host's */
             }
+            vfs_dentry_release(d);
+            return ret;
         }
+        /* If backend fails otherwise, fall through to in-memory */
     }
-    pthread_mutex_unlock(&g_vfs_lock);
-
-    return best;
-}
 
-/* Calculate relative path within mount 
- * Returns newly allocated string or NULL on error 
- * Caller must free the returned string.
- */
-static char *get_relpath_for_mount(const char *full_path, vfs_mount_entry_t *mount) {
-    if (!full_path || !mount || !mount->mountpoint) return NULL;
-    
-    const char *mp = mount->mountpoint;
-    size_t mp_len = strlen(mp);
-    
-    /* Root mount special case */
-    if (strcmp(mp, "/") == 0) {
-        /* Skip leading slash */
-        const char *rel = (full_path[0] == '/' && full_path[1]) ? full_path + 1 : full_path;
-        return strdup(rel[0] ? rel : ".");
-    }
-    
-    /* Check if path starts with mountpoint */
-    if (strncmp(full_path, mp, mp_len) != 0) {
-        return NULL;
-    }
-    
-    /* Extract relative part */
-    const char *rel = full_path + mp_len;
-    while (*rel == '/') rel++; /* skip separator */
-    
-    return strdup(rel[0] ? rel : ".");
+    /* Fallback: in-memory stat */
+    memset(st, 0, sizeof(*st));
+    inode_lock(d->inode);
+    st->st_mode = d->inode->mode;
+    st->st_size = d->inode->size;
+    st->st_uid = d->inode->uid;
+    st->st_gid = d->inode->gid;
+    inode_unlock(d->inode);
+    st->st_ino = d->inode->ino;
+    vfs_dentry_release(d);
+    return 0;
 }
 
-/* -------------------------------------------------------------------------- */
-/* PATH RESOLUTION */
-/* -------------------------------------------------------------------------- */
-
-int vfs_resolve_path(const char *path, vfs_dentry_t **out)
+int vfs_stat(const char *path, struct stat *st)
 {
-    if (!path || !out)
+    if (!path || !st)
         return -EINVAL;
 
     if (!g_vfs_inited)
         return -EIO;
 
-    char *norm = normalize_path_alloc(path);
-    if (!norm)
+    /* Hot path: normalized into a stack buffer, no heap traffic */
+    char norm[VFS_PATH_MAX];
+    if (vfs_path_normalize(path, norm, sizeof(norm)) < 0)
         return -EINVAL;
 
-    vfs_mount_entry_t *m = find_best_mount(norm);
-    if (!m) {
-        free(norm);
+    vfs_mount_entry_t *mount = find_best_mount(norm);
+    if (!mount)
         return -ENOENT;
-    }
+    int ret = stat_in_mount(mount, norm, st, NULL);
+    mount_put(mount);
+    return ret;
+}
 
-    /* Direct hit: mount root */
-    if (!strcmp(norm, "/") || !strcmp(norm, m->mountpoint)) {
-        *out = m->root_dentry;
-        free(norm);
-        return 0;
-    }
+/* -------------------------------------------------------------------------- */
+/* DIRECTORY STREAMS */
+/* -------------------------------------------------------------------------- */
 
-    const char *rel = norm;
-    size_t ml = strlen(m->mountpoint);
+/*
+ * A backend directory is the backend's own stream, and its cookies are
+ * the backend's. An in-memory directory is listed from a snapshot of its
+ * children taken at open, and the cookie of entry i is i + 1; children
+ * come and go at the head of the sibling list, so positions in the live
+ * list would not stay put.
+ */
+typedef struct vfs_mem_dirent {
+    uint64_t ino;
+    mode_t mode;                    /* file type bits */
+    char *name;
+} vfs_mem_dirent_t;
+
+typedef struct vfs_dir_stream {
+    void *backend_dir;              /* NULL: the snapshot below */
+    size_t n;
+    vfs_mem_dirent_t ents[];
+} vfs_dir_stream_t;
 
-    if (ml > 1 && !strncmp(norm, m->mountpoint, ml)) {
-        rel = (norm[ml] == '/') ? norm + ml + 1 : norm + ml;
-    } else if (norm[0] == '/') {
-        rel = norm + 1;
+/* FUSE3 filler: int (*)(void *buf, const char *name, const struct stat *st, off_t off, enum flags) */
+typedef int (*fill_fn_t)(void *, const char *, const struct stat *, off_t, int);
+
+static void dir_stream_free(vfs_mount_entry_t *m, vfs_dir_stream_t *s)
+{
+    if (s->backend_dir) {
+        if (m->backend_ops->releasedir)
+            m->backend_ops->releasedir(m->backend_data, s->backend_dir);
+    } else {
+        for (size_t i = 0; i < s->n; i++)
+            free(s->ents[i].name);
     }
+    free(s);
+}
 
-    char *tmp = strdup(rel);
-    if (!tmp) {
-        free(norm);
+static int snap_add(vfs_dir_stream_t *s, const char *name, const vfs_inode_t *ino)
+{
+    vfs_mem_dirent_t *de = &s->ents[s->n];
+    de->name = strdup(name);
+    if (!de->name)
         return -ENOMEM;
+    de->ino = ino->ino;
+    de->mode = ino->mode & S_IFMT;
+    s->n++;
+    return 0;
+}
+
+/* Snapshot of d's entries, "." and ".." first */
+static int dir_snapshot(vfs_dentry_t *d, vfs_dir_stream_t **out)
+{
+    dentry_lock(d);
+    size_t n = 2;
+    for (vfs_dentry_t *c = d->child; c; c = c->sibling)
+        n += c->inode != NULL;      /* skip negative entries */
+
+    vfs_dir_stream_t *s = malloc(sizeof(*s) + n * sizeof(s->ents[0]));
+    int ret = s ? 0 : -ENOMEM;
+    if (s) {
+        s->backend_dir = NULL;
+        s->n = 0;
+        ret = snap_add(s, ".", d->inode);
+        if (ret == 0)
+            ret = snap_add(s, "..", d->parent ? d->parent->inode : d->inode);
+        for (vfs_dentry_t *c = d->child; c && ret == 0; c = c->sibling)
+            if (c->inode)
+                ret = snap_add(s, c->name, c->inode);
     }
+    dentry_unlock(d);
 
-    vfs_dentry_t *cur = m->root_dentry;
+    if (ret != 0) {
+        if (s) {
+            for (size_t i = 0; i < s->n; i++)
+                free(s->ents[i].name);
+            free(s);
+        }
+        return ret;
+    }
+    *out = s;
+    return 0;
+}
 
-    char *save = NULL;
-    char *tok = strtok_r(tmp, "/", &save);
+/*
+ * Open relpath in m as a stream. d, the directory's pinned dentry, is
+ * only needed (and only looked at) for in-memory mounts.
+ */
+static int dir_stream_open(vfs_mount_entry_t *m, const char *relpath, vfs_dentry_t *d,
+                           vfs_dir_stream_t **out)
+{
+    if (!m->backend_ops || !m->backend_ops->opendir)
+        return dir_snapshot(d, out);
 
-    while (tok) {
-        vfs_dentry_t *found = NULL;
+    vfs_dir_stream_t *s = malloc(sizeof(*s));
+    if (!s)
+        return -ENOMEM;
+    s->n = 0;
+    s->backend_dir = NULL;
+    int ret = m->backend_ops->opendir(m->backend_data, relpath, &s->backend_dir);
+    if (ret < 0) {
+        free(s);
+        return ret;
+    }
+    *out = s;
+    return 0;
+}
 
-        pthread_mutex_lock(&cur->lock);
-        for (vfs_dentry_t *c = cur->child; c; c = c->sibling) {
-            if (!strcmp(c->name, tok)) {
-                found = c;
-                break;
-            }
-        }
-        pthread_mutex_unlock(&cur->lock);
-
-        /* Auto-create */
-        if (!found) {
-            uint64_t ino = g_next_ino++;
-            vfs_inode_t *ni = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
-            vfs_dentry_t *d = vfs_dentry_create(tok, cur, ni);
-            vfs_inode_release(ni);
-            vfs_dentry_add_child(cur, d);
-            found = d;
-        }
+static int dir_stream_list(vfs_mount_entry_t *m, vfs_dir_stream_t *s, void *buf,
+                           void *filler, off_t offset, int flags)
+{
+    if (offset < 0)
+        return -EINVAL;
+    if (s->backend_dir)
+        return m->backend_ops->readdir(m->backend_data, s->backend_dir, buf, filler,
+                                       offset, flags & VFS_READDIR_PLUS);
 
-        cur = found;
-        tok = strtok_r(NULL, "/", &save);
+    /* Entries carry the inode number and type, like d_ino/d_type */
+    fill_fn_t fill = (fill_fn_t)filler;
+    for (size_t i = (size_t)offset; i < s->n; i++) {
+        struct stat st = { .st_ino = s->ents[i].ino, .st_mode = s->ents[i].mode };
+        if (fill(buf, s->ents[i].name, &st, (off_t)(i + 1), 0) != 0)
+            break;      /* buffer full; resume from this entry */
     }
-
-    free(tmp);
-    free(norm);
-    *out = cur;
     return 0;
 }
 
-/* -------------------------------------------------------------------------- */
-/* PERMISSION CHECKS                                                           */
-/* -------------------------------------------------------------------------- */
-
-static int check_inode_perm(const vfs_inode_t *ino, uid_t req_uid, gid_t req_gid, int mask)
+/* vfs_readdir() of norm, inside mount */
+static int readdir_in_mount(vfs_mount_entry_t *mount, const char *norm, void *buf,
+                            void *filler, off_t offset, int flags)
 {
-    if (!ino) return -ENOENT;
+    const char *relpath = mount_relpath(norm, mount);
 
-    /* Determine applicable class */
-    int have_r = 0, have_w = 0, have_x = 0;
+    /* Backend directories are opened by path; in-memory ones need the dentry */
+    vfs_dentry_t *d = NULL;
+    if (!mount->backend_ops || !mount->backend_ops->opendir) {
+        int ret = resolve_in_mount(mount, relpath, &d);
+        if (ret != 0 || !d)
+            return ret ? ret : -ENOENT;
+        if (!S_ISDIR(d->inode->mode)) {
+            vfs_dentry_release(d);
+            return -ENOTDIR;
+        }
+    }
 
-    if (req_uid == 0) {
-        have_r = 1;
-        have_w = 1;
-        have_x = ((ino->mode & (S_IXUSR|S_IXGRP|S_IXOTH)) != 0);
-    } else if (req_uid == ino->uid) {
-        have_r = (ino->mode & S_IRUSR) != 0;
-        have_w = (ino->mode & S_IWUSR) != 0;
-        have_x = (ino->mode & S_IXUSR) != 0;
-    } else if (req_gid == ino->gid) {
-        have_r = (ino->mode & S_IRGRP) != 0;
-        have_w = (ino->mode & S_IWGRP) != 0;
-        have_x = (ino->mode & S_IXGRP) != 0;
-    } else {
-        have_r = (ino->mode & S_IROTH) != 0;
-        have_w = (ino->mode & S_IWOTH) != 0;
-        have_x = (ino->mode & S_IXOTH) != 0;
+    vfs_dir_stream_t *s = NULL;
+    int ret = dir_stream_open(mount, relpath, d, &s);
+    if (ret == 0) {
+        ret = dir_stream_list(mount, s, buf, filler, offset, flags);
+        dir_stream_free(mount, s);
     }
+    if (d)
+        vfs_dentry_release(d);
+    return ret;
+}
 
-    int need_r = (mask & R_OK) ? 1 : 0;
-    int need_w = (mask & W_OK) ? 1 : 0;
-    int need_x = (mask & X_OK) ? 1 : 0;
+int vfs_readdir(const char *path, void *buf, void *filler, off_t offset, void *fi, int flags)
+{
+    (void)fi;      /* Not using file info; see vfs_readdir_fh */
 
-    if (need_r && !have_r) return -EACCES;
-    if (need_w && !have_w) return -EACCES;
-    if (need_x && !have_x) return -EACCES;
-    return 0;
+    if (!path || !buf || !filler)
+        return -EINVAL;
+
+    if (!g_vfs_inited)
+        return -EIO;
+
+    char norm[VFS_PATH_MAX];
+    if (vfs_path_normalize(path, norm, sizeof(norm)) < 0)
+        return -EINVAL;
+
+    vfs_mount_entry_t *mount = find_best_mount(norm);
+    if (!mount)
+        return -ENOENT;
+    int ret = readdir_in_mount(mount, norm, buf, filler, offset, flags);
+    mount_put(mount);
+    return ret;
 }
 
-int vfs_permission_check(const char *path, uid_t uid, gid_t gid, int mask)
+/* vfs_opendir() of norm, inside mount */
+static int opendir_in_mount(vfs_mount_entry_t *mount, const char *norm)
 {
-    if (!path) return -EINVAL;
+    const char *relpath = mount_relpath(norm, mount);
+
     vfs_dentry_t *d = NULL;
-    int ret = vfs_resolve_path(path, &d);
-    if (ret != 0 || !d) return ret ? ret : -ENOENT;
-    return check_inode_perm(d->inode, uid, gid, mask);
+    int ret = resolve_leaf(mount, relpath, NULL, &d);
+    if (ret != 0 || !d)
+        return ret ? ret : -ENOENT;
+    if (!S_ISDIR(d->inode->mode))
+        ret = -ENOTDIR;
+    else
+        ret = check_inode_perm(d->inode, 0, 0, R_OK);    /* uid=0/gid=0 default */
+
+    vfs_dir_stream_t *s = NULL;
+    if (ret == 0)
+        ret = dir_stream_open(mount, relpath, d, &s);
+    if (ret != 0) {
+        vfs_dentry_release(d);
+        return ret;
+    }
+
+    /* allocate a handle; it takes over our pin on d. It grants no data
+     * access, so vfs_read and friends turn it away */
+    int fh = fh_alloc(d, O_RDONLY | O_DIRECTORY, mount, NULL, 0);
+    if (fh < 0) {
+        dir_stream_free(mount, s);
+        vfs_dentry_release(d);
+        return fh;
+    }
+    vfs_fh_entry_t *e = fh_get(fh);
+    e->access = 0;
+    e->dir = s;
+    return fh;
 }
-/* INIT + SHUTDOWN */
-/* -------------------------------------------------------------------------- */
 
-int vfs_init(void)
+int vfs_opendir(const char *path)
 {
-    pthread_mutex_lock(&g_vfs_lock);
-    if (g_vfs_inited) {
-        pthread_mutex_unlock(&g_vfs_lock);
-        return 0;
-    }
-    g_vfs_inited = 1;
-    pthread_mutex_unlock(&g_vfs_lock);
+    if (!path)
+        return -EINVAL;
 
-    /* Initialize file handle table */
-    fh_table_init_once();
+    if (!g_vfs_inited)
+        return -EIO;
 
-    /* Register POSIX backend */
-    extern const vfs_backend_ops_t *get_posix_backend_ops(void);
-    const vfs_backend_ops_t *posix_ops = get_posix_backend_ops();
-    if (posix_ops) {
-        int ret = vfs_register_backend(posix_ops);
-        if (ret < 0 && ret != -EEXIST) {
-            fprintf(stderr, "vfs_init: failed to register posix backend: %d\n", ret);
-        } else {
-            fprintf(stderr, "[vfs_init] POSIX backend registered successfully\n");
-        }
-    }
+    char norm[VFS_PATH_MAX];
+    if (vfs_path_normalize(path, norm, sizeof(norm)) < 0)
+        return -EINVAL;
 
-    /* Create default mount + sample tree */
-    vfs_mount_entry_t *rootm = vfs_mount_create("/", ".");
-    if (!rootm)
-        return -ENOMEM;
+    vfs_mount_entry_t *mount = find_best_mount(norm);
+    if (!mount)
+        return -ENOENT;
+    int ret = opendir_in_mount(mount, norm);
+    mount_put(mount);
+    return ret;
+}
 
-    /* Some populated sample entries */
-    uint64_t ino;
+int vfs_readdir_fh(int fh, void *buf, void *filler, off_t offset, int flags)
+{
+    if (!buf || !filler)
+        return -EINVAL;
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !e->dir)
+        return -EBADF;
+    return dir_stream_list(e->mount, e->dir, buf, filler, offset, flags);
+}
 
-    ino = g_next_ino++;
-    vfs_inode_t *d1i = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
-    vfs_dentry_t *d1 = vfs_dentry_create("dir1", rootm->root_dentry, d1i);
-    vfs_inode_release(d1i);
-    vfs_dentry_add_child(rootm->root_dentry, d1);
+int vfs_closedir(int fh)
+{
+    vfs_fh_entry_t *e = fh_get(fh);
+    if (!e || !e->dir)
+        return -EBADF;
+    return fh_free(fh);
+}
 
-    ino = g_next_ino++;
-    vfs_inode_t *d2i = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
-    vfs_dentry_t *d2 = vfs_dentry_create("dir2", d1, d2i);
-    vfs_inode_release(d2i);
-    vfs_dentry_add_child(d1, d2);
+/* vfs_permission_check: already implemented above; remove stub duplicate. */
 
-    ino = g_next_ino++;
-    vfs_inode_t *fi = vfs_inode_create(ino, S_IFREG | 0644, 0, 0, 0);
-    vfs_dentry_t *f = vfs_dentry_create("file", d2, fi);
-    vfs_inode_release(fi);
-    vfs_dentry_add_child(d2, f);
+/* -------------------------------------------------------------------------- */
+/* ASYNC I/O */
+/* -------------------------------------------------------------------------- */
 
-    ino = g_next_ino++;
-    vfs_inode_t *d3i = vfs_inode_create(ino, S_IFDIR | 0755, 0, 0, 0);
-    vfs_dentry_t *d3 = vfs_dentry_create("dir3", d1, d3i);
-    vfs_inode_release(d3i);
-    vfs_dentry_add_child(d1, d3);
+/*
+ * Reads and writes on a backend with read_async/write_async are handed
+ * straight to it. Everything else (stat, in-memory files, backends
+ * without the ops, a native queue that is full) goes to a small pool of
+ * workers that run the synchronous calls. Workers start on first use.
+ */
 
-    ino = g_next_ino++;
-    vfs_inode_t *f2i = vfs_inode_create(ino, S_IFREG | 0644, 0, 0, 0);
-    vfs_dentry_t *f2 = vfs_dentry_create("file2", d3, f2i);
-    vfs_inode_release(f2i);
-    vfs_dentry_add_child(d3, f2);
+#define VFS_AIO_WORKERS     8
+#define VFS_AIO_WORKERS_MAX 256
+
+enum { AIO_READ, AIO_WRITE, AIO_STAT };
+
+struct vfs_aio {
+    struct vfs_aio *next;
+    int op;
+    int fh;
+    void *buf;
+    size_t count;
+    off_t offset;
+    char *path;                 /* AIO_STAT: our copy */
+    struct stat *st;
+    vfs_inode_t *inode;         /* native transfer: pinned until it completes */
+    vfs_async_done_t done;
+    void *arg;
+};
 
-    return 0;
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work;        /* queue non-empty, or stopping */
+    pthread_cond_t idle;        /* pending reached 0 */
+    struct vfs_aio *head, *tail;
+    pthread_t threads[VFS_AIO_WORKERS_MAX];
+    int nthreads;
+    int wanted;                 /* pool size at the next start */
+    int stop;
+} g_aio = {
+    .lock   = PTHREAD_MUTEX_INITIALIZER,
+    .work   = PTHREAD_COND_INITIALIZER,
+    .idle   = PTHREAD_COND_INITIALIZER,
+    .wanted = VFS_AIO_WORKERS,
+};
+
+/* Accepted requests whose callback has not returned yet */
+static _Atomic unsigned long g_aio_pending;
+
+static vfs_slab_cache_t g_aio_slab;
+static pthread_once_t g_aio_slab_once = PTHREAD_ONCE_INIT;
+
+static void aio_slab_init_once(void)
+{
+    vfs_slab_init(&g_aio_slab, "vfs_aio", sizeof(struct vfs_aio));
 }
 
-int vfs_shutdown(void)
+static struct vfs_aio *aio_alloc(int op, vfs_async_done_t done, void *arg)
 {
-    pthread_mutex_lock(&g_vfs_lock);
+    pthread_once(&g_aio_slab_once, aio_slab_init_once);
+    struct vfs_aio *a = vfs_slab_alloc(&g_aio_slab);
+    if (!a)
+        return NULL;
+    a->op = op;
+    a->done = done;
+    a->arg = arg;
+    return a;
+}
 
-    if (!g_vfs_inited) {
-        pthread_mutex_unlock(&g_vfs_lock);
-        return 0;
-    }
+static void aio_free(struct vfs_aio *a)
+{
+    if (a->inode)
+        vfs_inode_release(a->inode);
+    free(a->path);
+    vfs_slab_free(&g_aio_slab, a);
+}
 
-    g_vfs_inited = 0;
+static void aio_unpend(void)
+{
+    if (atomic_fetch_sub(&g_aio_pending, 1) == 1) {
+        pthread_mutex_lock(&g_aio.lock);
+        pthread_cond_broadcast(&g_aio.idle);
+        pthread_mutex_unlock(&g_aio.lock);
+    }
+}
 
-    while (mount_table_head) {
-        vfs_mount_entry_t *m = mount_table_head;
-        mount_table_head = m->next;
+/* Deliver the result and retire the request */
+static void aio_finish(struct vfs_aio *a, ssize_t result)
+{
+    a->done(a->arg, result);
+    aio_free(a);
+    aio_unpend();
+}
 
-        /* Shutdown backend if present */
-        if (m->backend_ops && m->backend_ops->shutdown && m->backend_data) {
-            m->backend_ops->shutdown(m->backend_data);
+static void *aio_worker(void *unused)
+{
+    (void)unused;
+    pthread_mutex_lock(&g_aio.lock);
+    for (;;) {
+        while (!g_aio.head && !g_aio.stop)
+            pthread_cond_wait(&g_aio.work, &g_aio.lock);
+        struct vfs_aio *a = g_aio.head;
+        if (!a)
+            break;              /* stopping, and the queue is empty */
+        g_aio.head = a->next;
+        if (!g_aio.head)
+            g_aio.tail = NULL;
+        pthread_mutex_unlock(&g_aio.lock);
+
+        ssize_t res;
+        switch (a->op) {
+        case AIO_READ:  res = vfs_read(a->fh, a->buf, a->count, a->offset); break;
+        case AIO_WRITE: res = vfs_write(a->fh, a->buf, a->count, a->offset); break;
+        default:        res = vfs_stat(a->path, a->st); break;
         }
+        aio_finish(a, res);
 
-        vfs_dentry_destroy_tree(m->root_dentry);
-        free(m->mountpoint);
-        free(m->backend_root);
-        free(m);
+        pthread_mutex_lock(&g_aio.lock);
     }
+    pthread_mutex_unlock(&g_aio.lock);
+    return NULL;
+}
 
-    /* Clean up file handle table */
-    for (int i = 0; i < VFS_MAX_FH; i++) {
-        if (g_fh_table[i].in_use) {
-            if (g_fh_table[i].dentry) {
-                vfs_dentry_release(g_fh_table[i].dentry);
-            }
-            g_fh_table[i].in_use = 0;
-            g_fh_table[i].dentry = NULL;
-        }
+/* Queue a for the pool, starting workers as needed */
+static int aio_queue(struct vfs_aio *a)
+{
+    pthread_mutex_lock(&g_aio.lock);
+    if (g_aio.stop) {
+        pthread_mutex_unlock(&g_aio.lock);
+        return -EAGAIN;
     }
-
-    pthread_mutex_unlock(&g_vfs_lock);
+    while (g_aio.nthreads < g_aio.wanted &&
+           pthread_create(&g_aio.threads[g_aio.nthreads], NULL, aio_worker, NULL) == 0)
+        g_aio.nthreads++;
+    if (!g_aio.nthreads) {
+        pthread_mutex_unlock(&g_aio.lock);
+        return -EAGAIN;
+    }
+    a->next = NULL;
+    if (g_aio.tail)
+        g_aio.tail->next = a;
+    else
+        g_aio.head = a;
+    g_aio.tail = a;
+    pthread_cond_signal(&g_aio.work);
+    pthread_mutex_unlock(&g_aio.lock);
     return 0;
 }
 
-/* -------------------------------------------------------------------------- */
-/* Public API stubs (shim implementations)                                      */
-/* These return -ENOSYS for now so other layers can compile and link.         */
-/* -------------------------------------------------------------------------- */
-
-int vfs_open(const char *path, int flags)
+/* Let the workers finish the queue and exit; the next request restarts them */
+static void aio_stop_workers(void)
 {
-    if (!path)
-        return -EINVAL;
+    pthread_mutex_lock(&g_aio.lock);
+    g_aio.stop = 1;
+    pthread_cond_broadcast(&g_aio.work);
+    int n = g_aio.nthreads;
+    pthread_mutex_unlock(&g_aio.lock);
+
+    for (int i = 0; i < n; i++)
+        pthread_join(g_aio.threads[i], NULL);
+
+    pthread_mutex_lock(&g_aio.lock);
+    g_aio.nthreads = 0;
+    g_aio.stop = 0;
+    pthread_mutex_unlock(&g_aio.lock);
+}
 
-    if (!g_vfs_inited)
-        return -EIO;
+/* Backend completion of a native transfer */
+static void aio_native_done(void *arg, ssize_t result)
+{
+    struct vfs_aio *a = arg;
+    if (a->op == AIO_WRITE)
+        inode_note_write(a->inode, a->offset, result);
+    aio_finish(a, result);
+}
 
-    /* Check if mount has backend - for O_CREAT, dispatch directly to backend */
-    vfs_mount_entry_t *mount = find_best_mount(path);
-    if (mount && mount->backend_ops && mount->backend_ops->open && (flags & O_CREAT)) {
-        /* Creating file through backend - don't auto-create VFS dentry yet */
-        char *relpath = get_relpath_for_mount(path, mount);
-        if (!relpath) return -EINVAL;
-        
-        void *backend_handle = NULL;
-        int ret = mount->backend_ops->open(mount->backend_data, relpath, flags, &backend_handle);
-        free(relpath);
-        
-        if (ret < 0) return ret;
-        
-        /* Now create VFS dentry for the file */
-        uint64_t ino = g_next_ino++;
-        vfs_inode_t *inode = vfs_inode_create(ino, S_IFREG | 0644, 0, 0, 0);
-        if (!inode) return -ENOMEM;
-        inode->backend_handle = backend_handle;
-        
-        /* Extract filename */
-        const char *name = strrchr(path, '/');
-        name = name ? name + 1 : path;
-        
-        vfs_dentry_t *d = vfs_dentry_create(name, NULL, inode);
-        vfs_inode_release(inode);
-        if (!d) return -ENOMEM;
-        
-        /* Allocate handle */
-        int fh = fh_alloc(d, flags);
-        return fh;
+/* Start a read or write natively if the backend can, else on the pool */
+static int aio_start_rw(vfs_fh_entry_t *e, struct vfs_aio *a)
+{
+    atomic_fetch_add(&g_aio_pending, 1);
+
+    const vfs_backend_ops_t *ops = e->mount->backend_ops;
+    void *data = e->mount->backend_data;
+    int native = a->op == AIO_READ ? ops->read_async != NULL : ops->write_async != NULL;
+    if (e->backend_handle && native) {
+        /* The backend handle belongs to the inode; keep it open */
+        a->inode = e->dentry->inode;
+        vfs_inode_acquire(a->inode);
+        int ret = a->op == AIO_READ
+            ? ops->read_async(data, e->backend_handle, a->buf, a->count, a->offset,
+                              aio_native_done, a)
+            : ops->write_async(data, e->backend_handle, a->buf, a->count, a->offset,
+                               aio_native_done, a);
+        if (ret == 0)
+            return 0;           /* a may already be gone */
+        vfs_inode_release(a->inode);
+        a->inode = NULL;
     }
 
-    /* Normal path: resolve and open existing file */
-    vfs_dentry_t *d = NULL;
-    int ret = vfs_resolve_path(path, &d);
-    if (ret != 0 || !d)
-        return ret ? ret : -ENOENT;
-
-    /* Directories cannot be opened for read/write as files */
-    if (d->inode && S_ISDIR(d->inode->mode))
-        return -EISDIR;
-
-    /* permission check: basic R/W */
-    int mask = 0;
-    if ((flags & O_WRONLY) || (flags & O_RDWR)) mask |= W_OK;
-    if ((flags & O_RDONLY) || (flags & O_RDWR) || !(flags & O_WRONLY)) mask |= R_OK;
-
-    int perm = check_inode_perm(d->inode, 0, 0, mask); /* uid=0/gid=0 default */
-    if (perm != 0)
-        return perm;
-
-    /* For existing files with backend, get backend handle */
-    if (mount && mount->backend_ops && mount->backend_ops->open && !d->inode->backend_handle) {
-        char *relpath = get_relpath_for_mount(path, mount);
-        if (!relpath) return -EINVAL;
-        
-        void *backend_handle = NULL;
-        ret = mount->backend_ops->open(mount->backend_data, relpath, flags, &backend_handle);
-        free(relpath);
-        
-        if (ret < 0) return ret;
-        
-        d->inode->backend_handle = backend_handle;
+    int ret = aio_queue(a);
+    if (ret < 0) {
+        aio_free(a);
+        aio_unpend();
     }
-
-    /* allocate a handle */
-    int fh = fh_alloc(d, flags);
-    if (fh < 0)
-        return fh;
-
-    return fh;
+    return ret;
 }
 
-int vfs_close(int fh)
+int vfs_read_async(int fh, void *buf, size_t count, off_t offset,
+                   vfs_async_done_t done, void *arg)
 {
+    if (!buf || !done)
+        return -EINVAL;
+
     vfs_fh_entry_t *e = fh_get(fh);
-    if (!e)
+    if (!e || !(e->access & R_OK))
         return -EBADF;
 
-    fh_free(fh);
-    return 0;
+    struct vfs_aio *a = aio_alloc(AIO_READ, done, arg);
+    if (!a)
+        return -ENOMEM;
+    a->fh = fh;
+    a->buf = buf;
+    a->count = count;
+    a->offset = offset;
+    return aio_start_rw(e, a);
 }
 
-ssize_t vfs_read(int fh, void *buf, size_t count, off_t offset)
+int vfs_write_async(int fh, const void *buf, size_t count, off_t offset,
+                    vfs_async_done_t done, void *arg)
 {
-    if (!buf)
+    if (!buf || !done)
         return -EINVAL;
 
     vfs_fh_entry_t *e = fh_get(fh);
-    if (!e)
+    if (!e || !(e->access & W_OK))
         return -EBADF;
 
-    vfs_dentry_t *d = e->dentry;
-    if (!d || !d->inode)
-        return -ENOENT;
-
-    if (S_ISDIR(d->inode->mode))
-        return -EISDIR;
+    struct vfs_aio *a = aio_alloc(AIO_WRITE, done, arg);
+    if (!a)
+        return -ENOMEM;
+    a->fh = fh;
+    a->buf = (void *)buf;
+    a->count = count;
+    a->offset = offset;
+    return aio_start_rw(e, a);
+}
 
-    /* permission check: read */
-    int perm = check_inode_perm(d->inode, 0, 0, R_OK);
-    if (perm != 0)
-        return perm;
+int vfs_stat_async(const char *path, struct stat *st, vfs_async_done_t done, void *arg)
+{
+    if (!path || !st || !done)
+        return -EINVAL;
 
-    /* Check if backend handle is available */
-    if (d->inode->backend_handle) {
-        /* Find mount to get backend ops - simplified: we know handle exists so backend must */
-        /* We could store mount ref in dentry, but for now iterate mounts */
-        pthread_mutex_lock(&g_vfs_lock);
-        for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next) {
-            if (m->backend_ops && m->backend_ops->read) {
-                ssize_t result = m->backend_ops->read(m->backend_data, 
-                                                      d->inode->backend_handle,
-                                                      buf, count, offset);
-                pthread_mutex_unlock(&g_vfs_lock);
-                return result;
-            }
-        }
-        pthread_mutex_unlock(&g_vfs_lock);
+    struct vfs_aio *a = aio_alloc(AIO_STAT, done, arg);
+    if (!a)
+        return -ENOMEM;
+    a->path = strdup(path);
+    if (!a->path) {
+        aio_free(a);
+        return -ENOMEM;
     }
+    a->st = st;
 
-    /* Fallback: simple zero-filled content model */
-    off_t size = d->inode->size;
-    if (offset >= size)
-        return 0;
+    atomic_fetch_add(&g_aio_pending, 1);
+    int ret = aio_queue(a);
+    if (ret < 0) {
+        aio_free(a);
+        aio_unpend();
+    }
+    return ret;
+}
 
-    size_t avail = (size - offset) > 0 ? (size - offset) : 0;
-    size_t n = (count < avail) ? count : avail;
-    memset(buf, 0, n);
-    return (ssize_t)n;
+void vfs_async_drain(void)
+{
+    pthread_mutex_lock(&g_aio.lock);
+    while (atomic_load(&g_aio_pending))
+        pthread_cond_wait(&g_aio.idle, &g_aio.lock);
+    pthread_mutex_unlock(&g_aio.lock);
 }
 
-ssize_t vfs_write(int fh, const void *buf, size_t count, off_t offset)
+int vfs_async_set_workers(int n)
 {
-    if (!buf)
+    if (n < 1 || n > VFS_AIO_WORKERS_MAX)
         return -EINVAL;
+    vfs_async_drain();
+    aio_stop_workers();
+    pthread_mutex_lock(&g_aio.lock);
+    g_aio.wanted = n;
+    pthread_mutex_unlock(&g_aio.lock);
+    return 0;
+}
 
-    vfs_fh_entry_t *e = fh_get(fh);
-    if (!e)
-        return -EBADF;
-
-    vfs_dentry_t *d = e->dentry;
-    if (!d || !d->inode)
-        return -ENOENT;
-
-    if (S_ISDIR(d->inode->mode))
-        return -EISDIR;
-
-    /* permission check: write */
-    int perm = check_inode_perm(d->inode, 0, 0, W_OK);
-    if (perm != 0)
-        return perm;
+/* -------------------------------------------------------------------------- */
+/* BATCHES */
+/* -------------------------------------------------------------------------- */
 
-    /* Check if backend handle is available */
-    if (d->inode->backend_handle) {
-        pthread_mutex_lock(&g_vfs_lock);
-        for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next) {
-            if (m->backend_ops && m->backend_ops->write) {
-                ssize_t written = m->backend_ops->write(m->backend_data,
-                                                         d->inode->backend_handle,
-                                                         buf, count, offset);
-                pthread_mutex_unlock(&g_vfs_lock);
-                if (written > 0) {
-                    /* Update size */
-                    off_t new_size = offset + written;
-                    if (new_size > d->inode->size)
-                        d->inode->size = new_size;
-                }
-                return written;
-            }
-        }
-        pthread_mutex_unlock(&g_vfs_lock);
+/* The directory the batch's last path op was in, held for the next ones */
+typedef struct {
+    vfs_mount_entry_t *mount;   /* pinned while dentry is set */
+    vfs_dentry_t *dentry;       /* pinned; NULL when unset */
+    size_t len;
+    int submounts;              /* some entry in it is a mountpoint */
+    char path[VFS_PATH_MAX];
+} batch_dir_t;
+
+/* A read or write the backend is running asynchronously */
+typedef struct batch_io {
+    struct batch *batch;
+    vfs_batch_op_t *op;
+    int fh;
+    vfs_inode_t *ino;
+    int is_write;
+    struct batch_io *next;
+} batch_io_t;
+
+typedef struct batch {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    batch_io_t *inflight;
+    int failed;
+    batch_io_t *ios;            /* one per op, allocated on first use */
+    int *closes;                /* closes waiting for their transfers */
+    int nclose;
+} batch_t;
+
+static void batch_dir_release(batch_dir_t *bd)
+{
+    if (bd->dentry) {
+        vfs_dentry_release(bd->dentry);
+        mount_put(bd->mount);
     }
+    bd->dentry = NULL;
+}
 
-    /* Fallback: Grow file size to simulate write */
-    off_t end = offset + (off_t)count;
-    if (end > d->inode->size)
-        d->inode->size = end;
-
-    /* We don't store content; pretend we wrote all bytes */
-    return (ssize_t)count;
+/* Is some mount rooted directly inside the normalized directory dir? */
+static int mount_has_children(const char *dir, size_t len)
+{
+    int found = 0;
+    pthread_mutex_lock(&g_vfs_lock);
+    for (vfs_mount_entry_t *m = mount_table_head; m && !found; m = m->next) {
+        const char *leaf = strrchr(m->mountpoint, '/');
+        found = leaf && leaf[1] && (size_t)(leaf - m->mountpoint) == len &&
+                !memcmp(m->mountpoint, dir, len);
+    }
+    pthread_mutex_unlock(&g_vfs_lock);
+    return found;
 }
 
-int vfs_stat(const char *path, struct stat *st)
+/*
+ * Normalize path into norm and find its mount, pinned for the op to drop
+ * with mount_put() when it returns 0. *dir is set to the pinned parent
+ * directory of the last component when bd holds (or can be made to hold)
+ * it, else NULL. Lookup errors are left for the op to report.
+ */
+static int batch_locate(batch_dir_t *bd, const char *path, char *norm,
+                        vfs_mount_entry_t **mount, vfs_dentry_t **dir)
 {
-    if (!path || !st)
+    *dir = NULL;
+    if (!path)
+        return -EINVAL;
+    if (vfs_path_normalize(path, norm, VFS_PATH_MAX) < 0)
         return -EINVAL;
 
-    /* Check if backend can provide stat */
-    vfs_mount_entry_t *mount = find_best_mount(path);
-    if (mount && mount->backend_ops && mount->backend_ops->stat) {
-        char *relpath = get_relpath_for_mount(path, mount);
-        if (relpath) {
-            int ret = mount->backend_ops->stat(mount->backend_data, relpath, st);
-            free(relpath);
-            if (ret == 0) return 0;
-            /* If backend fails, fall through to in-memory */
-        }
+    const char *leaf = strrchr(norm, '/') + 1;
+    size_t len = (size_t)(leaf - norm - 1);       /* "/x": 0 */
+    if (*leaf && bd->dentry && bd->len == len && !memcmp(bd->path, norm, len) &&
+        !bd->submounts) {
+        *mount = bd->mount;
+        mount_get(*mount);
+        *dir = bd->dentry;
+        return 0;
     }
 
-    /* Fallback: in-memory stat */
+    *mount = find_best_mount(norm);
+    if (!*mount)
+        return -ENOENT;
+    if (!*leaf || !strcmp((*mount)->mountpoint, norm))
+        return 0;               /* "/" or a mount root: no parent to share */
+    if (bd->dentry && bd->len == len && !memcmp(bd->path, norm, len))
+        return 0;               /* same directory, but it has submounts */
+
+    char dpath[VFS_PATH_MAX];
+    memcpy(dpath, norm, len ? len : 1);
+    dpath[len ? len : 1] = '\0';
     vfs_dentry_t *d = NULL;
-    int ret = vfs_resolve_path(path, &d);
-    if (ret != 0 || !d)
-        return ret ? ret : -ENOENT;
+    batch_dir_release(bd);
+    if (resolve_in_mount(*mount, mount_relpath(dpath, *mount), &d) != 0)
+        return 0;
+    if (!S_ISDIR(d->inode->mode)) {
+        vfs_dentry_release(d);
+        return 0;
+    }
+    mount_get(*mount);
+    bd->mount = *mount;
+    bd->dentry = d;
+    bd->len = len;
+    memcpy(bd->path, norm, len);
+    bd->submounts = mount_has_children(dpath, len);
+    if (!bd->submounts)
+        *dir = d;
+    return 0;
+}
 
-    if (!d->inode)
-        return -ENOENT;
+static void batch_io_done(void *arg, ssize_t result)
+{
+    batch_io_t *io = arg;
+    batch_t *b = io->batch;
+    io->op->result = result;
+    pthread_mutex_lock(&b->lock);
+    if (result < 0)
+        b->failed = 1;
+    for (batch_io_t **pp = &b->inflight; *pp; pp = &(*pp)->next) {
+        if (*pp == io) {
+            *pp = io->next;
+            break;
+        }
+    }
+    pthread_cond_broadcast(&b->cond);
+    pthread_mutex_unlock(&b->lock);
+}
 
-    memset(st, 0, sizeof(*st));
-    st->st_mode = d->inode->mode;
-    st->st_size = d->inode->size;
-    st->st_uid = d->inode->uid;
-    st->st_gid = d->inode->gid;
-    st->st_ino = d->inode->ino;
+/* Is a transfer in flight on fh (-1: any) and ino (NULL: any), counting
+ * only writes if writes is set? Called with b->lock held */
+static int batch_busy(batch_t *b, int fh, vfs_inode_t *ino, int writes)
+{
+    for (batch_io_t *io = b->inflight; io; io = io->next)
+        if ((fh == -1 || io->fh == fh) && (!ino || io->ino == ino) &&
+            (!writes || io->is_write))
+            return 1;
     return 0;
 }
 
-int vfs_readdir(const char *path, void *buf, void *filler, off_t offset, void *fi)
+/* Wait until batch_busy() is false */
+static void batch_wait(batch_t *b, int fh, vfs_inode_t *ino, int writes)
 {
-    (void)offset;  /* Simple implementation - ignore offset */
-    (void)fi;      /* Not using file info */
-    
-    if (!path || !buf || !filler)
-        return -EINVAL;
+    pthread_mutex_lock(&b->lock);
+    while (batch_busy(b, fh, ino, writes))
+        pthread_cond_wait(&b->cond, &b->lock);
+    pthread_mutex_unlock(&b->lock);
+}
 
-    /* Check if backend can provide readdir */
-    vfs_mount_entry_t *mount = find_best_mount(path);
-    if (mount && mount->backend_ops && mount->backend_ops->readdir) {
-        char *relpath = get_relpath_for_mount(path, mount);
-        if (relpath) {
-            int ret = mount->backend_ops->readdir(mount->backend_data, relpath, buf, filler);
-            free(relpath);
-            if (ret == 0) return 0;
-            /* If backend fails, fall through to in-memory */
-        }
-    }
+static vfs_inode_t *fh_inode(int fh)
+{
+    vfs_fh_entry_t *e = fh_get(fh);
+    return e && e->dentry ? e->dentry->inode : NULL;
+}
+
+/* Before a stat or truncating open of norm: wait for writes in flight to
+ * the file it names. Only resolves the path when some write is pending */
+static void batch_wait_path(batch_t *b, vfs_mount_entry_t *mount, const char *norm,
+                            vfs_dentry_t *dir)
+{
+    pthread_mutex_lock(&b->lock);
+    int writes = batch_busy(b, -1, NULL, 1);
+    pthread_mutex_unlock(&b->lock);
+    if (!writes)
+        return;
 
-    /* Fallback: in-memory readdir */
     vfs_dentry_t *d = NULL;
-    int ret = vfs_resolve_path(path, &d);
-    if (ret != 0 || !d)
-        return ret ? ret : -ENOENT;
+    if (resolve_leaf(mount, mount_relpath(norm, mount), dir, &d) != 0 || !d)
+        return;
+    batch_wait(b, -1, d->inode, 1);
+    vfs_dentry_release(d);
+}
 
-    if (!d->inode)
-        return -ENOENT;
+/* Run the deferred closes of fh (-1: all of them), in op order */
+static void batch_run_closes(batch_t *b, vfs_batch_op_t *ops, int fh)
+{
+    int kept = 0;
+    for (int k = 0; k < b->nclose; k++) {
+        vfs_batch_op_t *op = &ops[b->closes[k]];
+        int cfh = op->fh < 0 ? (int)ops[-1 - op->fh].result : op->fh;
+        if (fh != -1 && cfh != fh) {
+            b->closes[kept++] = b->closes[k];
+            continue;
+        }
+        batch_wait(b, cfh, NULL, 0);
+        op->result = vfs_close(cfh);
+        if (op->result < 0) {
+            pthread_mutex_lock(&b->lock);
+            b->failed = 1;
+            pthread_mutex_unlock(&b->lock);
+        }
+    }
+    b->nclose = kept;
+}
 
-    if (!S_ISDIR(d->inode->mode))
-        return -ENOTDIR;
+/* Run a read or write, or start it without waiting when the backend has
+ * native async transfers. Returns 1 if it is in flight (the completion
+ * fills in the result), else 0 */
+static int batch_transfer(batch_t *b, vfs_batch_op_t *ops, int i, int nops, int fh)
+{
+    vfs_batch_op_t *op = &ops[i];
+    int is_write = op->opcode == VFS_BATCH_WRITE;
+    vfs_fh_entry_t *e = fh_get(fh);
+    const vfs_backend_ops_t *bops = e && e->backend_handle ? e->mount->backend_ops : NULL;
+    int native = bops && (is_write ? bops->write_async != NULL : bops->read_async != NULL);
+
+    if (native && !b->ios)
+        b->ios = calloc((size_t)nops, sizeof(*b->ios));
+    if (!native || !b->ios) {
+        op->result = is_write ? vfs_write(fh, op->buf, op->count, op->offset)
+                              : vfs_read(fh, op->buf, op->count, op->offset);
+        return 0;
+    }
 
-    /* FUSE3 filler: int (*)(void *buf, const char *name, const struct stat *st, off_t off, enum flags) */
-    typedef int (*fill_fn_t)(void *, const char *, const struct stat *, off_t, int);
-    fill_fn_t fill = (fill_fn_t)filler;
+    batch_io_t *io = &b->ios[i];
+    io->batch = b;
+    io->op = op;
+    io->fh = fh;
+    io->ino = e->dentry->inode;
+    io->is_write = is_write;
+    pthread_mutex_lock(&b->lock);
+    io->next = b->inflight;
+    b->inflight = io;
+    pthread_mutex_unlock(&b->lock);
+
+    int ret = is_write
+        ? vfs_write_async(fh, op->buf, op->count, op->offset, batch_io_done, io)
+        : vfs_read_async(fh, op->buf, op->count, op->offset, batch_io_done, io);
+    if (ret < 0)
+        batch_io_done(io, ret);
+    return 1;
+}
 
-    /* Add . and .. entries (pass 0 for flags) */
-    if (fill(buf, ".", NULL, 0, 0) != 0) {
-        /* Buffer full on first entry - this shouldn't happen */
+int vfs_submit_batch(vfs_batch_op_t *ops, int nops, int flags)
+{
+    if ((!ops && nops) || nops < 0)
+        return -EINVAL;
+    if (!g_vfs_inited)
         return -EIO;
-    }
-    fill(buf, "..", NULL, 0, 0);
 
-    /* Add child entries */
-    pthread_mutex_lock(&d->lock);
-    for (vfs_dentry_t *c = d->child; c; c = c->sibling) {
-        if (fill(buf, c->name, NULL, 0, 0) != 0) {
-            /* Buffer full - stop adding but return success */
+    batch_t b = { .inflight = NULL };
+    batch_dir_t bd = { .dentry = NULL };
+    pthread_mutex_init(&b.lock, NULL);
+    pthread_cond_init(&b.cond, NULL);
+
+    for (int i = 0; i < nops; i++) {
+        vfs_batch_op_t *op = &ops[i];
+        char norm[VFS_PATH_MAX];
+        vfs_mount_entry_t *mount;
+        vfs_dentry_t *dir;
+        ssize_t r;
+
+        if (flags & VFS_BATCH_STOP_ON_ERROR) {
+            pthread_mutex_lock(&b.lock);
+            int failed = b.failed;
+            pthread_mutex_unlock(&b.lock);
+            if (failed) {
+                op->result = -ECANCELED;
+                continue;
+            }
+        }
+
+        /* A handle from an earlier op of this batch */
+        int fh = op->fh;
+        if (fh < 0 && op->opcode != VFS_BATCH_OPEN && op->opcode != VFS_BATCH_STAT &&
+            op->opcode != VFS_BATCH_MKDIR) {
+            int src = -1 - fh;
+            if (src >= i || ops[src].opcode != VFS_BATCH_OPEN) {
+                op->result = -EINVAL;
+                goto done;
+            }
+            if (ops[src].result < 0) {
+                op->result = -ECANCELED;
+                goto done;
+            }
+            fh = (int)ops[src].result;
+        }
+        /* a deferred close of the handle comes first */
+        if (b.nclose && op->opcode != VFS_BATCH_OPEN && op->opcode != VFS_BATCH_STAT &&
+            op->opcode != VFS_BATCH_MKDIR)
+            batch_run_closes(&b, ops, fh);
+
+        switch (op->opcode) {
+        case VFS_BATCH_OPEN:
+            r = batch_locate(&bd, op->path, norm, &mount, &dir);
+            if (r < 0) {
+                op->result = r;
+                break;
+            }
+            if (op->flags & O_TRUNC)
+                batch_wait_path(&b, mount, norm, dir);
+            op->result = open_in_mount(mount, norm, op->flags, dir);
+            mount_put(mount);
+            break;
+        case VFS_BATCH_STAT:
+            r = op->st ? batch_locate(&bd, op->path, norm, &mount, &dir) : -EINVAL;
+            if (r < 0) {
+                op->result = r;
+                break;
+            }
+            batch_wait_path(&b, mount, norm, dir);
+            op->result = stat_in_mount(mount, norm, op->st, dir);
+            mount_put(mount);
+            break;
+        case VFS_BATCH_MKDIR:
+            op->result = vfs_mkdir(op->path, op->mode);
+            break;
+        case VFS_BATCH_READ:
+        case VFS_BATCH_WRITE:
+            if (batch_transfer(&b, ops, i, nops, fh))
+                continue;       /* its completion records a failure */
+            break;
+        case VFS_BATCH_FSYNC:
+            batch_wait(&b, -1, fh_inode(fh), 1);
+            op->result = vfs_fsync(fh, op->flags != 0);
+            break;
+        case VFS_BATCH_CLOSE:
+            /* With transfers still in flight, close later rather than
+             * stall the ops after this one */
+            pthread_mutex_lock(&b.lock);
+            r = batch_busy(&b, fh, NULL, 0);
+            pthread_mutex_unlock(&b.lock);
+            if (r && !b.closes)
+                b.closes = malloc((size_t)nops * sizeof(*b.closes));
+            if (r && b.closes) {
+                b.closes[b.nclose++] = i;
+                continue;
+            }
+            op->result = vfs_close(fh);
+            break;
+        default:
+            op->result = -EINVAL;
             break;
         }
+done:
+        if (op->result < 0) {
+            pthread_mutex_lock(&b.lock);
+            b.failed = 1;
+            pthread_mutex_unlock(&b.lock);
+        }
     }
-    pthread_mutex_unlock(&d->lock);
 
-    return 0;
+    batch_run_closes(&b, ops, -1);
+    batch_wait(&b, -1, NULL, 0);
+    batch_dir_release(&bd);
+    free(b.ios);
+    free(b.closes);
+    pthread_mutex_destroy(&b.lock);
+    pthread_cond_destroy(&b.cond);
+
+    int ok = 0;
+    for (int i = 0; i < nops; i++)
+        if (ops[i].result >= 0)
+            ok++;
+    return ok;
 }
 
-/* vfs_permission_check: already implemented above; remove stub duplicate. */
-
 /* Public wrapper: vfs_lookup delegates to vfs_resolve_path. */
 int vfs_lookup(const char *path, vfs_dentry_t **out)
 {
@@ -1051,6 +3836,12 @@ int vfs_lookup(const char *path, vfs_dentry_t **out)
 
 int vfs_mount_backend(const char *mountpoint, const char *backend_root,
                       const char *backend_type)
+{
+    return vfs_mount_backend_flags(mountpoint, backend_root, backend_type, 0);
+}
+
+int vfs_mount_backend_flags(const char *mountpoint, const char *backend_root,
+                            const char *backend_type, unsigned int flags)
 {
     if (!mountpoint || !backend_root || !backend_type)
         return -EINVAL;
@@ -1062,22 +3853,30 @@ int vfs_mount_backend(const char *mountpoint, const char *backend_root,
         return -ENODEV;
     }
 
-    /* Create mount structure */
-    vfs_mount_entry_t *m = vfs_mount_create(mountpoint, backend_root);
+    /* Create mount structure; lookups only see it once the backend is up */
+    vfs_mount_entry_t *m = mount_alloc(mountpoint, backend_root);
     if (!m) return -ENOMEM;
 
     /* Initialize backend */
     void *backend_data = NULL;
     int ret = ops->init(backend_root, &backend_data);
     if (ret < 0) {
-        vfs_mount_destroy(m);
+        mount_teardown(m);
         return ret;
     }
 
     /* Attach backend to mount */
     m->backend_ops = ops;
     m->backend_data = backend_data;
+    m->flags = flags;
+
+    /* Stable numbering covers the mount root too */
+    struct stat st;
+    if ((flags & VFS_MOUNT_STABLE_INO) && ops->stat &&
+        ops->stat(backend_data, ".", &st) == 0)
+        m->root_dentry->inode->ino = mount_ino(m, &st);
 
+    mount_publish(m);
     return 0;
 }
 
@@ -1089,17 +3888,17 @@ int vfs_unmount_backend(const char *mountpoint)
     pthread_mutex_lock(&g_vfs_lock);
     vfs_mount_entry_t *m = NULL;
     for (vfs_mount_entry_t *cur = mount_table_head; cur; cur = cur->next) {
-        if (strcmp(cur->mountpoint, mountpoint) == 0) {
+        if (!cur->unmounting && strcmp(cur->mountpoint, mountpoint) == 0) {
             m = cur;
             break;
         }
     }
+    mount_trie_t *old = m ? mount_hide_locked(m) : NULL;
     pthread_mutex_unlock(&g_vfs_lock);
 
     if (!m)
         return -ENOENT;
-
-    return vfs_mount_destroy(m);
+    return mount_retire(m, old);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1123,24 +3922,39 @@ int vfs_create(const char *path, mode_t mode, struct fuse_file_info *fi) {
     return vfs_open(path, flags | mode);
 }
 
-int vfs_mkdir(const char *path, mode_t mode) {
-    if (!path) return -EINVAL;
-    
-    /* Create directory in VFS tree */
-    vfs_dentry_t *d = NULL;
-    int ret = vfs_resolve_path(path, &d);
-    if (ret < 0) return ret;
-    
-    /* If already exists, return error */
-    if (d && d->inode) return -EEXIST;
-    
-    /* Auto-creation by resolve_path already made it as directory */
-    /* Just verify it exists now */
-    if (d && d->inode && S_ISDIR(d->inode->mode)) {
+/* vfs_mkdir() of norm, inside mount */
+static int mkdir_in_mount(vfs_mount_entry_t *mount, const char *norm, mode_t mode) {
+    /* Backend mounts: create on disk, lookups will pick it up */
+    if (mount->backend_ops && mount->backend_ops->mkdir) {
+        const char *relpath = mount_relpath(norm, mount);
+        int ret = mount->backend_ops->mkdir(mount->backend_data, relpath, mode);
+        if (ret < 0) return ret;
+        dcache_forget_negative(mount, relpath);
         return 0;
     }
-    
-    return -EIO;
+
+    /* Create directory in VFS tree */
+    vfs_dentry_t *d = NULL;
+    int ret = create_in_mount(mount, norm, S_IFDIR | (mode & 07777), &d);
+    if (d)
+        vfs_dentry_release(d);
+    return ret;
+}
+
+int vfs_mkdir(const char *path, mode_t mode) {
+    if (!path) return -EINVAL;
+    if (!g_vfs_inited) return -EIO;
+
+    char norm[VFS_PATH_MAX];
+    if (vfs_path_normalize(path, norm, sizeof(norm)) < 0)
+        return -EINVAL;
+
+    vfs_mount_entry_t *mount = find_best_mount(norm);
+    if (!mount)
+        return -ENOENT;
+    int ret = mkdir_in_mount(mount, norm, mode);
+    mount_put(mount);
+    return ret;
 }
 
 int vfs_mknod(const char *path, mode_t mode, dev_t rdev) {
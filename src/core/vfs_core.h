@@ -4,8 +4,10 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <stdatomic.h>
 
 /*
  * ================================
@@ -24,6 +26,10 @@ struct vfs_backend_ops;
 /* ----------------------------------
  * Backend Operations Function Table
  * ---------------------------------- */
+/* Completion of an asynchronous request: result is what the synchronous
+ * call would have returned (a byte count, 0, or -errno) */
+typedef void (*vfs_async_done_t)(void *arg, ssize_t result);
+
 typedef struct vfs_backend_ops {
     const char *name;  /* Backend type name (e.g., "posix", "ext2") */
     
@@ -36,40 +42,127 @@ typedef struct vfs_backend_ops {
     int (*close)(void *backend_data, void *handle);
     ssize_t (*read)(void *backend_data, void *handle, void *buf, size_t count, off_t offset);
     ssize_t (*write)(void *backend_data, void *handle, const void *buf, size_t count, off_t offset);
+    /* Optional scatter/gather forms; the core falls back to read/write per buffer */
+    ssize_t (*readv)(void *backend_data, void *handle, const struct iovec *iov, int iovcnt, off_t offset);
+    ssize_t (*writev)(void *backend_data, void *handle, const struct iovec *iov, int iovcnt, off_t offset);
+    /* Optional; flush file data (and metadata unless datasync) to stable storage */
+    int (*fsync)(void *backend_data, void *handle, int datasync);
+    /* Optional native async transfers: return 0 once the I/O is started and
+     * call done(arg, result) exactly once, from any thread. A negative
+     * return means nothing was started; the core then runs the request on
+     * its worker pool instead */
+    int (*read_async)(void *backend_data, void *handle, void *buf, size_t count,
+                      off_t offset, vfs_async_done_t done, void *arg);
+    int (*write_async)(void *backend_data, void *handle, const void *buf, size_t count,
+                       off_t offset, vfs_async_done_t done, void *arg);
+    /* Optional; the host fd behind handle, for splicing data at explicit
+     * offsets, or -EOPNOTSUPP if the handle cannot be used that way */
+    int (*get_fd)(void *backend_data, void *handle);
+    /* Optional; a read of count bytes at offset was made on the get_fd fd
+     * instead of through read, for backends that watch read patterns */
+    void (*note_read)(void *backend_data, void *handle, off_t offset, size_t count);
+    /* Optional; copy len bytes between two handles of this backend without
+     * passing the data through the caller (reflink or in-kernel copy).
+     * Returns the bytes copied, short only at the end of the source;
+     * -EOPNOTSUPP/-EXDEV make the core copy through a buffer instead */
+    ssize_t (*copy_range)(void *backend_data, void *handle_in, off_t off_in,
+                          void *handle_out, off_t off_out, size_t len);
     
     /* Metadata operations */
     int (*stat)(void *backend_data, const char *relpath, struct stat *st);
-    int (*readdir)(void *backend_data, const char *relpath, void *buf, void *filler);
+    /* Directory streams. readdir lists dir from cookie offset (0: the
+     * start) into a filler with the FUSE3 fuse_fill_dir_t signature,
+     * passing each entry's cookie as off, until the filler returns
+     * non-zero; a later call with an entry's cookie resumes after it.
+     * See VFS_READDIR_PLUS for flags */
+    int (*opendir)(void *backend_data, const char *relpath, void **dir);
+    int (*readdir)(void *backend_data, void *dir, void *buf, void *filler, off_t offset,
+                   int flags);
+    int (*releasedir)(void *backend_data, void *dir);
+    int (*mkdir)(void *backend_data, const char *relpath, mode_t mode);
 } vfs_backend_ops_t;
 
 /* ----------------------------------
  * Inode structure
  * ---------------------------------- */
+/* Backend handle replaced by a wider one; closed when the inode dies */
+typedef struct vfs_retired_handle {
+    void *handle;
+    struct vfs_retired_handle *next;
+} vfs_retired_handle_t;
+
+/*
+ * Inodes and dentries carry no per-object lock: reference counts are
+ * atomics and the remaining mutable fields are guarded by a striped lock
+ * table in vfs_core.c. Fields the lookup and I/O paths touch on every call
+ * sit in the first cache line.
+ */
 typedef struct vfs_inode {
+    /* hot */
     uint64_t        ino;            /* inode number */
+    off_t           size;
     mode_t          mode;
+    _Atomic int     refcount;
     uid_t           uid;
     gid_t           gid;
-    off_t           size;
+    void           *backend_handle; /* opaque backend data, shared by opens with
+                                       the same status flags */
+    int             backend_flags;  /* access mode and status flags (O_APPEND,
+                                       O_SYNC, ...) backend_handle was opened with */
+    struct vfs_mount *mount;        /* set for inodes hashed in the inode table */
+    uint64_t        attr_expires;   /* cached attributes valid until (monotonic ns) */
 
-    int             refcount;       /* protected by lock */
-    void           *backend_handle; /* opaque backend data */
+    /* Backend identity, the inode table's key */
+    dev_t           backend_dev;
+    ino_t           backend_ino;
+    struct vfs_inode *hash_next;
+    vfs_retired_handle_t *retired;
 
-    pthread_mutex_t lock;           /* protects inode fields */
+    /* Cached backend attributes beyond mode/uid/gid/size */
+    uint32_t        nlink;
+    uint32_t        blksize;
+    uint64_t        blocks;
+    uint64_t        rdev;
+    struct timespec atime;
+    struct timespec mtime;
+    struct timespec ctime;
 } vfs_inode_t;
 
 /* ----------------------------------
  * Dentry structure
  * ---------------------------------- */
+#define VFS_DNAME_INLINE 32     /* names shorter than this live in the dentry */
+
 typedef struct vfs_dentry {
-    char *name;
+    /* hot: everything a lookup step reads */
+    char *name;                 /* inline_name, or heap copy for long names */
+    uint32_t name_len;          /* strlen(name), cached for dcache compares */
+    uint32_t name_hash;         /* vfs_name_hash(name), cached */
     struct vfs_dentry *parent;
     vfs_inode_t *inode;
-    pthread_mutex_t lock;
 
-    /* Child pointers (simple singly-linked tree) */
+    /* Child pointers (tree; siblings form an hlist for O(1) unlink) */
     struct vfs_dentry *child;   /* first child */
     struct vfs_dentry *sibling; /* next sibling */
+
+    /* Dentry cache linkage (global hash keyed by parent + name) */
+    _Atomic(struct vfs_dentry *) hash_next;
+
+    /* Pins: open handles, in-flight lookups and linked children.
+     * Negative once the shrinker has claimed the entry. */
+    _Atomic int refcount;
+    uint16_t flags;             /* DENTRY_* state bits, owned by the dcache */
+    uint8_t reclaimable;        /* backend-backed: may be evicted and looked up again */
+
+    struct vfs_dentry **sibling_pprev; /* link pointing at us, NULL if unlinked */
+
+    /* Negative dentries (inode == NULL) cache a failed backend lookup */
+    uint64_t neg_expires;       /* CLOCK_MONOTONIC ns after which to re-check */
+
+    struct vfs_dentry *lru_prev; /* LRU of unused entries, NULL when not on it */
+    struct vfs_dentry *lru_next;
+
+    char inline_name[VFS_DNAME_INLINE];
 } vfs_dentry_t;
 
 /* ----------------------------------
@@ -82,6 +175,11 @@ typedef struct vfs_mount {
     void *backend_data;          /* backend-specific private data */
 
     vfs_dentry_t *root_dentry;   /* root of mount */
+    uint32_t mount_id;           /* derived from mountpoint + backend root */
+    unsigned int flags;          /* VFS_MOUNT_* */
+    _Atomic int open_handles;    /* file handles bound to this mount */
+    _Atomic int users;           /* operations between lookup and return */
+    int unmounting;              /* hidden from lookups; under the mount lock */
 
     struct vfs_mount *next;      /* linked list pointer */
 } vfs_mount_entry_t;
@@ -110,6 +208,17 @@ int vfs_mount_destroy(vfs_mount_entry_t *m);
 /* Public mount API */
 int vfs_mount_backend(const char *mountpoint, const char *backend_root, 
                       const char *backend_type);
+
+/*
+ * Mount flags:
+ *   VFS_MOUNT_STABLE_INO - derive inode numbers from (mount id, backend
+ *   st_dev, st_ino) instead of allocating them, so they stay the same
+ *   across remounts and kernel attribute caches remain valid.
+ */
+#define VFS_MOUNT_STABLE_INO 0x1
+
+int vfs_mount_backend_flags(const char *mountpoint, const char *backend_root,
+                            const char *backend_type, unsigned int flags);
 int vfs_unmount_backend(const char *mountpoint);
 
 /* Register a backend with the VFS */
@@ -123,7 +232,20 @@ vfs_inode_t* vfs_inode_create(uint64_t ino, mode_t mode,
 void vfs_inode_acquire(vfs_inode_t *inode);
 void vfs_inode_release(vfs_inode_t *inode);
 
-/* Release a dentry reference (frees orphaned dentries) */
+/*
+ * Backend inodes are shared through an inode table keyed by (mount,
+ * backend st_dev, st_ino) and cache the backend's attributes for ttl_ms,
+ * so repeated stats of a file are answered from memory.
+ * 0 always asks the backend. Default: 1000 ms.
+ */
+void vfs_set_attr_ttl_ms(unsigned int ttl_ms);
+unsigned int vfs_get_attr_ttl_ms(void);
+
+/* Allocation counters of the inode and dentry slab caches (see vfs_slab.h) */
+struct vfs_slab_stats;
+void vfs_get_slab_stats(struct vfs_slab_stats *inodes, struct vfs_slab_stats *dentries);
+
+/* Drop a dentry reference; unused backend entries go on the dcache LRU */
 void vfs_dentry_release(vfs_dentry_t *dentry);
 
 /* ----------------------------------
@@ -140,6 +262,90 @@ void vfs_dentry_remove_child(vfs_dentry_t *parent, vfs_dentry_t *child);
 
 void vfs_dentry_destroy_tree(vfs_dentry_t *root);
 
+/* ----------------------------------
+ * Dentry cache
+ * ---------------------------------- */
+/*
+ * Children linked with vfs_dentry_add_child() are also entered into a
+ * global hash table keyed by (parent, name), so looking up one component
+ * costs O(1) regardless of how many siblings the parent has.
+ *
+ * vfs_resolve_path() first walks the cache without taking any lock,
+ * validating per-bucket sequence counters, and only falls back to the
+ * locked walk after repeated concurrent modifications.
+ */
+typedef struct vfs_dcache_stats {
+    size_t   entries;        /* hashed dentries */
+    size_t   buckets;
+    uint64_t rcu_retries;    /* optimistic walks restarted */
+    uint64_t rcu_fallbacks;  /* walks that gave up and took locks */
+    uint64_t backend_lookups;/* misses sent to the backend's stat */
+
+    /* Memory footprint (see vfs_dcache_set_budget) */
+    size_t   dentries;       /* allocated dentries, hashed or not */
+    size_t   dentries_peak;
+    size_t   inodes;
+    size_t   inodes_peak;
+    size_t   unused;         /* dentries on the LRU */
+    size_t   bytes;          /* approximate memory held by dentries + inodes */
+    uint64_t evictions;      /* dentries reclaimed by the shrinker */
+} vfs_dcache_stats_t;
+
+uint32_t vfs_name_hash(const char *name, size_t len);
+
+/* Find the child `name` (len bytes, not necessarily NUL-terminated) of parent.
+ * Returns NULL if it is not cached. */
+vfs_dentry_t *vfs_dcache_lookup(const vfs_dentry_t *parent,
+                                const char *name, size_t len);
+
+/* Enable (default) or disable the lockless walk; disabling forces locking */
+void vfs_dcache_set_rcu_walk(int enabled);
+void vfs_dcache_get_stats(vfs_dcache_stats_t *out);
+
+/*
+ * Negative dentries: a lookup the backend answers with ENOENT is cached
+ * for ttl_ms so repeated probes of missing names stay in memory.
+ * 0 disables negative caching. Default: 1000 ms.
+ */
+void vfs_set_negative_ttl_ms(unsigned int ttl_ms);
+unsigned int vfs_get_negative_ttl_ms(void);
+
+/*
+ * Memory budget: once dentries + inodes exceed `bytes`, unused
+ * backend-backed leaf dentries are evicted oldest first (in-memory
+ * mounts are never evicted). 0 means unlimited. Default: 64 MiB.
+ */
+void vfs_dcache_set_budget(size_t bytes);
+size_t vfs_dcache_get_budget(void);
+
+/* Evict up to nr unused dentries now; returns how many were evicted */
+size_t vfs_dcache_shrink(size_t nr);
+
+/* ----------------------------------
+ * Path helpers (allocation free)
+ * ---------------------------------- */
+#define VFS_PATH_MAX 4096
+
+/*
+ * vfs_path_normalize():
+ *   writes the canonical form of absolute `path` into `out` (collapses
+ *   "//", drops ".", resolves ".." lexically). Returns the length written,
+ *   -EINVAL for a relative path or -ENAMETOOLONG if out is too small.
+ */
+int vfs_path_normalize(const char *path, char *out, size_t out_size);
+
+/*
+ * Component iterator: yields pointer+length views into the path, so
+ * callers can walk components without copying or tokenizing.
+ */
+typedef struct vfs_path_iter {
+    const char *p;
+} vfs_path_iter_t;
+
+void vfs_path_iter_init(vfs_path_iter_t *it, const char *path);
+/* Returns 1 and fills name/len for the next component, 0 at the end */
+int vfs_path_iter_next(vfs_path_iter_t *it, const char **name, size_t *len);
+
 /* ----------------------------------
  * Path resolution (Day 3)
  * ---------------------------------- */
@@ -148,8 +354,11 @@ void vfs_dentry_destroy_tree(vfs_dentry_t *root);
  *   - pure in-memory resolution
  *   - normalizes path
  *   - matches longest mountpoint prefix
- *   - walks/creates dentries
- *   - returns final dentry
+ *   - walks cached dentries, consulting the backend on a miss
+ *   - returns final dentry, or -ENOENT (possibly from a negative dentry)
+ *
+ *   The dentry is not pinned: entries of backend mounts may be evicted by
+ *   the shrinker once the caller lets go of them.
  */
 int vfs_resolve_path(const char *path, vfs_dentry_t **out);
 
@@ -168,10 +377,112 @@ int vfs_open(const char *path, int flags);
 int vfs_close(int fh);
 ssize_t vfs_read(int fh, void *buf, size_t count, off_t offset);
 ssize_t vfs_write(int fh, const void *buf, size_t count, off_t offset);
+/* Scatter/gather I/O at offset; like preadv/pwritev, a short transfer
+ * returns the bytes moved so far */
+ssize_t vfs_readv(int fh, const struct iovec *iov, int iovcnt, off_t offset);
+ssize_t vfs_writev(int fh, const struct iovec *iov, int iovcnt, off_t offset);
+int vfs_fsync(int fh, int datasync);
+/* Zero-copy transfers: the host fd behind fh, to splice at explicit
+ * offsets, if fh was opened for access (R_OK and/or W_OK); else -EBADF.
+ * -EOPNOTSUPP when there is none (in-memory files, O_DIRECT handles,
+ * backends without get_fd): use vfs_read/vfs_write. The fd is valid while
+ * fh is open. Writes made through it are reported with vfs_fd_written,
+ * reads with vfs_fd_read */
+int vfs_get_fd(int fh, int access);
+void vfs_fd_written(int fh, off_t offset, ssize_t written);
+void vfs_fd_read(int fh, off_t offset, size_t count);
+/* Server-side copy, like copy_file_range(2): len bytes from fh_in at
+ * off_in to fh_out at off_out, handed to the backend when both handles
+ * live on the same mount, else copied through a buffer. Returns the bytes
+ * copied (short at the end of the source) or -errno; flags must be 0 */
+ssize_t vfs_copy_range(int fh_in, off_t off_in, int fh_out, off_t off_out, size_t len,
+                       int flags);
 int vfs_stat(const char *path, struct stat *st);
-int vfs_readdir(const char *path, void *buf, void *filler, off_t offset, void *fi);
+/* Directory listing into a FUSE3-style filler. Entries carry st_ino and
+ * the file type; with VFS_READDIR_PLUS (FUSE_READDIR_PLUS) the backend
+ * also fetches full attributes and flags those entries VFS_FILL_DIR_PLUS
+ * (FUSE_FILL_DIR_PLUS) */
+#define VFS_READDIR_PLUS  0x1
+#define VFS_FILL_DIR_PLUS 0x2
+int vfs_readdir(const char *path, void *buf, void *filler, off_t offset, void *fi, int flags);
+/* Directory streams: vfs_opendir returns a handle holding the open
+ * directory (release it with vfs_closedir). Each entry is passed to the
+ * filler with a cookie as its off; vfs_readdir_fh from that cookie resumes
+ * right after the entry, and offset 0 starts over. Continuing where the
+ * previous call stopped costs no re-enumeration. vfs_readdir takes the
+ * same cookies but opens the directory afresh on every call */
+int vfs_opendir(const char *path);
+int vfs_readdir_fh(int fh, void *buf, void *filler, off_t offset, int flags);
+int vfs_closedir(int fh);
 int vfs_permission_check(const char *path, uid_t uid, gid_t gid, int mask);
 
+/* ----------------------------------
+ * Asynchronous I/O
+ * ---------------------------------- */
+/* Start a read, write or stat and return at once. 0 means the request was
+ * accepted and done(arg, result) will be called exactly once; -errno means
+ * it was rejected and done will not be called. done runs on a VFS worker
+ * or a backend completion thread, possibly before the submitting call has
+ * returned. It may submit more requests but should not block for long.
+ * buf and st must stay valid, and fh open, until done has run. */
+int vfs_read_async(int fh, void *buf, size_t count, off_t offset,
+                   vfs_async_done_t done, void *arg);
+int vfs_write_async(int fh, const void *buf, size_t count, off_t offset,
+                    vfs_async_done_t done, void *arg);
+int vfs_stat_async(const char *path, struct stat *st, vfs_async_done_t done, void *arg);
+
+/* Wait until every accepted request's callback has returned (not from a callback) */
+void vfs_async_drain(void);
+
+/* Worker threads for requests without a native backend path (default 8).
+ * Drains and restarts the pool; -EINVAL outside 1..256 */
+int vfs_async_set_workers(int n);
+
+/* ----------------------------------
+ * Batches
+ * ---------------------------------- */
+typedef enum {
+    VFS_BATCH_OPEN,             /* path, flags -> handle */
+    VFS_BATCH_CLOSE,            /* fh */
+    VFS_BATCH_READ,             /* fh, buf, count, offset -> bytes read */
+    VFS_BATCH_WRITE,            /* fh, buf, count, offset -> bytes written */
+    VFS_BATCH_FSYNC,            /* fh, flags != 0 for datasync */
+    VFS_BATCH_STAT,             /* path, st */
+    VFS_BATCH_MKDIR,            /* path, mode */
+} vfs_batch_opcode_t;
+
+/* In an op's fh: the handle returned by op n of the same batch */
+#define VFS_BATCH_FH(n) (-1 - (n))
+
+typedef struct vfs_batch_op {
+    int opcode;
+    const char *path;
+    int flags;
+    mode_t mode;
+    int fh;
+    void *buf;
+    size_t count;
+    off_t offset;
+    struct stat *st;
+    ssize_t result;             /* out: what the single call would return */
+} vfs_batch_op_t;
+
+/* Stop at the first failed op; the rest get -ECANCELED */
+#define VFS_BATCH_STOP_ON_ERROR 0x1
+
+/*
+ * Run ops in order and fill in each result. An op whose VFS_BATCH_FH
+ * source failed gets -ECANCELED. Consecutive path operations in one
+ * directory resolve it once. Reads and writes on a backend with native
+ * async transfers go out together without waiting for each other, so
+ * their order among themselves is not defined. Fsync, stat and open with
+ * O_TRUNC wait for the writes in flight to their file; a close waits for
+ * its handle's transfers but may run after later ops, and ops that use
+ * the handle again see it closed. Handles still open at the end stay
+ * open. Returns how many ops succeeded, or -EINVAL.
+ */
+int vfs_submit_batch(vfs_batch_op_t *ops, int nops, int flags);
+
 /* ----------------------------------
  * FUSE-compatible API extensions
  * ---------------------------------- */
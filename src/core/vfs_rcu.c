@@ -0,0 +1,197 @@
+/*
+ * Epoch-based RCU for lockless VFS lookups.
+ *
+ * Each reader thread owns a cache-line sized record holding the global epoch
+ * it observed when entering its outermost read-side section (0 when idle).
+ * A grace period bumps the global epoch and waits until no record still
+ * holds an older, non-zero epoch. Readers only ever write their own record,
+ * so concurrent lookups do not share any written cache line.
+ */
+
+#include "vfs_rcu.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define RCU_DEFER_BATCH 128
+
+typedef struct rcu_reader {
+    _Atomic uint64_t epoch;         /* 0 = quiescent */
+    _Atomic int in_use;             /* owned by a live thread */
+    struct rcu_reader *next;        /* registry link, never unlinked */
+    char pad[64 - sizeof(uint64_t) - sizeof(int) - sizeof(void *)];
+} __attribute__((aligned(64))) rcu_reader_t;
+
+typedef struct rcu_deferred {
+    void *obj;
+    void (*fn)(void *);
+    struct rcu_deferred *next;
+} rcu_deferred_t;
+
+static _Atomic uint64_t g_epoch = 1;
+static _Atomic(rcu_reader_t *) g_readers = NULL;
+
+static pthread_key_t g_reader_key;
+static pthread_once_t g_key_once = PTHREAD_ONCE_INIT;
+
+static __thread rcu_reader_t *tls_reader;
+static __thread unsigned tls_depth;
+
+static pthread_mutex_t g_defer_lock = PTHREAD_MUTEX_INITIALIZER;
+static rcu_deferred_t *g_defer_head;
+static size_t g_defer_count;
+
+/* -------------------------------------------------------------------------- */
+/* Reader registration                                                        */
+/* -------------------------------------------------------------------------- */
+
+static void reader_release(void *arg)
+{
+    rcu_reader_t *r = arg;
+    atomic_store_explicit(&r->epoch, 0, memory_order_release);
+    atomic_store_explicit(&r->in_use, 0, memory_order_release);
+}
+
+static void make_key(void)
+{
+    pthread_key_create(&g_reader_key, reader_release);
+}
+
+static rcu_reader_t *reader_get(void)
+{
+    if (tls_reader)
+        return tls_reader;
+
+    pthread_once(&g_key_once, make_key);
+
+    /* Reuse a record left behind by an exited thread */
+    rcu_reader_t *r;
+    for (r = atomic_load_explicit(&g_readers, memory_order_acquire); r; r = r->next) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&r->in_use, &expected, 1))
+            break;
+    }
+
+    if (!r) {
+        r = aligned_alloc(64, sizeof(*r));
+        if (!r)
+            return NULL;
+        atomic_init(&r->epoch, 0);
+        atomic_init(&r->in_use, 1);
+        rcu_reader_t *head = atomic_load_explicit(&g_readers, memory_order_relaxed);
+        do {
+            r->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&g_readers, &head, r,
+                                                        memory_order_release,
+                                                        memory_order_relaxed));
+    }
+
+    pthread_setspecific(g_reader_key, r);
+    tls_reader = r;
+    return r;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Read side                                                                  */
+/* -------------------------------------------------------------------------- */
+
+void vfs_rcu_read_lock(void)
+{
+    if (tls_depth++ > 0)
+        return;
+
+    /* Registration only allocates once per thread; a reader cannot proceed
+     * unprotected, so wait out transient memory pressure. */
+    rcu_reader_t *r;
+    while (!(r = reader_get()))
+        sched_yield();
+
+    atomic_store(&r->epoch, atomic_load(&g_epoch));
+    /* Order the epoch publication before any pointer loads that follow */
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void vfs_rcu_read_unlock(void)
+{
+    if (--tls_depth > 0)
+        return;
+    atomic_store_explicit(&tls_reader->epoch, 0, memory_order_release);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Grace periods                                                              */
+/* -------------------------------------------------------------------------- */
+
+void vfs_rcu_synchronize(void)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t target = atomic_fetch_add(&g_epoch, 1) + 1;
+
+    for (rcu_reader_t *r = atomic_load_explicit(&g_readers, memory_order_acquire);
+         r; r = r->next) {
+        for (;;) {
+            uint64_t e = atomic_load(&r->epoch);
+            if (e == 0 || e >= target)
+                break;
+            sched_yield();
+        }
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+static void run_deferred(rcu_deferred_t *list)
+{
+    while (list) {
+        rcu_deferred_t *next = list->next;
+        list->fn(list->obj);
+        free(list);
+        list = next;
+    }
+}
+
+void vfs_rcu_defer_free(void *obj, void (*fn)(void *))
+{
+    if (!obj || !fn)
+        return;
+
+    rcu_deferred_t *n = malloc(sizeof(*n));
+    if (!n) {
+        vfs_rcu_synchronize();
+        fn(obj);
+        return;
+    }
+    n->obj = obj;
+    n->fn = fn;
+
+    rcu_deferred_t *batch = NULL;
+    pthread_mutex_lock(&g_defer_lock);
+    n->next = g_defer_head;
+    g_defer_head = n;
+    if (++g_defer_count >= RCU_DEFER_BATCH) {
+        batch = g_defer_head;
+        g_defer_head = NULL;
+        g_defer_count = 0;
+    }
+    pthread_mutex_unlock(&g_defer_lock);
+
+    if (batch) {
+        vfs_rcu_synchronize();
+        run_deferred(batch);
+    }
+}
+
+void vfs_rcu_barrier(void)
+{
+    pthread_mutex_lock(&g_defer_lock);
+    rcu_deferred_t *batch = g_defer_head;
+    g_defer_head = NULL;
+    g_defer_count = 0;
+    pthread_mutex_unlock(&g_defer_lock);
+
+    if (batch) {
+        vfs_rcu_synchronize();
+        run_deferred(batch);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef VFS_RCU_H
+#define VFS_RCU_H
+
+/*
+ * Minimal epoch-based read-copy-update for the VFS core.
+ *
+ * Readers bracket lockless traversals with vfs_rcu_read_lock()/unlock();
+ * the calls nest and never block. Writers unlink an object first and then
+ * hand it to vfs_rcu_defer_free(), which releases it only once every reader
+ * that could still see it has left its read-side section.
+ *
+ * vfs_rcu_synchronize() and vfs_rcu_barrier() wait for readers and must
+ * never be called from inside a read-side section.
+ */
+
+void vfs_rcu_read_lock(void);
+void vfs_rcu_read_unlock(void);
+
+/* Wait until all read-side sections that started before the call finished */
+void vfs_rcu_synchronize(void);
+
+/* Queue obj for fn(obj) after a grace period; frees run in batches */
+void vfs_rcu_defer_free(void *obj, void (*fn)(void *));
+
+/* Run every queued free now (waits for a grace period first) */
+void vfs_rcu_barrier(void);
+
+#endif /* VFS_RCU_H */
@@ -0,0 +1,201 @@
+/*
+ * Slab caches with per-thread magazines.
+ *
+ * Fast path: pop/push on the calling thread's magazine for the cache.
+ * Slow path (once per SLAB_MAG_SIZE operations): swap the magazine with
+ * the depot, or carve a fresh batch of objects from the current chunk.
+ */
+
+#include "vfs_slab.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SLAB_MAG_SIZE   64
+#define SLAB_CHUNK_SIZE (256 * 1024)
+#define SLAB_MAX_CACHES 8
+
+typedef struct vfs_slab_magazine {
+    struct vfs_slab_magazine *next;
+    unsigned n;
+    void *objs[SLAB_MAG_SIZE];
+} slab_magazine_t;
+
+static vfs_slab_cache_t *g_caches[SLAB_MAX_CACHES];
+static _Atomic int g_ncaches;
+static _Atomic int g_bypass;
+
+static pthread_key_t g_mag_key;
+static pthread_once_t g_key_once = PTHREAD_ONCE_INIT;
+
+static __thread slab_magazine_t *tls_mag[SLAB_MAX_CACHES];
+static __thread int tls_registered;
+
+/* -------------------------------------------------------------------------- */
+/* Depot                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static void depot_put_locked(vfs_slab_cache_t *c, slab_magazine_t *m)
+{
+    slab_magazine_t **list = m->n ? &c->full : &c->empty;
+    m->next = *list;
+    *list = m;
+}
+
+/* Hand a dying thread's magazines back so other threads can use them */
+static void thread_release(void *arg)
+{
+    (void)arg;
+    int n = atomic_load(&g_ncaches);
+    for (int i = 0; i < n; i++) {
+        slab_magazine_t *m = tls_mag[i];
+        if (!m)
+            continue;
+        vfs_slab_cache_t *c = g_caches[i];
+        pthread_mutex_lock(&c->lock);
+        depot_put_locked(c, m);
+        pthread_mutex_unlock(&c->lock);
+        tls_mag[i] = NULL;
+    }
+}
+
+static void make_key(void)
+{
+    pthread_key_create(&g_mag_key, thread_release);
+}
+
+static void thread_register(void)
+{
+    pthread_once(&g_key_once, make_key);
+    /* any non-NULL value makes the destructor run */
+    pthread_setspecific(g_mag_key, (void *)1);
+    tls_registered = 1;
+}
+
+static slab_magazine_t *magazine_new(void)
+{
+    slab_magazine_t *m = malloc(sizeof(*m));
+    if (m) {
+        m->next = NULL;
+        m->n = 0;
+    }
+    return m;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Public API                                                                 */
+/* -------------------------------------------------------------------------- */
+
+int vfs_slab_init(vfs_slab_cache_t *c, const char *name, size_t objsize)
+{
+    int id = atomic_fetch_add(&g_ncaches, 1);
+    if (id >= SLAB_MAX_CACHES) {
+        atomic_fetch_sub(&g_ncaches, 1);
+        return -ENOSPC;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->name = name;
+    c->objsize = (objsize + 15) & ~(size_t)15;
+    c->id = id;
+    pthread_mutex_init(&c->lock, NULL);
+    g_caches[id] = c;
+    return 0;
+}
+
+/* Refill an empty magazine from the depot or from the chunk. Caller holds c->lock. */
+static slab_magazine_t *refill_locked(vfs_slab_cache_t *c, slab_magazine_t *m)
+{
+    if (c->full) {
+        slab_magazine_t *f = c->full;
+        c->full = f->next;
+        if (m)
+            depot_put_locked(c, m);
+        return f;
+    }
+
+    if (!m && !(m = magazine_new()))
+        return NULL;
+
+    while (m->n < SLAB_MAG_SIZE) {
+        if (c->chunk_cur + c->objsize > c->chunk_end) {
+            char *chunk = aligned_alloc(64, SLAB_CHUNK_SIZE);
+            if (!chunk)
+                break;
+            c->chunk_cur = chunk;
+            c->chunk_end = chunk + SLAB_CHUNK_SIZE;
+            atomic_fetch_add_explicit(&c->chunks, 1, memory_order_relaxed);
+        }
+        m->objs[m->n++] = c->chunk_cur;
+        c->chunk_cur += c->objsize;
+    }
+    return m;
+}
+
+void *vfs_slab_alloc(vfs_slab_cache_t *c)
+{
+    atomic_fetch_add_explicit(&c->allocs, 1, memory_order_relaxed);
+    if (atomic_load_explicit(&g_bypass, memory_order_relaxed))
+        return calloc(1, c->objsize);
+
+    slab_magazine_t *m = tls_mag[c->id];
+    if (!m || !m->n) {
+        if (!tls_registered)
+            thread_register();
+        pthread_mutex_lock(&c->lock);
+        m = refill_locked(c, m);
+        pthread_mutex_unlock(&c->lock);
+        tls_mag[c->id] = m;
+        if (!m || !m->n)
+            return NULL;
+    }
+
+    void *obj = m->objs[--m->n];
+    memset(obj, 0, c->objsize);
+    return obj;
+}
+
+void vfs_slab_free(vfs_slab_cache_t *c, void *obj)
+{
+    if (!obj)
+        return;
+    atomic_fetch_add_explicit(&c->frees, 1, memory_order_relaxed);
+    if (atomic_load_explicit(&g_bypass, memory_order_relaxed)) {
+        free(obj);
+        return;
+    }
+
+    slab_magazine_t *m = tls_mag[c->id];
+    if (!m || m->n == SLAB_MAG_SIZE) {
+        if (!tls_registered)
+            thread_register();
+        pthread_mutex_lock(&c->lock);
+        if (m)
+            depot_put_locked(c, m);         /* full: park it */
+        m = c->empty;
+        if (m)
+            c->empty = m->next;
+        pthread_mutex_unlock(&c->lock);
+        if (!m && !(m = magazine_new())) {
+            /* cannot track it: leak one object rather than crash */
+            tls_mag[c->id] = NULL;
+            return;
+        }
+        m->n = 0;
+        tls_mag[c->id] = m;
+    }
+    m->objs[m->n++] = obj;
+}
+
+void vfs_slab_get_stats(const vfs_slab_cache_t *c, vfs_slab_stats_t *out)
+{
+    out->allocs = atomic_load(&c->allocs);
+    out->frees = atomic_load(&c->frees);
+    out->chunks = atomic_load(&c->chunks);
+    out->chunk_bytes = (size_t)out->chunks * SLAB_CHUNK_SIZE;
+}
+
+void vfs_slab_set_bypass(int on)
+{
+    atomic_store(&g_bypass, on ? 1 : 0);
+}
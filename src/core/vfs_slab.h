@@ -0,0 +1,59 @@
+#ifndef VFS_SLAB_H
+#define VFS_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/*
+ * Fixed-size object caches for hot VFS metadata (inodes, dentries).
+ *
+ * Objects are carved out of large chunks, so building a big tree costs a
+ * handful of malloc calls instead of one or two per entry. Each thread
+ * keeps a magazine (a small stack of free objects) per cache, so alloc and
+ * free normally touch no shared state; full and empty magazines are traded
+ * with a per-cache depot under a mutex. Memory is recycled within a cache
+ * and never handed back to the system.
+ */
+
+struct vfs_slab_magazine;
+
+typedef struct vfs_slab_cache {
+    const char *name;
+    size_t      objsize;        /* rounded up to 16 bytes */
+    int         id;             /* index of this thread's magazine */
+
+    pthread_mutex_t lock;       /* protects the depot and the chunk */
+    struct vfs_slab_magazine *full;
+    struct vfs_slab_magazine *empty;
+    char       *chunk_cur;
+    char       *chunk_end;
+
+    _Atomic uint64_t allocs;
+    _Atomic uint64_t frees;
+    _Atomic uint64_t chunks;    /* chunks taken from malloc */
+} vfs_slab_cache_t;
+
+typedef struct vfs_slab_stats {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t chunks;
+    size_t   chunk_bytes;       /* memory reserved from the system */
+} vfs_slab_stats_t;
+
+/* Set up a statically allocated cache. Returns 0, or -ENOSPC when too
+ * many caches exist. Safe to call once per cache. */
+int vfs_slab_init(vfs_slab_cache_t *c, const char *name, size_t objsize);
+
+/* Zeroed object, or NULL when out of memory */
+void *vfs_slab_alloc(vfs_slab_cache_t *c);
+void vfs_slab_free(vfs_slab_cache_t *c, void *obj);
+
+void vfs_slab_get_stats(const vfs_slab_cache_t *c, vfs_slab_stats_t *out);
+
+/* Route every cache straight to calloc/free (for A/B measurements).
+ * Only flip this while no objects are allocated. */
+void vfs_slab_set_bypass(int on);
+
+#endif /* VFS_SLAB_H */
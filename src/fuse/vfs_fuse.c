@@ -13,12 +13,17 @@
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 /* FUSE init: call into vfs_init and return opaque pointer */
 void *my_fuse_init(struct fuse_conn_info *conn, struct fuse_config *cfg)
 {
-    (void)conn;
-    (void)cfg;
+    /* Report the VFS inode numbers (stable ones where mounts ask for it) */
+    cfg->use_ino = 1;
+    /* Let the kernel splice request and reply data, so read_buf/write_buf
+     * can move file pages between /dev/fuse and the backend fd */
+    conn->want |= conn->capable & (FUSE_CAP_SPLICE_READ | FUSE_CAP_SPLICE_WRITE |
+                                   FUSE_CAP_SPLICE_MOVE);
     fprintf(stderr, "[vfs_fuse] init\n");
     int r = vfs_init();
     if (r != 0)
@@ -49,11 +54,17 @@ struct fuse_operations my_fuse_ops = {
     .getattr = my_fuse_getattr,
     .read = my_fuse_read,
     .write = my_fuse_write,
+    .read_buf = my_fuse_read_buf,
+    .write_buf = my_fuse_write_buf,
+    .opendir = my_fuse_opendir,
     .readdir = my_fuse_readdir,
+    .releasedir = my_fuse_releasedir,
     .mkdir = my_fuse_mkdir,
     .mknod = my_fuse_mknod,
     .open = my_fuse_open,
     .create = my_fuse_create,
+    .release = my_fuse_release,
+    .copy_file_range = my_fuse_copy_file_range,
     .readlink = my_fuse_readlink,
     .symlink = my_fuse_symlink,
     .init = my_fuse_init,
@@ -94,8 +105,8 @@ int my_fuse_getattr(const char *path, struct stat *stbuf, struct fuse_file_info
 /* read */
 int my_fuse_read(const char *path, char *buf, size_t size, off_t offset, struct fuse_file_info *fi)
 {
-    (void)fi;
-    ssize_t r = vfs_read(path, buf, size, offset);
+    (void)path;
+    ssize_t r = vfs_read((int)fi->fh, buf, size, offset);
     if (r >= 0)
         return (int)r; /* FUSE expects non-negative number of bytes */
     return vfs_to_fuse_err((int)r);
@@ -104,23 +115,125 @@ int my_fuse_read(const char *path, char *buf, size_t size, off_t offset, struct
 /* write */
 int my_fuse_write(const char *path, const char *buf, size_t size, off_t offset, struct fuse_file_info *fi)
 {
-    (void)fi;
-    ssize_t r = vfs_write(path, buf, size, offset);
+    (void)path;
+    ssize_t r = vfs_write((int)fi->fh, buf, size, offset);
     if (r >= 0)
         return (int)r;
     return vfs_to_fuse_err((int)r);
 }
 
+/* read_buf: hand libfuse the backend fd and offset instead of the data, so
+ * the reply is spliced from the page cache to /dev/fuse without passing
+ * through our memory; the read is reported to the backend so it still
+ * sees the access pattern. Files without an fd are read into a buffer.
+ * libfuse frees the bufvec (and any memory buffer in it). */
+int my_fuse_read_buf(const char *path, struct fuse_bufvec **bufp, size_t size, off_t offset,
+                     struct fuse_file_info *fi)
+{
+    (void)path;
+    int fh = (int)fi->fh;
+    struct fuse_bufvec *src = malloc(sizeof(*src));
+    if (!src)
+        return -ENOMEM;
+    *src = FUSE_BUFVEC_INIT(size);
+
+    int fd = vfs_get_fd(fh, R_OK);
+    if (fd >= 0)
+    {
+        src->buf[0].flags = FUSE_BUF_IS_FD | FUSE_BUF_FD_SEEK;
+        src->buf[0].fd = fd;
+        src->buf[0].pos = offset;
+        vfs_fd_read(fh, offset, size);
+        *bufp = src;
+        return 0;
+    }
+    if (fd != -EOPNOTSUPP)
+    {
+        free(src);
+        return vfs_to_fuse_err(fd);
+    }
+
+    void *mem = malloc(size ? size : 1);
+    ssize_t r = mem ? vfs_read(fh, mem, size, offset) : -ENOMEM;
+    if (r < 0)
+    {
+        free(mem);
+        free(src);
+        return vfs_to_fuse_err((int)r);
+    }
+    src->buf[0].mem = mem;
+    src->buf[0].size = (size_t)r;
+    *bufp = src;
+    return 0;
+}
+
+/* write_buf: splice the request data (a pipe when the kernel spliced it to
+ * us) straight into the backend fd. Files without an fd are gathered into
+ * a buffer and written with vfs_write. */
+int my_fuse_write_buf(const char *path, struct fuse_bufvec *buf, off_t offset,
+                      struct fuse_file_info *fi)
+{
+    (void)path;
+    int fh = (int)fi->fh;
+    size_t size = fuse_buf_size(buf);
+    struct fuse_bufvec dst = FUSE_BUFVEC_INIT(size);
+    ssize_t r;
+
+    int fd = vfs_get_fd(fh, W_OK);
+    if (fd >= 0)
+    {
+        dst.buf[0].flags = FUSE_BUF_IS_FD | FUSE_BUF_FD_SEEK;
+        dst.buf[0].fd = fd;
+        dst.buf[0].pos = offset;
+        r = fuse_buf_copy(&dst, buf, FUSE_BUF_SPLICE_NONBLOCK);
+        vfs_fd_written(fh, offset, r);
+    }
+    else if (fd == -EOPNOTSUPP)
+    {
+        dst.buf[0].mem = malloc(size ? size : 1);
+        if (!dst.buf[0].mem)
+            return -ENOMEM;
+        r = fuse_buf_copy(&dst, buf, 0);
+        if (r > 0)
+            r = vfs_write(fh, dst.buf[0].mem, (size_t)r, offset);
+        free(dst.buf[0].mem);
+    }
+    else
+    {
+        r = fd;
+    }
+    if (r >= 0)
+        return (int)r;
+    return vfs_to_fuse_err((int)r);
+}
+
+/* opendir: the directory stream travels in fi->fh to readdir and releasedir */
+int my_fuse_opendir(const char *path, struct fuse_file_info *fi)
+{
+    int r = vfs_opendir(path);
+    if (r < 0)
+        return vfs_to_fuse_err(r);
+    fi->fh = (uint64_t)r;
+    return 0;
+}
+
 /* readdir -- FUSE3 adds the enum fuse_readdir_flags parameter at the end.
  * We pass through to the VFS layer which is expected to call the provided
- * filler callback. We ignore flags for now (forwarding is a reasonable default).
+ * filler callback. Entries go out with their cookies, so each call carries
+ * on from the offset the kernel got with the last entry it took instead
+ * of listing the directory again. FUSE_READDIR_PLUS is forwarded, so
+ * attributes are only fetched per entry when the kernel wants them.
  */
 int my_fuse_readdir(const char *path, void *buf, fuse_fill_dir_t filler,
                     off_t offset, struct fuse_file_info *fi, enum fuse_readdir_flags flags)
 {
-    (void)flags;
     fprintf(stderr, "[vfs_fuse] readdir: %s\n", path);
-    int r = vfs_readdir(path, buf, (void*)filler, offset, (void*)fi);
+    int vflags = (flags & FUSE_READDIR_PLUS) ? VFS_READDIR_PLUS : 0;
+    int r;
+    if (fi && fi->fh)
+        r = vfs_readdir_fh((int)fi->fh, buf, (void*)filler, offset, vflags);
+    else
+        r = vfs_readdir(path, buf, filler, offset, fi, vflags);
     fprintf(stderr, "[vfs_fuse] readdir result: %d\n", r);
     if (r == 0)
         return 0;
@@ -145,24 +258,62 @@ int my_fuse_mknod(const char *path, mode_t mode, dev_t rdev)
     return vfs_to_fuse_err(r);
 }
 
-/* open */
+/* open: the VFS handle travels in fi->fh to read/write and release */
 int my_fuse_open(const char *path, struct fuse_file_info *fi)
 {
-    int r = vfs_open(path, fi);
-    if (r == 0)
-        return 0;
-    return vfs_to_fuse_err(r);
+    int r = vfs_open(path, fi->flags);
+    if (r < 0)
+        return vfs_to_fuse_err(r);
+    fi->fh = (uint64_t)r;
+    return 0;
 }
 
 /* create */
 int my_fuse_create(const char *path, mode_t mode, struct fuse_file_info *fi)
 {
     int r = vfs_create(path, mode, fi);
+    if (r < 0)
+        return vfs_to_fuse_err(r);
+    fi->fh = (uint64_t)r;
+    return 0;
+}
+
+/* release: last close of the kernel's file */
+int my_fuse_release(const char *path, struct fuse_file_info *fi)
+{
+    (void)path;
+    int r = vfs_close((int)fi->fh);
     if (r == 0)
         return 0;
     return vfs_to_fuse_err(r);
 }
 
+/* releasedir */
+int my_fuse_releasedir(const char *path, struct fuse_file_info *fi)
+{
+    (void)path;
+    int r = vfs_closedir((int)fi->fh);
+    if (r == 0)
+        return 0;
+    return vfs_to_fuse_err(r);
+}
+
+/* copy_file_range: the copy happens below the VFS, so the data never
+ * comes up through the kernel to us (and back down) */
+ssize_t my_fuse_copy_file_range(const char *path_in, struct fuse_file_info *fi_in,
+                                off_t offset_in, const char *path_out,
+                                struct fuse_file_info *fi_out, off_t offset_out,
+                                size_t size, int flags)
+{
+    (void)path_in;
+    (void)path_out;
+    ssize_t r = vfs_copy_range((int)fi_in->fh, offset_in, (int)fi_out->fh, offset_out,
+                               size, flags);
+    if (r >= 0)
+        return r;
+    return vfs_to_fuse_err((int)r);
+}
+
 /* readlink
  * Our VFS readlink returns ssize_t: number of bytes written or negative errno.
  * FUSE expects 0 on success (the link target is placed into buf), or -errno.
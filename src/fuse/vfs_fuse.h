@@ -15,12 +15,23 @@ extern "C" {
 int my_fuse_getattr(const char *path, struct stat *st, struct fuse_file_info *fi);
 int my_fuse_read(const char *path, char *buf, size_t size, off_t offset, struct fuse_file_info *fi);
 int my_fuse_write(const char *path, const char *buf, size_t size, off_t offset, struct fuse_file_info *fi);
+int my_fuse_read_buf(const char *path, struct fuse_bufvec **bufp, size_t size, off_t offset,
+                     struct fuse_file_info *fi);
+int my_fuse_write_buf(const char *path, struct fuse_bufvec *buf, off_t offset,
+                      struct fuse_file_info *fi);
+int my_fuse_opendir(const char *path, struct fuse_file_info *fi);
 int my_fuse_readdir(const char *path, void *buf, fuse_fill_dir_t filler,
                     off_t offset, struct fuse_file_info *fi, enum fuse_readdir_flags flags);
+int my_fuse_releasedir(const char *path, struct fuse_file_info *fi);
 int my_fuse_mkdir(const char *path, mode_t mode);
 int my_fuse_mknod(const char *path, mode_t mode, dev_t rdev);
 int my_fuse_open(const char *path, struct fuse_file_info *fi);
 int my_fuse_create(const char *path, mode_t mode, struct fuse_file_info *fi);
+int my_fuse_release(const char *path, struct fuse_file_info *fi);
+ssize_t my_fuse_copy_file_range(const char *path_in, struct fuse_file_info *fi_in,
+                                off_t offset_in, const char *path_out,
+                                struct fuse_file_info *fi_out, off_t offset_out,
+                                size_t size, int flags);
 int my_fuse_readlink(const char *path, char *buf, size_t size);
 int my_fuse_symlink(const char *target, const char *linkpath);
 void *my_fuse_init(struct fuse_conn_info *conn, struct fuse_config *cfg);
@@ -37,21 +48,39 @@ int vfs_destroy(void);
 /* Metadata */
 int vfs_getattr(const char *path, struct stat *stbuf);
 
-/* File I/O */
-ssize_t vfs_read(const char *path, char *buf, size_t size, off_t offset);
-ssize_t vfs_write(const char *path, const char *buf, size_t size, off_t offset);
+/* File I/O on the handle open/create left in fi->fh */
+ssize_t vfs_read(int fh, void *buf, size_t count, off_t offset);
+ssize_t vfs_write(int fh, const void *buf, size_t count, off_t offset);
+
+/* Zero-copy: the backend fd behind fh, or -EOPNOTSUPP to fall back to
+ * vfs_read/vfs_write; reads and writes through it are reported back */
+int vfs_get_fd(int fh, int access);
+void vfs_fd_written(int fh, off_t offset, ssize_t written);
+void vfs_fd_read(int fh, off_t offset, size_t count);
+
+/* Server-side copy between two open handles: bytes copied or negative errno */
+ssize_t vfs_copy_range(int fh_in, off_t off_in, int fh_out, off_t off_out, size_t len,
+                       int flags);
 
 /* Directory read */
+#define VFS_READDIR_PLUS  0x1     /* FUSE_READDIR_PLUS: attributes wanted */
 int vfs_readdir(const char *path, void *buf, fuse_fill_dir_t filler,
-                off_t offset, struct fuse_file_info *fi);
+                off_t offset, struct fuse_file_info *fi, int flags);
+
+/* Directory streams: a handle (> 0) or negative errno; readdir resumes
+ * from the cookie the filler was given with an entry */
+int vfs_opendir(const char *path);
+int vfs_readdir_fh(int fh, void *buf, void *filler, off_t offset, int flags);
+int vfs_closedir(int fh);
 
 /* Node creation */
 int vfs_mkdir(const char *path, mode_t mode);
 int vfs_mknod(const char *path, mode_t mode, dev_t rdev);
 
-/* Open/create */
-int vfs_open(const char *path, struct fuse_file_info *fi);
+/* Open/create: a handle (> 0) or negative errno */
+int vfs_open(const char *path, int flags);
 int vfs_create(const char *path, mode_t mode, struct fuse_file_info *fi);
+int vfs_close(int fh);
 
 /* Symlinks */
 ssize_t vfs_readlink(const char *path, char *buf, size_t size);
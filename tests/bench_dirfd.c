@@ -0,0 +1,110 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Backend path resolution at increasing depth: stat of a file DEPTH
+ * directories below the backend root, through posix_stat (fstatat on the
+ * cached parent directory fd) against stat() on the joined absolute path,
+ * which is what the backend issued before and walks every component.
+ * posix_open+close is the same comparison for opens.
+ */
+
+#define BENCH_DIR "/tmp/vfs_bench_dirfd/some/host/prefix"
+#define OPS       200000
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ns per operation, or -1 on errors */
+static double run(int id, const char *rel, const char *full, int mode)
+{
+    struct stat st;
+    int errors = 0;
+    double t0 = now_s();
+    for (int i = 0; i < OPS; i++) {
+        switch (mode) {
+        case 0:
+            errors += stat(full, &st) != 0;
+            break;
+        case 1:
+            errors += posix_stat(id, rel, &st) != 0;
+            break;
+        case 2: {
+            int fd = open(full, O_RDONLY);
+            errors += fd < 0 || close(fd) != 0;
+            break;
+        }
+        default: {
+            int h = posix_open(id, rel, O_RDONLY, 0);
+            errors += h < 0 || posix_close(id, h) != 0;
+            break;
+        }
+        }
+    }
+    double secs = now_s() - t0;
+    return errors ? -1 : secs * 1e9 / OPS;
+}
+
+int main(void)
+{
+    static const int depths[] = { 1, 4, 16, 32 };
+    system("rm -rf /tmp/vfs_bench_dirfd && mkdir -p " BENCH_DIR);
+
+    int id = posix_backend_init(BENCH_DIR);
+    if (id < 0) {
+        fprintf(stderr, "posix_backend_init failed\n");
+        return 1;
+    }
+
+    printf("=== backend path resolution, %d ops per row ===\n\n", OPS);
+    printf("%-6s  %14s  %14s  %14s  %14s\n", "depth", "stat(path)", "posix_stat",
+           "open(path)", "posix_open");
+
+    char rel[1024] = "", full[2048];
+    int made = 0;
+    for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+        for (; made < depths[d]; made++) {
+            size_t n = strlen(rel);
+            snprintf(rel + n, sizeof(rel) - n, "%sdirectory_level_%02d", n ? "/" : "", made);
+            if (posix_mkdir(id, rel, 0755) != 0) {
+                fprintf(stderr, "mkdir failed\n");
+                return 1;
+            }
+        }
+        char file[1100];
+        snprintf(file, sizeof(file), "%s/file", rel);
+        int h = posix_create(id, file, 0644);
+        if (h < 0 || posix_close(id, h) != 0) {
+            fprintf(stderr, "create failed\n");
+            return 1;
+        }
+        snprintf(full, sizeof(full), "%s/%s", BENCH_DIR, file);
+
+        double r[4];
+        for (int mode = 0; mode < 4; mode++) {
+            r[mode] = run(id, file, full, mode);
+            if (r[mode] < 0) {
+                fprintf(stderr, "I/O error\n");
+                return 1;
+            }
+        }
+        printf("%-6d  %11.0f ns  %11.0f ns  %11.0f ns  %11.0f ns\n", depths[d],
+               r[0], r[1], r[2], r[3]);
+        fflush(stdout);
+    }
+
+    posix_backend_shutdown(id);
+    system("rm -rf /tmp/vfs_bench_dirfd");
+    return 0;
+}
@@ -0,0 +1,94 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * Hot small files: open, read 4 KiB and close one of FILES files picked
+ * at random, OPS times, through the posix backend with the open fd cache
+ * off and at sizes below and above the working set. Host syscalls per
+ * operation are counted from the cache counters:
+ *
+ *   off    openat + pread + close
+ *   hit    pread
+ *   miss   openat + fstat + pread, and a close when the entry is evicted
+ *   check  one fstatat when an entry is past its TTL
+ */
+
+#define BENCH_DIR "/tmp/vfs_bench_fd_cache"
+#define FILES     64
+#define FILESZ    4096
+#define OPS       500000
+
+static char g_buf[FILESZ];
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void)
+{
+    static const int sizes[] = { 0, 16, 32, 128 };
+    system("rm -rf " BENCH_DIR " && mkdir -p " BENCH_DIR);
+    for (int i = 0; i < FILES; i++) {
+        char cmd[128];
+        snprintf(cmd, sizeof(cmd), "head -c %d /dev/urandom > " BENCH_DIR "/small%02d", FILESZ, i);
+        system(cmd);
+    }
+
+    int id = posix_backend_init(BENCH_DIR);
+    if (id < 0) {
+        fprintf(stderr, "posix_backend_init failed\n");
+        return 1;
+    }
+
+    printf("=== open/read/close of %d hot %d-byte files, %d ops per row ===\n\n",
+           FILES, FILESZ, OPS);
+    printf("%-10s  %10s  %8s  %12s  %14s\n", "cache", "per op", "hit rate", "syscalls/op",
+           "syscalls saved");
+
+    char names[FILES][16];
+    for (int i = 0; i < FILES; i++)
+        snprintf(names[i], sizeof(names[i]), "small%02d", i);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        posix_fd_cache_set_size(id, 0);
+        posix_fd_cache_set_size(id, sizes[s]);
+        uint64_t h0, m0, c0, h1, m1, c1;
+        posix_fd_cache_stats(id, &h0, &m0, &c0);
+
+        srand(1);
+        int errors = 0;
+        double t0 = now_s();
+        for (int i = 0; i < OPS; i++) {
+            int h = posix_open(id, names[rand() % FILES], O_RDONLY, 0);
+            errors += h < 0 || posix_read(id, h, g_buf, FILESZ, 0) != FILESZ ||
+                      posix_close(id, h) != 0;
+        }
+        double secs = now_s() - t0;
+        if (errors) {
+            fprintf(stderr, "I/O error\n");
+            return 1;
+        }
+
+        posix_fd_cache_stats(id, &h1, &m1, &c1);
+        double hits = (double)(h1 - h0), misses = (double)(m1 - m0), checks = (double)(c1 - c0);
+        double calls = sizes[s] ? OPS + 3 * misses + checks : 3.0 * OPS;
+        char label[16];
+        snprintf(label, sizeof(label), sizes[s] ? "%d" : "off", sizes[s]);
+        printf("%-10s  %7.0f ns  %7.1f%%  %12.2f  %13.1f%%\n", label, secs * 1e9 / OPS,
+               100 * hits / OPS, calls / OPS, 100 * (1 - calls / (3.0 * OPS)));
+        fflush(stdout);
+    }
+
+    posix_backend_shutdown(id);
+    system("rm -rf " BENCH_DIR);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "../src/core/vfs_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+/*
+ * Concurrent lookup microbenchmark.
+ *
+ * All threads resolve paths below the same hot prefix (/data/shared/...),
+ * which used to bounce the prefix dentries' mutexes between cores. Runs
+ * the same load with the lockless walk enabled and disabled and prints
+ * per-thread throughput; with the lockless walk it should stay flat as
+ * threads are added (up to the number of cores).
+ */
+
+#define RUN_MS     500
+#define NUM_DIRS   16
+#define NUM_FILES  64
+
+static const int thread_counts[] = { 1, 2, 4, 8, 16 };
+
+static volatile int g_stop;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static vfs_dentry_t *add_node(vfs_dentry_t *parent, const char *name, mode_t mode) {
+    vfs_dentry_t *d = vfs_dcache_lookup(parent, name, strlen(name));
+    if (d)
+        return d;
+    vfs_inode_t *ino = vfs_inode_create(0, mode, 0, 0, 0);
+    d = vfs_dentry_create(name, parent, ino);
+    vfs_inode_release(ino);
+    vfs_dentry_add_child(parent, d);
+    return d;
+}
+
+static void build_tree(void) {
+    vfs_dentry_t *root = NULL;
+    char name[32];
+    vfs_resolve_path("/", &root);
+    vfs_dentry_t *shared = add_node(add_node(root, "data", S_IFDIR | 0755),
+                                    "shared", S_IFDIR | 0755);
+    for (int i = 0; i < NUM_DIRS; i++) {
+        snprintf(name, sizeof(name), "dir_%d", i);
+        vfs_dentry_t *dir = add_node(shared, name, S_IFDIR | 0755);
+        for (int j = 0; j < NUM_FILES; j++) {
+            snprintf(name, sizeof(name), "file_%d", j);
+            add_node(dir, name, S_IFREG | 0644);
+        }
+    }
+}
+
+static void *lookup_worker(void *arg) {
+    unsigned long *ops = arg;
+    unsigned seed = (unsigned)(uintptr_t)arg;
+    char path[128];
+    unsigned long n = 0;
+
+    while (!g_stop) {
+        snprintf(path, sizeof(path), "/data/shared/dir_%d/file_%d",
+                 rand_r(&seed) % NUM_DIRS, rand_r(&seed) % NUM_FILES);
+        vfs_dentry_t *d = NULL;
+        if (vfs_resolve_path(path, &d) != 0 || !d) {
+            fprintf(stderr, "FAIL: lookup of %s\n", path);
+            exit(1);
+        }
+        n++;
+    }
+    *ops = n;
+    return NULL;
+}
+
+static double run(int nthreads) {
+    pthread_t tids[16];
+    unsigned long ops[16] = { 0 };
+
+    g_stop = 0;
+    for (int i = 0; i < nthreads; i++)
+        pthread_create(&tids[i], NULL, lookup_worker, &ops[i]);
+
+    double t0 = now_s();
+    struct timespec ts = { RUN_MS / 1000, (RUN_MS % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+    g_stop = 1;
+
+    unsigned long total = 0;
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(tids[i], NULL);
+        total += ops[i];
+    }
+    return total / (now_s() - t0);
+}
+
+int main(void) {
+    printf("=== Concurrent Lookup Benchmark (%d ms per run) ===\n\n", RUN_MS);
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    build_tree();
+
+    printf("%8s  %22s  %22s\n", "threads", "locked (Kops/s/thread)", "lockless (Kops/s/thread)");
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        int n = thread_counts[i];
+
+        vfs_dcache_set_rcu_walk(0);
+        double locked = run(n);
+        vfs_dcache_set_rcu_walk(1);
+        double lockless = run(n);
+
+        printf("%8d  %22.1f  %22.1f\n", n, locked / n / 1e3, lockless / n / 1e3);
+    }
+
+    vfs_dcache_stats_t st;
+    vfs_dcache_get_stats(&st);
+    printf("\ndcache: %zu entries, %zu buckets, %llu retries, %llu fallbacks\n",
+           st.entries, st.buckets,
+           (unsigned long long)st.rcu_retries, (unsigned long long)st.rcu_fallbacks);
+
+    vfs_shutdown();
+    return 0;
+}
@@ -0,0 +1,164 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+/*
+ * Cold-cache reads of a 256 MiB file through the posix backend, with
+ * read-pattern tracking off (bare pread, readahead left to the kernel)
+ * and on:
+ *
+ *   sequential  one pass in 128 KiB reads
+ *   random      RANDOM_READS 4 KiB reads at random block offsets
+ *
+ * The page cache is dropped before each run (echo 1 > drop_caches when
+ * permitted, else fadvise(DONTNEED) on the file), and what the run left
+ * in it is measured with mincore(). The kernel's own readahead for the
+ * device is printed too: the larger it is, the less there is to gain.
+ */
+
+#define BENCH_DIR    "/tmp/vfs_bench_readahead"
+#define FILE_SIZE    (256L << 20)
+#define SEQ_CHUNK    (128 * 1024)
+#define RANDOM_READS 4000
+
+static char g_buf[SEQ_CHUNK];
+static int g_drop_caches = 1;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void drop_cache(int fd)
+{
+    fdatasync(fd);
+    if (g_drop_caches) {
+        sync();
+        int p = open("/proc/sys/vm/drop_caches", O_WRONLY);
+        g_drop_caches = p >= 0 && write(p, "1", 1) == 1;
+        if (p >= 0)
+            close(p);
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+/* MiB of the file in the page cache */
+static double cached_mib(int fd)
+{
+    static unsigned char vec[FILE_SIZE / 4096];
+    void *p = mmap(NULL, FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        return -1;
+    long n = 0;
+    if (mincore(p, FILE_SIZE, vec) == 0)
+        for (long i = 0; i < FILE_SIZE / 4096; i++)
+            n += vec[i] & 1;
+    munmap(p, FILE_SIZE);
+    return n * 4096.0 / (1 << 20);
+}
+
+static long device_readahead_kb(int fd)
+{
+    struct stat st;
+    char path[128];
+    long kb = -1;
+    if (fstat(fd, &st) != 0)
+        return -1;
+    for (int part = 0; part < 2 && kb < 0; part++) {
+        snprintf(path, sizeof(path), "/sys/dev/block/%u:%u/%squeue/read_ahead_kb",
+                 major(st.st_dev), minor(st.st_dev), part ? "../" : "");
+        FILE *f = fopen(path, "r");
+        if (f) {
+            if (fscanf(f, "%ld", &kb) != 1)
+                kb = -1;
+            fclose(f);
+        }
+    }
+    return kb;
+}
+
+/* seconds for one run, or -1 on errors */
+static double run(int id, int host, int random)
+{
+    drop_cache(host);
+    int h = posix_open(id, "big", O_RDONLY, 0);
+    if (h < 0)
+        return -1;
+    srand(1);
+    double t0 = now_s();
+    if (random) {
+        for (int i = 0; i < RANDOM_READS; i++) {
+            off_t off = (off_t)(rand() % (FILE_SIZE / 4096)) * 4096;
+            if (posix_read(id, h, g_buf, 4096, off) != 4096)
+                return -1;
+        }
+    } else {
+        for (off_t off = 0; off < FILE_SIZE; off += SEQ_CHUNK)
+            if (posix_read(id, h, g_buf, SEQ_CHUNK, off) != SEQ_CHUNK)
+                return -1;
+    }
+    double secs = now_s() - t0;
+    posix_close(id, h);
+    return secs;
+}
+
+int main(void)
+{
+    system("rm -rf " BENCH_DIR " && mkdir -p " BENCH_DIR);
+    int host = open(BENCH_DIR "/big", O_CREAT | O_RDWR, 0644);
+    if (host < 0) {
+        fprintf(stderr, "create failed\n");
+        return 1;
+    }
+    memset(g_buf, 'r', sizeof(g_buf));
+    for (long off = 0; off < FILE_SIZE; off += SEQ_CHUNK)
+        if (write(host, g_buf, SEQ_CHUNK) != SEQ_CHUNK) {
+            fprintf(stderr, "write failed\n");
+            return 1;
+        }
+
+    int id = posix_backend_init(BENCH_DIR);
+    if (id < 0) {
+        fprintf(stderr, "posix_backend_init failed\n");
+        return 1;
+    }
+
+    drop_cache(host);
+    printf("=== cold reads of a %ld MiB file, cache dropped with %s, device readahead %ld KiB ===\n\n",
+           FILE_SIZE >> 20, g_drop_caches ? "drop_caches" : "fadvise(DONTNEED)",
+           device_readahead_kb(host));
+    printf("%-10s  %-8s  %14s  %12s\n", "pattern", "tracking", "throughput", "cached after");
+
+    for (int random = 0; random < 2; random++)
+        for (int on = 0; on < 2; on++) {
+            posix_readahead_set_window(id, on ? 8 << 20 : 0);
+            double secs = run(id, host, random);
+            if (secs < 0) {
+                fprintf(stderr, "read error\n");
+                return 1;
+            }
+            if (random)
+                printf("%-10s  %-8s  %8.1f us/op", "random", on ? "on" : "off",
+                       secs * 1e6 / RANDOM_READS);
+            else
+                printf("%-10s  %-8s  %9.0f MB/s", "sequential", on ? "on" : "off",
+                       FILE_SIZE / secs / 1e6);
+            printf("  %8.1f MiB\n", cached_mib(host));
+            fflush(stdout);
+        }
+
+    posix_backend_shutdown(id);
+    close(host);
+    system("rm -rf " BENCH_DIR);
+    return 0;
+}
@@ -0,0 +1,188 @@
+#define _GNU_SOURCE
+#include "../src/core/vfs_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+ * The FUSE daemon's data path for 1 GiB sequential reads and writes in
+ * 128 KiB requests (the default max_read/max_write), without a mount: a
+ * pipe stands in for /dev/fuse, the way libfuse uses one when the kernel
+ * splices requests and replies.
+ *
+ *   copy    read:  vfs_read into a buffer, write the buffer to the pipe
+ *           write: read the pipe into a buffer, vfs_write it
+ *   splice  read:  splice from vfs_get_fd's fd into the pipe (read_buf)
+ *           write: splice from the pipe into that fd (write_buf)
+ *
+ * The pipe is emptied into (or filled from) /dev/null and /dev/zero by
+ * splice on both paths, so the difference is the copies through user
+ * memory. "native" is a plain read()/write() loop on the backing file.
+ * Through a real mount the kernel still copies once between the page
+ * cache and the application, which no row here includes: the splice read
+ * row is the daemon's own cost, and it has no copy left to make.
+ */
+
+#define BENCH_DIR "/tmp/vfs_bench_splice"
+#define TOTAL     (1024L * 1024 * 1024)
+#define REQ       (128 * 1024)
+
+static char g_buf[REQ];
+static int g_pipe[2], g_null, g_zero;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Move n bytes between the pipe and /dev/null or /dev/zero */
+static int drain(size_t n)
+{
+    while (n) {
+        ssize_t r = splice(g_pipe[0], NULL, g_null, NULL, n, SPLICE_F_MOVE);
+        if (r <= 0)
+            return -1;
+        n -= (size_t)r;
+    }
+    return 0;
+}
+
+static int fill(size_t n)
+{
+    while (n) {
+        ssize_t r = splice(g_zero, NULL, g_pipe[1], NULL, n, SPLICE_F_MOVE);
+        if (r <= 0)
+            return -1;
+        n -= (size_t)r;
+    }
+    return 0;
+}
+
+/* One request's worth through the pipe; bytes moved or -1 */
+static ssize_t splice_req(int fd, off_t off, int is_write)
+{
+    loff_t pos = off;
+    size_t done = 0;
+    while (done < REQ) {
+        ssize_t r = is_write
+            ? splice(g_pipe[0], NULL, fd, &pos, REQ - done, SPLICE_F_MOVE)
+            : splice(fd, &pos, g_pipe[1], NULL, REQ - done, SPLICE_F_MOVE);
+        if (r <= 0)
+            return -1;
+        done += (size_t)r;
+    }
+    return (ssize_t)done;
+}
+
+/* MiB/s, or -1 on errors */
+static double run_vfs(const char *path, int is_write, int zero_copy)
+{
+    int fh = vfs_open(path, is_write ? O_WRONLY | O_CREAT : O_RDONLY);
+    if (fh < 0)
+        return -1;
+    int fd = zero_copy ? vfs_get_fd(fh, is_write ? W_OK : R_OK) : -1;
+    if (zero_copy && fd < 0) {
+        vfs_close(fh);
+        return -1;
+    }
+
+    int errors = 0;
+    double t0 = now_s();
+    for (off_t off = 0; off < TOTAL && !errors; off += REQ) {
+        ssize_t n;
+        if (is_write) {
+            if (fill(REQ) != 0)
+                errors++;
+            if (zero_copy) {
+                n = splice_req(fd, off, 1);
+                vfs_fd_written(fh, off, n);
+            } else {
+                n = read(g_pipe[0], g_buf, REQ) == REQ ? vfs_write(fh, g_buf, REQ, off) : -1;
+            }
+        } else {
+            if (zero_copy)
+                n = splice_req(fd, off, 0);
+            else
+                n = vfs_read(fh, g_buf, REQ, off) == REQ ? write(g_pipe[1], g_buf, REQ) : -1;
+            if (n == REQ && drain(REQ) != 0)
+                errors++;
+        }
+        if (n != REQ)
+            errors++;
+    }
+    double secs = now_s() - t0;
+    vfs_close(fh);
+    return errors ? -1 : TOTAL / secs / (1024 * 1024);
+}
+
+static double run_native(const char *path, int is_write)
+{
+    int fd = open(path, is_write ? O_WRONLY | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0)
+        return -1;
+    int errors = 0;
+    memset(g_buf, 'n', sizeof(g_buf));
+    double t0 = now_s();
+    for (off_t off = 0; off < TOTAL && !errors; off += REQ)
+        if ((is_write ? pwrite(fd, g_buf, REQ, off) : pread(fd, g_buf, REQ, off)) != REQ)
+            errors++;
+    double secs = now_s() - t0;
+    close(fd);
+    return errors ? -1 : TOTAL / secs / (1024 * 1024);
+}
+
+int main(void)
+{
+    system("rm -rf " BENCH_DIR " && mkdir -p " BENCH_DIR);
+    if (pipe(g_pipe) != 0 || fcntl(g_pipe[0], F_SETPIPE_SZ, REQ) < REQ) {
+        fprintf(stderr, "pipe setup failed\n");
+        return 1;
+    }
+    g_null = open("/dev/null", O_WRONLY);
+    g_zero = open("/dev/zero", O_RDONLY);
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    if (vfs_mount_backend("/p", BENCH_DIR, "posix") != 0 ||
+        vfs_mount_backend("/u", BENCH_DIR, "posix_uring") != 0) {
+        fprintf(stderr, "mount failed\n");
+        return 1;
+    }
+
+    printf("=== FUSE data path, 1 GiB sequential in %d KiB requests ===\n\n", REQ / 1024);
+    printf("%-12s %-6s  %12s  %12s  %12s\n", "backend", "op", "copy", "splice", "native");
+
+    /* creates the files and brings them into the page cache */
+    if (run_native(BENCH_DIR "/p", 1) < 0 || run_native(BENCH_DIR "/u", 1) < 0) {
+        fprintf(stderr, "I/O error\n");
+        return 1;
+    }
+    static const char *names[] = { "posix", "posix_uring" };
+    static const char *paths[] = { "/p/p", "/u/u" };
+    static const char *host[] = { BENCH_DIR "/p", BENCH_DIR "/u" };
+    for (int b = 0; b < 2; b++) {
+        for (int is_write = 0; is_write < 2; is_write++) {
+            double copy = run_vfs(paths[b], is_write, 0);
+            double zc = run_vfs(paths[b], is_write, 1);
+            double native = run_native(host[b], is_write);
+            if (copy < 0 || zc < 0 || native < 0) {
+                fprintf(stderr, "I/O error\n");
+                return 1;
+            }
+            printf("%-12s %-6s  %8.0f MB/s  %8.0f MB/s  %8.0f MB/s\n", names[b],
+                   is_write ? "write" : "read", copy, zc, native);
+            fflush(stdout);
+        }
+    }
+
+    vfs_shutdown();
+    system("rm -rf " BENCH_DIR);
+    return 0;
+}
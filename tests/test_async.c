@@ -0,0 +1,261 @@
+#define _GNU_SOURCE
+#include "../src/core/vfs_core.h"
+#include "../src/backends/backend_uring.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+/*
+ * Async I/O tests: vfs_read_async/vfs_write_async/vfs_stat_async on the
+ * worker pool (posix backend) and the native path (posix_uring), deep
+ * queues from one thread, callbacks that submit more work, rejected
+ * requests, and async and blocking callers sharing one ring.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_async"
+#define BLOCK       4096
+#define DEPTH       64
+#define CHAIN       200
+#define THREADS     4
+#define ROUNDS      20
+
+typedef struct {
+    _Atomic int calls;
+    ssize_t res;
+} req_t;
+
+static void on_done(void *arg, ssize_t result)
+{
+    req_t *r = arg;
+    r->res = result;
+    atomic_fetch_add(&r->calls, 1);
+}
+
+static void *mount_data(const char *mountpoint)
+{
+    for (vfs_mount_entry_t *m = mount_table_head; m; m = m->next)
+        if (!strcmp(m->mountpoint, mountpoint))
+            return m->backend_data;
+    return NULL;
+}
+
+/* DEPTH writes, then DEPTH reads, all in flight at once from this thread;
+ * NULL or the first check that failed */
+static const char *deep_queue(const char *path, char *wbuf, char *rbuf)
+{
+    static req_t reqs[DEPTH];
+    int fh = vfs_open(path, O_RDWR | O_CREAT);
+    if (fh <= 0)
+        return "open";
+
+    memset(reqs, 0, sizeof(reqs));
+    for (int i = 0; i < DEPTH; i++) {
+        memset(wbuf + (size_t)i * BLOCK, 'a' + i % 26, BLOCK);
+        if (vfs_write_async(fh, wbuf + (size_t)i * BLOCK, BLOCK, (off_t)i * BLOCK,
+                            on_done, &reqs[i]) != 0)
+            return "write_async accepted";
+    }
+    vfs_async_drain();
+    for (int i = 0; i < DEPTH; i++)
+        if (reqs[i].calls != 1 || reqs[i].res != BLOCK)
+            return "write completions";
+
+    /* the size was updated as the writes completed */
+    struct stat st;
+    if (vfs_stat(path, &st) != 0 || st.st_size != (off_t)DEPTH * BLOCK)
+        return "size after async writes";
+
+    memset(reqs, 0, sizeof(reqs));
+    memset(rbuf, 0, (size_t)DEPTH * BLOCK);
+    for (int i = 0; i < DEPTH; i++)
+        if (vfs_read_async(fh, rbuf + (size_t)i * BLOCK, BLOCK, (off_t)i * BLOCK,
+                           on_done, &reqs[i]) != 0)
+            return "read_async accepted";
+    vfs_async_drain();
+    for (int i = 0; i < DEPTH; i++)
+        if (reqs[i].calls != 1 || reqs[i].res != BLOCK)
+            return "read completions";
+    if (memcmp(wbuf, rbuf, (size_t)DEPTH * BLOCK))
+        return "data read back";
+    vfs_close(fh);
+    return NULL;
+}
+
+/* ---- a callback that submits the next read ---- */
+
+typedef struct {
+    int fh;
+    char buf[BLOCK];
+    _Atomic int left;
+    _Atomic int errors;
+} chain_t;
+
+static void chain_next(void *arg, ssize_t result)
+{
+    chain_t *c = arg;
+    if (result != BLOCK)
+        atomic_fetch_add(&c->errors, 1);
+    if (atomic_fetch_sub(&c->left, 1) > 1 &&
+        vfs_read_async(c->fh, c->buf, BLOCK, 0, chain_next, c) != 0)
+        atomic_fetch_add(&c->errors, 1);
+}
+
+/* ---- async and blocking callers on one ring ---- */
+
+typedef struct {
+    int id;
+    int errors;
+} worker_arg_t;
+
+static void *worker(void *p)
+{
+    worker_arg_t *a = p;
+    char path[64];
+    static _Thread_local char wbuf[DEPTH * BLOCK], rbuf[BLOCK];
+    req_t reqs[DEPTH];
+    snprintf(path, sizeof(path), "/u/mt%d", a->id);
+
+    int fh = vfs_open(path, O_RDWR | O_CREAT);
+    if (fh < 0) {
+        a->errors++;
+        return NULL;
+    }
+    for (int round = 0; round < ROUNDS; round++) {
+        memset(reqs, 0, sizeof(reqs));
+        for (int i = 0; i < DEPTH; i++) {
+            memset(wbuf + (size_t)i * BLOCK, 'A' + (i + round + a->id) % 26, BLOCK);
+            if (vfs_write_async(fh, wbuf + (size_t)i * BLOCK, BLOCK, (off_t)i * BLOCK,
+                                on_done, &reqs[i]) != 0)
+                a->errors++;
+        }
+        /* blocking reads interleaved with our own writes in flight (on
+         * the first round the blocks may not exist yet) */
+        for (int i = 0; i < 8; i++)
+            if (vfs_read(fh, rbuf, BLOCK, (off_t)i * BLOCK) < 0)
+                a->errors++;
+        for (int i = 0; i < DEPTH; i++)
+            while (atomic_load(&reqs[i].calls) == 0)
+                usleep(100);
+        for (int i = 0; i < DEPTH; i++)
+            if (reqs[i].res != BLOCK)
+                a->errors++;
+        if (vfs_read(fh, rbuf, BLOCK, (off_t)(DEPTH - 1) * BLOCK) != BLOCK ||
+            memcmp(rbuf, wbuf + (size_t)(DEPTH - 1) * BLOCK, BLOCK))
+            a->errors++;
+    }
+    vfs_close(fh);
+    return NULL;
+}
+
+int main(void)
+{
+    static char wbuf[DEPTH * BLOCK], rbuf[DEPTH * BLOCK];
+    printf("Running async I/O tests...\n");
+    test_dir_setup(BACKEND_DIR);
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    CHECK(vfs_mount_backend("/p", BACKEND_DIR, "posix") == 0, "mount posix");
+    CHECK(vfs_mount_backend("/u", BACKEND_DIR, "posix_uring") == 0, "mount posix_uring");
+    int native = posix_uring_active(mount_data("/u"));
+
+    /* Test 1: worker pool (the posix backend has no native async ops) */
+    const char *err = deep_queue("/p/pool", wbuf, rbuf);
+    CHECK(!err, err);
+    req_t sr = { 0 };
+    struct stat st;
+    CHECK(vfs_stat_async("/p/pool", &st, on_done, &sr) == 0, "stat_async accepted");
+    vfs_async_drain();
+    CHECK(sr.calls == 1 && sr.res == 0 && st.st_size == (off_t)DEPTH * BLOCK, "stat_async");
+    printf("  ✓ worker pool: %d reads and writes in flight from one thread\n", DEPTH);
+
+    /* Test 2: native path */
+    uint64_t rq0, rq1;
+    posix_uring_get_stats(mount_data("/u"), &rq0, NULL);
+    err = deep_queue("/u/native", wbuf, rbuf);
+    CHECK(!err, err);
+    posix_uring_get_stats(mount_data("/u"), &rq1, NULL);
+    if (native) {
+        CHECK(rq1 - rq0 >= 2 * DEPTH, "async transfers bypassed the ring");
+        printf("  ✓ posix_uring: %d reads and writes in flight through the ring\n", DEPTH);
+    } else {
+        printf("  ✓ posix_uring fallback: async requests served by the pool\n");
+    }
+
+    /* Test 3: rejected requests never call back; failures do */
+    req_t r = { 0 };
+    CHECK(vfs_read_async(12345, rbuf, BLOCK, 0, on_done, &r) == -EBADF, "bad handle");
+    CHECK(vfs_read_async(1, rbuf, BLOCK, 0, NULL, &r) == -EINVAL, "NULL callback");
+    int fh = vfs_open("/u/native", O_RDONLY);
+    CHECK(fh > 0, "open read-only");
+    CHECK(vfs_write_async(fh, wbuf, BLOCK, 0, on_done, &r) == -EBADF, "write on read-only");
+    CHECK(vfs_stat_async("/u/missing", &st, on_done, &r) == 0, "stat_async of a missing file");
+    vfs_async_drain();
+    CHECK(r.calls == 1 && r.res == -ENOENT, "missing file reported through the callback");
+    r = (req_t){ 0 };
+    CHECK(vfs_read_async(fh, rbuf, BLOCK, (off_t)DEPTH * BLOCK, on_done, &r) == 0 &&
+          (vfs_async_drain(), r.calls == 1 && r.res == 0), "async read at EOF");
+    printf("  ✓ rejected requests and errors\n");
+
+    /* Test 4: callbacks submitting the next request */
+    static chain_t chains[2];
+    chains[0] = (chain_t){ .fh = fh, .left = CHAIN };
+    int pfh = vfs_open("/p/pool", O_RDONLY);
+    chains[1] = (chain_t){ .fh = pfh, .left = CHAIN };
+    for (int i = 0; i < 2; i++)
+        CHECK(vfs_read_async(chains[i].fh, chains[i].buf, BLOCK, 0, chain_next, &chains[i]) == 0,
+              "start chain");
+    vfs_async_drain();
+    CHECK(chains[0].left == 0 && chains[1].left == 0 &&
+          chains[0].errors == 0 && chains[1].errors == 0, "chained completions");
+    vfs_close(pfh);
+    vfs_close(fh);
+    printf("  ✓ %d requests chained from completion callbacks\n", CHAIN);
+
+    /* Test 5: resizing the pool */
+    CHECK(vfs_async_set_workers(0) == -EINVAL, "zero workers");
+    CHECK(vfs_async_set_workers(2) == 0, "two workers");
+    err = deep_queue("/p/pool2", wbuf, rbuf);
+    CHECK(!err, err);
+    CHECK(vfs_async_set_workers(8) == 0, "back to eight workers");
+    printf("  ✓ pool resized\n");
+
+    /* Test 6: async and blocking callers sharing the ring */
+    pthread_t tids[THREADS];
+    worker_arg_t args[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        args[i] = (worker_arg_t){ .id = i };
+        pthread_create(&tids[i], NULL, worker, &args[i]);
+    }
+    int errors = 0;
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(tids[i], NULL);
+        errors += args[i].errors;
+    }
+    CHECK(errors == 0, "mixed async and blocking I/O");
+    printf("  ✓ %d threads mixing async and blocking I/O\n", THREADS);
+
+    /* Test 7: shutdown waits for requests in flight */
+    fh = vfs_open("/u/native", O_RDONLY);
+    memset(&r, 0, sizeof(r));
+    CHECK(vfs_read_async(fh, rbuf, BLOCK, 0, on_done, &r) == 0, "read before shutdown");
+    vfs_shutdown();
+    if (r.calls != 1 || r.res != BLOCK) {
+        fprintf(stderr, "FAIL: shutdown dropped a request in flight\n");
+        return 1;
+    }
+    printf("  ✓ shutdown drains requests in flight\n");
+
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All async I/O tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+#define _GNU_SOURCE
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Batch tests: vfs_submit_batch with handle dependencies on the posix
+ * backend (synchronous transfers) and posix_uring (transfers in flight
+ * together), shared directory lookups across directories and mount
+ * roots, failure propagation, and ordering around fsync/O_TRUNC/stat.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_batch"
+#define FILES       32
+#define CHUNK       1000
+
+static vfs_batch_op_t op_open(const char *path, int flags)
+{
+    return (vfs_batch_op_t){ .opcode = VFS_BATCH_OPEN, .path = path, .flags = flags };
+}
+
+static vfs_batch_op_t op_rw(int opcode, int fh, void *buf, size_t count, off_t off)
+{
+    return (vfs_batch_op_t){ .opcode = opcode, .fh = fh, .buf = buf, .count = count,
+                             .offset = off };
+}
+
+static vfs_batch_op_t op_fh(int opcode, int fh)
+{
+    return (vfs_batch_op_t){ .opcode = opcode, .fh = fh };
+}
+
+/* Create FILES files below dir with open/write/write/close quadruples,
+ * then read them back with stat/open/read/close; NULL or what failed */
+static const char *ingest(const char *dir)
+{
+    static char paths[FILES][64], data[FILES][2 * CHUNK], back[FILES][2 * CHUNK];
+    static struct stat st[FILES];
+    static vfs_batch_op_t ops[FILES * 4];
+    int n = 0;
+
+    for (int f = 0; f < FILES; f++) {
+        snprintf(paths[f], sizeof(paths[f]), "%s/in/f%02d", dir, f);
+        memset(data[f], 'a' + f % 26, CHUNK);
+        memset(data[f] + CHUNK, 'A' + f % 26, CHUNK);
+        int o = n;
+        ops[n++] = op_open(paths[f], O_WRONLY | O_CREAT | O_TRUNC);
+        ops[n++] = op_rw(VFS_BATCH_WRITE, VFS_BATCH_FH(o), data[f], CHUNK, 0);
+        ops[n++] = op_rw(VFS_BATCH_WRITE, VFS_BATCH_FH(o), data[f] + CHUNK, CHUNK, CHUNK);
+        ops[n++] = op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(o));
+    }
+    if (vfs_submit_batch(ops, n, 0) != n)
+        return "ingest batch";
+    for (int i = 0; i < n; i++) {
+        if (ops[i].opcode == VFS_BATCH_OPEN && ops[i].result <= 0)
+            return "open result";
+        if (ops[i].opcode == VFS_BATCH_WRITE && ops[i].result != CHUNK)
+            return "write result";
+        if (ops[i].opcode == VFS_BATCH_CLOSE && ops[i].result != 0)
+            return "close result";
+    }
+
+    n = 0;
+    for (int f = 0; f < FILES; f++) {
+        ops[n++] = (vfs_batch_op_t){ .opcode = VFS_BATCH_STAT, .path = paths[f], .st = &st[f] };
+        int o = n;
+        ops[n++] = op_open(paths[f], O_RDONLY);
+        ops[n++] = op_rw(VFS_BATCH_READ, VFS_BATCH_FH(o), back[f], sizeof(back[f]), 0);
+        ops[n++] = op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(o));
+    }
+    memset(back, 0, sizeof(back));
+    if (vfs_submit_batch(ops, n, 0) != n)
+        return "read-back batch";
+    for (int f = 0; f < FILES; f++) {
+        if (st[f].st_size != 2 * CHUNK || !S_ISREG(st[f].st_mode))
+            return "stat in batch";
+        if (ops[f * 4 + 2].result != 2 * CHUNK || memcmp(back[f], data[f], 2 * CHUNK))
+            return "data read back";
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    printf("Running batch tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    system("mkdir -p " BACKEND_DIR "/in " BACKEND_DIR "/other");
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    CHECK(vfs_mount_backend("/p", BACKEND_DIR, "posix") == 0, "mount posix");
+    CHECK(vfs_mount_backend("/u", BACKEND_DIR, "posix_uring") == 0, "mount posix_uring");
+
+    /* Test 1: small-file ingestion, then read back */
+    const char *err = ingest("/p");
+    CHECK(!err, err);
+    printf("  ✓ posix: open/write/write/close x%d, then stat/open/read/close\n", FILES);
+    err = ingest("/u");
+    CHECK(!err, err);
+    printf("  ✓ posix_uring: the same with transfers in flight together\n");
+
+    /* Test 2: paths alternating between directories and mount roots; the
+     * shared parent must not hide a mount rooted in it */
+    struct stat s1, s2, s3, s4;
+    vfs_batch_op_t mix[] = {
+        { .opcode = VFS_BATCH_STAT, .path = "/p/in/f00", .st = &s1 },
+        { .opcode = VFS_BATCH_STAT, .path = "/p/other", .st = &s2 },
+        { .opcode = VFS_BATCH_STAT, .path = "/p/in/../in/f01", .st = &s3 },
+        { .opcode = VFS_BATCH_STAT, .path = "/u", .st = &s4 },
+        { .opcode = VFS_BATCH_STAT, .path = "/p", .st = &s4 },
+        { .opcode = VFS_BATCH_STAT, .path = "/p/in/missing", .st = &s4 },
+        { .opcode = VFS_BATCH_MKDIR, .path = "/p/in/sub", .mode = 0755 },
+        { .opcode = VFS_BATCH_STAT, .path = "/p/in/sub", .st = &s4 },
+    };
+    CHECK(vfs_submit_batch(mix, 8, 0) == 7, "mixed path batch");
+    CHECK(S_ISREG(s1.st_mode) && S_ISDIR(s2.st_mode) && s3.st_size == 2 * CHUNK,
+          "stats across directories");
+    CHECK(mix[3].result == 0 && mix[4].result == 0, "mount roots");
+    CHECK(mix[5].result == -ENOENT, "missing file");
+    CHECK(mix[6].result == 0 && mix[7].result == 0 && S_ISDIR(s4.st_mode),
+          "mkdir then stat in the shared directory");
+    struct stat sm;
+    vfs_batch_op_t roots[] = {
+        { .opcode = VFS_BATCH_STAT, .path = "/dir1", .st = &sm },
+        { .opcode = VFS_BATCH_STAT, .path = "/u", .st = &s4 },
+    };
+    CHECK(vfs_submit_batch(roots, 2, 0) == 2 && S_ISDIR(s4.st_mode) && s4.st_ino != sm.st_ino,
+          "mountpoint next to an in-memory entry of /");
+    printf("  ✓ shared directory lookups across directories and mounts\n");
+
+    /* Test 3: failures cancel dependents; bad references are rejected */
+    char buf[16] = "x";
+    vfs_batch_op_t bad[] = {
+        op_open("/p/in/nope", O_RDONLY),
+        op_rw(VFS_BATCH_READ, VFS_BATCH_FH(0), buf, sizeof(buf), 0),
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(0)),
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(5)),        /* forward */
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(1)),        /* not an open */
+        op_open("/p/in/f00", O_RDONLY),
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(5)),
+    };
+    CHECK(vfs_submit_batch(bad, 7, 0) == 2, "success count");
+    CHECK(bad[0].result == -ENOENT && bad[1].result == -ECANCELED &&
+          bad[2].result == -ECANCELED, "dependents of a failed open");
+    CHECK(bad[3].result == -EINVAL && bad[4].result == -EINVAL, "bad handle references");
+    CHECK(bad[5].result > 0 && bad[6].result == 0, "later ops still run");
+
+    vfs_batch_op_t stop[] = {
+        op_open("/p/in/f00", O_RDONLY),
+        op_open("/p/in/nope", O_RDONLY),
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(0)),
+    };
+    CHECK(vfs_submit_batch(stop, 3, VFS_BATCH_STOP_ON_ERROR) == 1, "stop on error count");
+    CHECK(stop[1].result == -ENOENT && stop[2].result == -ECANCELED, "stop on error");
+    CHECK(vfs_close((int)stop[0].result) == 0, "handle left open by the batch");
+    CHECK(vfs_submit_batch(NULL, 1, 0) == -EINVAL && vfs_submit_batch(stop, -1, 0) == -EINVAL &&
+          vfs_submit_batch(NULL, 0, 0) == 0, "argument checks");
+    printf("  ✓ failures, cancelled dependents and stop-on-error\n");
+
+    /* Test 4: fsync, O_TRUNC and stat wait for transfers in flight */
+    static char big[64 * 1024];
+    memset(big, 'z', sizeof(big));
+    struct stat after_write, after_trunc;
+    vfs_batch_op_t order[] = {
+        op_open("/u/in/ordered", O_RDWR | O_CREAT),
+        op_rw(VFS_BATCH_WRITE, VFS_BATCH_FH(0), big, sizeof(big), 0),
+        op_rw(VFS_BATCH_WRITE, VFS_BATCH_FH(0), big, sizeof(big), sizeof(big)),
+        { .opcode = VFS_BATCH_FSYNC, .fh = VFS_BATCH_FH(0), .flags = 1 },
+        { .opcode = VFS_BATCH_STAT, .path = "/u/in/ordered", .st = &after_write },
+        op_open("/u/in/ordered", O_WRONLY | O_TRUNC),
+        { .opcode = VFS_BATCH_STAT, .path = "/u/in/ordered", .st = &after_trunc },
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(5)),
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(0)),
+    };
+    CHECK(vfs_submit_batch(order, 9, 0) == 9, "ordered batch");
+    CHECK(after_write.st_size == 2 * (off_t)sizeof(big), "stat after writes");
+    CHECK(after_trunc.st_size == 0, "O_TRUNC after writes");
+
+    /* a close held back by its transfer still orders before reuse */
+    char rb[16];
+    vfs_batch_op_t reuse[] = {
+        op_open("/u/in/ordered", O_RDWR),
+        op_rw(VFS_BATCH_WRITE, VFS_BATCH_FH(0), big, sizeof(big), 0),
+        op_fh(VFS_BATCH_CLOSE, VFS_BATCH_FH(0)),
+        op_rw(VFS_BATCH_READ, VFS_BATCH_FH(0), rb, sizeof(rb), 0),
+        { .opcode = VFS_BATCH_STAT, .path = "/u/in/ordered", .st = &after_write },
+    };
+    CHECK(vfs_submit_batch(reuse, 5, 0) == 4, "reuse batch");
+    CHECK(reuse[1].result == sizeof(big) && reuse[2].result == 0, "write and close");
+    CHECK(reuse[3].result == -EBADF, "read after close");
+    CHECK(after_write.st_size == sizeof(big), "stat after a deferred close");
+    printf("  ✓ fsync/O_TRUNC/stat/close ordered after transfers in flight\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All batch tests passed!\n");
+    return 0;
+}
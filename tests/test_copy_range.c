@@ -0,0 +1,133 @@
+#define _GNU_SOURCE
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Server-side copy tests: vfs_copy_range within a posix mount (whole-file
+ * clone, block-aligned and unaligned ranges, a source that ends early),
+ * the buffered fallback across mounts and for in-memory files, and the
+ * argument checks copy_file_range(2) makes.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_copy_range"
+#define SRC_SIZE    (4 * 1024 * 1024 + 1234)
+
+static char g_src[SRC_SIZE], g_back[SRC_SIZE];
+
+/* len bytes of path at offset match g_src at src_off */
+static int same(const char *path, off_t offset, off_t src_off, size_t len)
+{
+    int fh = vfs_open(path, O_RDONLY);
+    if (fh < 0)
+        return 0;
+    ssize_t n = vfs_read(fh, g_back, len, offset);
+    vfs_close(fh);
+    return n == (ssize_t)len && !memcmp(g_back, g_src + src_off, len);
+}
+
+static off_t size_of(const char *path)
+{
+    struct stat st;
+    return vfs_stat(path, &st) == 0 ? st.st_size : -1;
+}
+
+int main(void)
+{
+    printf("Running copy_range tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    for (int i = 0; i < SRC_SIZE; i++)
+        g_src[i] = (char)(i * 13 + i / 4096);
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    CHECK(vfs_mount_backend("/p", BACKEND_DIR, "posix") == 0, "mount posix");
+    CHECK(vfs_mount_backend("/u", BACKEND_DIR, "posix_uring") == 0, "mount posix_uring");
+
+    int src = vfs_open("/p/src", O_RDWR | O_CREAT);
+    CHECK(src > 0, "create source");
+    CHECK(vfs_write(src, g_src, SRC_SIZE, 0) == SRC_SIZE, "fill source");
+
+    /* Test 1: whole file, the reflink case where the fs supports it */
+    int dst = vfs_open("/p/whole", O_RDWR | O_CREAT);
+    CHECK(dst > 0, "create destination");
+    CHECK(vfs_copy_range(src, 0, dst, 0, SRC_SIZE, 0) == SRC_SIZE, "whole-file copy");
+    CHECK(size_of("/p/whole") == SRC_SIZE, "size after the copy");
+    CHECK(same("/p/whole", 0, 0, SRC_SIZE), "whole-file data");
+    vfs_close(dst);
+    printf("  ✓ whole file within a posix mount\n");
+
+    /* Test 2: aligned and unaligned ranges into the middle of a file */
+    dst = vfs_open("/p/ranges", O_RDWR | O_CREAT);
+    CHECK(dst > 0, "create range destination");
+    CHECK(vfs_copy_range(src, 65536, dst, 8192, 1024 * 1024, 0) == 1024 * 1024,
+          "block-aligned range");
+    CHECK(same("/p/ranges", 8192, 65536, 1024 * 1024), "aligned data");
+    CHECK(vfs_copy_range(src, 12345, dst, 2000000, 300001, 0) == 300001, "unaligned range");
+    CHECK(same("/p/ranges", 2000000, 12345, 300001), "unaligned data");
+    CHECK(same("/p/ranges", 8192, 65536, 1024 * 1024), "earlier range untouched");
+    CHECK(size_of("/p/ranges") == 2000000 + 300001, "size grows to the copied end");
+    printf("  ✓ aligned and unaligned ranges\n");
+
+    /* Test 3: the source ends before len */
+    CHECK(vfs_copy_range(src, SRC_SIZE - 1000, dst, 0, 1 << 20, 0) == 1000, "short copy at EOF");
+    CHECK(same("/p/ranges", 0, SRC_SIZE - 1000, 1000), "tail data");
+    CHECK(vfs_copy_range(src, SRC_SIZE, dst, 0, 4096, 0) == 0, "copy from EOF");
+    CHECK(vfs_copy_range(src, 0, dst, 0, 0, 0) == 0, "empty copy");
+    vfs_close(dst);
+    printf("  ✓ short copy at the end of the source\n");
+
+    /* Test 4: fallbacks - another mount, an in-memory file, and back */
+    dst = vfs_open("/u/across", O_RDWR | O_CREAT);
+    CHECK(dst > 0, "create on the other mount");
+    CHECK(vfs_copy_range(src, 100, dst, 0, SRC_SIZE - 100, 0) == SRC_SIZE - 100,
+          "copy across mounts");
+    CHECK(same("/u/across", 0, 100, SRC_SIZE - 100), "data across mounts");
+    vfs_close(dst);
+    int mem = vfs_open("/dir1/memcopy", O_RDWR | O_CREAT);
+    CHECK(mem > 0, "in-memory file");
+    CHECK(vfs_copy_range(src, 0, mem, 0, 600000, 0) == 600000, "copy into memory");
+    dst = vfs_open("/p/frommem", O_RDWR | O_CREAT);
+    CHECK(dst > 0, "create from-memory destination");
+    CHECK(vfs_copy_range(mem, 1000, dst, 0, 1 << 20, 0) == 599000, "copy out of memory");
+    /* in-memory files keep no content: they read back as zeros */
+    CHECK(size_of("/p/frommem") == 599000, "size through memory");
+    int zeros = vfs_open("/p/frommem", O_RDONLY);
+    CHECK(zeros > 0 && vfs_read(zeros, g_back, 599000, 0) == 599000 &&
+          !g_back[0] && !memcmp(g_back, g_back + 1, 598999),
+          "zeros through memory");
+    vfs_close(zeros);
+    vfs_close(dst);
+    vfs_close(mem);
+    printf("  ✓ buffered fallback across mounts and for in-memory files\n");
+
+    /* Test 5: the checks copy_file_range(2) makes */
+    int ro = vfs_open("/p/whole", O_RDONLY);
+    int wo = vfs_open("/p/ranges", O_WRONLY);
+    CHECK(ro > 0 && wo > 0, "open for checks");
+    CHECK(vfs_copy_range(ro, 0, ro, 8192, 100, 0) == -EBADF, "read-only destination");
+    CHECK(vfs_copy_range(wo, 0, src, 0, 100, 0) == -EBADF, "write-only source");
+    CHECK(vfs_copy_range(12345, 0, src, 0, 100, 0) == -EBADF, "unknown handle");
+    CHECK(vfs_copy_range(ro, 0, wo, 0, 100, 1) == -EINVAL, "flags");
+    CHECK(vfs_copy_range(ro, -1, wo, 0, 100, 0) == -EINVAL, "negative offset");
+    CHECK(vfs_copy_range(src, 0, src, 4096, 8192, 0) == -EINVAL, "overlap in one file");
+    CHECK(vfs_copy_range(src, 0, src, SRC_SIZE, 4096, 0) == 4096, "same file, no overlap");
+    CHECK(same("/p/src", SRC_SIZE, 0, 4096), "same-file data");
+    vfs_close(ro);
+    vfs_close(wo);
+    vfs_close(src);
+    printf("  ✓ access, flags and overlap checks\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All copy_range tests passed!\n");
+    return 0;
+}
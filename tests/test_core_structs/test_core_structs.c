@@ -12,18 +12,14 @@ static void test_inode_refcount(void) {
     vfs_inode_t *i = vfs_inode_create(1, 0644, 1000, 1000, 0);
     assert(i != NULL);
     /* initial refcount == 1 */
-    pthread_mutex_lock(&i->lock);
-    int rc = i->refcount;
-    pthread_mutex_unlock(&i->lock);
+    int rc = atomic_load(&i->refcount);
     printf("inode initial refcount = %d\n", rc);
     assert(rc == 1);
 
     vfs_inode_acquire(i);
     vfs_inode_acquire(i);
 
-    pthread_mutex_lock(&i->lock);
-    rc = i->refcount;
-    pthread_mutex_unlock(&i->lock);
+    rc = atomic_load(&i->refcount);
     printf("inode after 2 acquires refcount = %d\n", rc);
     assert(rc == 3);
 
@@ -36,6 +32,35 @@ static void test_inode_refcount(void) {
     printf("inode released completely (no crash)\n");
 }
 
+#define REF_THREADS 4
+#define REF_ROUNDS  100000
+
+static void *ref_worker(void *arg) {
+    vfs_inode_t *i = arg;
+    for (int n = 0; n < REF_ROUNDS; n++) {
+        vfs_inode_acquire(i);
+        vfs_inode_release(i);
+    }
+    return NULL;
+}
+
+/* Lock-free refcounts must not lose updates under contention */
+static void test_inode_refcount_concurrent(void) {
+    vfs_inode_t *i = vfs_inode_create(5, S_IFREG | 0644, 0, 0, 0);
+    assert(i != NULL);
+
+    pthread_t th[REF_THREADS];
+    for (int t = 0; t < REF_THREADS; t++)
+        pthread_create(&th[t], NULL, ref_worker, i);
+    for (int t = 0; t < REF_THREADS; t++)
+        pthread_join(th[t], NULL);
+
+    int rc = atomic_load(&i->refcount);
+    printf("inode refcount after concurrent acquire/release = %d\n", rc);
+    assert(rc == 1);
+    vfs_inode_release(i);
+}
+
 static void test_dentry_tree(void) {
     /* create root inode and dentry */
     vfs_inode_t *root_inode = vfs_inode_create(2, S_IFDIR | 0755, 0, 0, 0);
@@ -76,6 +101,7 @@ int main(void) {
     }
 
     test_inode_refcount();
+    test_inode_refcount_concurrent();
     test_dentry_tree();
 
     if (vfs_shutdown() != 0) {
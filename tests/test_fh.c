@@ -0,0 +1,91 @@
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/*
+ * File handle table tests: far more than the old 1024 handles can be open
+ * at once, stale and reused handles are rejected, and a handle closed from
+ * several threads is closed exactly once.
+ */
+
+#define MANY      50000
+#define THREADS   8
+#define FILE_PATH "/dir1/dir2/file"
+
+static int g_shared_fh;
+static _Atomic int g_closed;
+
+static void *closer(void *arg) {
+    (void)arg;
+    if (vfs_close(g_shared_fh) == 0)
+        atomic_fetch_add(&g_closed, 1);
+    return NULL;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+int main(void) {
+    printf("Running file handle table tests...\n");
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+
+    /* Test 1: tens of thousands of handles, all distinct */
+    int *fhs = malloc(MANY * sizeof(*fhs));
+    CHECK(fhs != NULL, "malloc");
+    for (int i = 0; i < MANY; i++) {
+        fhs[i] = vfs_open(FILE_PATH, O_RDONLY);
+        CHECK(fhs[i] > 0, "open failed before the table was full");
+    }
+    int *sorted = malloc(MANY * sizeof(*sorted));
+    CHECK(sorted != NULL, "malloc");
+    memcpy(sorted, fhs, MANY * sizeof(*fhs));
+    qsort(sorted, MANY, sizeof(*sorted), cmp_int);
+    for (int i = 1; i < MANY; i++)
+        CHECK(sorted[i] != sorted[i - 1], "handle handed out twice");
+    free(sorted);
+    for (int i = 0; i < MANY; i++)
+        CHECK(vfs_close(fhs[i]) == 0, "close");
+    free(fhs);
+    printf("  ✓ %d handles open at once\n", MANY);
+
+    /* Test 2: a closed handle stays dead even after its slot is reused */
+    char buf[16];
+    int old = vfs_open(FILE_PATH, O_RDONLY);
+    CHECK(old > 0, "open");
+    CHECK(vfs_close(old) == 0, "close");
+    int fresh = vfs_open(FILE_PATH, O_RDONLY);
+    CHECK(fresh > 0 && fresh != old, "reused slot got the same handle value");
+    CHECK(vfs_read(old, buf, sizeof(buf), 0) == -EBADF, "read on stale handle");
+    CHECK(vfs_write(old, buf, sizeof(buf), 0) == -EBADF, "write on stale handle");
+    CHECK(vfs_close(old) == -EBADF, "close on stale handle");
+    CHECK(vfs_read(fresh, buf, sizeof(buf), 0) >= 0, "new handle unaffected");
+    CHECK(vfs_close(0x7fffffff) == -EBADF, "close on never-issued handle");
+    CHECK(vfs_close(-1) == -EBADF, "close on negative handle");
+    printf("  ✓ stale and bogus handles rejected\n");
+
+    /* Test 3: concurrent closes of one handle: exactly one wins */
+    g_shared_fh = fresh;
+    pthread_t tids[THREADS];
+    for (int i = 0; i < THREADS; i++)
+        pthread_create(&tids[i], NULL, closer, NULL);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(tids[i], NULL);
+    CHECK(atomic_load(&g_closed) == 1, "handle closed more or less than once");
+    printf("  ✓ racing closes: exactly one succeeds\n");
+
+    vfs_shutdown();
+    printf("All file handle table tests passed!\n");
+    return 0;
+}
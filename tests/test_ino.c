@@ -0,0 +1,100 @@
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+/*
+ * Inode number tests: concurrent creates get unique numbers, and mounts
+ * with VFS_MOUNT_STABLE_INO report numbers that survive a remount and are
+ * shared by hard links.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_ino"
+#define THREADS     8
+#define PER_THREAD  500
+
+static uint64_t g_inos[THREADS * PER_THREAD];
+
+static void *creator(void *arg) {
+    int t = (int)(intptr_t)arg;
+    char path[64];
+    struct stat st;
+    for (int i = 0; i < PER_THREAD; i++) {
+        snprintf(path, sizeof(path), "/inotest/t%d_%d", t, i);
+        if (vfs_mkdir(path, 0755) != 0 || vfs_stat(path, &st) != 0) {
+            fprintf(stderr, "FAIL: create %s\n", path);
+            exit(1);
+        }
+        g_inos[t * PER_THREAD + i] = st.st_ino;
+    }
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int stat_ino(const char *path, uint64_t *ino) {
+    struct stat st;
+    int r = vfs_stat(path, &st);
+    *ino = st.st_ino;
+    return r;
+}
+
+int main(void) {
+    printf("Running inode number tests...\n");
+
+    test_dir_setup(BACKEND_DIR);
+    system("mkdir -p " BACKEND_DIR "/sub && "
+           "echo data > " BACKEND_DIR "/sub/a && ln " BACKEND_DIR "/sub/a " BACKEND_DIR "/b");
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+
+    /* Test 1: concurrent allocations never hand out a number twice */
+    CHECK(vfs_mkdir("/inotest", 0755) == 0, "mkdir /inotest");
+    pthread_t tids[THREADS];
+    for (int i = 0; i < THREADS; i++)
+        pthread_create(&tids[i], NULL, creator, (void *)(intptr_t)i);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(tids[i], NULL);
+    qsort(g_inos, THREADS * PER_THREAD, sizeof(g_inos[0]), cmp_u64);
+    for (int i = 1; i < THREADS * PER_THREAD; i++)
+        CHECK(g_inos[i] != g_inos[i - 1], "duplicate inode number");
+    printf("  ✓ %d concurrent creates got unique inode numbers\n", THREADS * PER_THREAD);
+
+    /* Test 2: stable numbers survive a remount */
+    uint64_t a1, b1, root1, a2, root2, plain;
+    CHECK(vfs_mount_backend_flags("/st", BACKEND_DIR, "posix", VFS_MOUNT_STABLE_INO) == 0,
+          "stable mount");
+    CHECK(stat_ino("/st/sub/a", &a1) == 0 && stat_ino("/st/b", &b1) == 0 &&
+          stat_ino("/st", &root1) == 0, "stat on stable mount");
+    CHECK(vfs_unmount_backend("/st") == 0, "unmount");
+    CHECK(vfs_mount_backend_flags("/st", BACKEND_DIR, "posix", VFS_MOUNT_STABLE_INO) == 0,
+          "remount");
+    CHECK(stat_ino("/st/sub/a", &a2) == 0 && stat_ino("/st", &root2) == 0,
+          "stat after remount");
+    CHECK(a1 == a2 && root1 == root2, "inode number changed across remount");
+    printf("  ✓ stable numbers survive a remount\n");
+
+    /* Test 3: hard links share the number; other mounts do not */
+    CHECK(a1 == b1, "hard links got different numbers");
+    CHECK(vfs_mount_backend("/plain", BACKEND_DIR, "posix") == 0, "plain mount");
+    CHECK(stat_ino("/plain/sub/a", &plain) == 0, "stat on plain mount");
+    CHECK(plain != a1, "plain mount reused a stable number");
+    printf("  ✓ hard links share a stable number\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All inode number tests passed!\n");
+    return 0;
+}
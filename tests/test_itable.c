@@ -0,0 +1,115 @@
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+/*
+ * Inode table tests: paths to the same backend file share one inode, its
+ * backend handle and its cached attributes.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_itable"
+#define OPENS       100
+
+static int count_fds(void) {
+    DIR *d = opendir("/proc/self/fd");
+    int n = 0;
+    if (!d)
+        return -1;
+    while (readdir(d))
+        n++;
+    closedir(d);
+    return n;
+}
+
+int main(void) {
+    printf("Running inode table tests...\n");
+
+    test_dir_setup(BACKEND_DIR);
+    system("mkdir -p " BACKEND_DIR "/dir && "
+           "printf 12345 > " BACKEND_DIR "/dir/orig && "
+           "ln " BACKEND_DIR "/dir/orig " BACKEND_DIR "/link");
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    CHECK(vfs_mount_backend("/it", BACKEND_DIR, "posix") == 0, "mount");
+
+    /* Test 1: hard links resolve to the same inode */
+    vfs_dentry_t *a = NULL, *b = NULL;
+    CHECK(vfs_resolve_path("/it/dir/orig", &a) == 0, "resolve orig");
+    CHECK(vfs_resolve_path("/it/link", &b) == 0, "resolve link");
+    CHECK(a != b && a->inode == b->inode, "hard links do not share an inode");
+    printf("  ✓ hard links share one inode\n");
+
+    /* Test 2: repeated opens share one backend handle */
+    int fds_before = count_fds();
+    int fhs[OPENS];
+    for (int i = 0; i < OPENS; i++) {
+        fhs[i] = vfs_open(i % 2 ? "/it/link" : "/it/dir/orig", O_RDONLY);
+        CHECK(fhs[i] > 0, "open");
+    }
+    CHECK(count_fds() - fds_before <= 1, "duplicate backend opens");
+    char buf[8] = { 0 };
+    CHECK(vfs_read(fhs[OPENS - 1], buf, 5, 0) == 5 && !memcmp(buf, "12345", 5),
+          "read through shared handle");
+    for (int i = 0; i < OPENS; i++)
+        vfs_close(fhs[i]);
+    printf("  ✓ %d opens used %d backend fd(s)\n", OPENS, count_fds() - fds_before);
+
+    /* Test 3: a writer needing more access upgrades the shared handle */
+    int w = vfs_open("/it/link", O_WRONLY);
+    CHECK(w > 0, "open for write");
+    CHECK(vfs_write(w, "ab", 2, 5) == 2, "write through upgraded handle");
+    struct stat st;
+    CHECK(vfs_stat("/it/dir/orig", &st) == 0 && st.st_size == 7,
+          "size not visible through the other link");
+    vfs_close(w);
+    printf("  ✓ write via one link visible through the other\n");
+
+    /* Test 4: O_CREAT opens of one name share the inode */
+    int c1 = vfs_open("/it/new", O_CREAT | O_RDWR);
+    int c2 = vfs_open("/it/new", O_CREAT | O_RDWR);
+    CHECK(c1 > 0 && c2 > 0, "O_CREAT opens");
+    CHECK(vfs_write(c1, "xyz", 3, 0) == 3, "write c1");
+    CHECK(vfs_read(c2, buf, 3, 0) == 3 && !memcmp(buf, "xyz", 3), "read c2");
+    vfs_close(c1);
+    vfs_close(c2);
+    printf("  ✓ repeated O_CREAT opens share one inode\n");
+
+    /* Test 5: attributes are served from the inode within the TTL */
+    CHECK(vfs_stat("/it/dir/orig", &st) == 0 && st.st_size == 7, "stat");
+    system("printf 0123456789 > " BACKEND_DIR "/dir/orig");
+    CHECK(vfs_stat("/it/link", &st) == 0 && st.st_size == 7, "cached attributes not used");
+    vfs_set_attr_ttl_ms(0);
+    CHECK(vfs_get_attr_ttl_ms() == 0, "attr ttl setter");
+    CHECK(vfs_stat("/it/link", &st) == 0 && st.st_size == 10, "TTL 0 still cached");
+    vfs_set_attr_ttl_ms(1000);
+    printf("  ✓ stat answered from cached attributes, TTL 0 bypasses them\n");
+
+    /* Test 6: opens with other status flags get a handle of their own */
+    system("printf 0123456789 > " BACKEND_DIR "/flags");
+    int ap = vfs_open("/it/flags", O_WRONLY | O_APPEND);
+    int pl = vfs_open("/it/flags", O_WRONLY);
+    CHECK(ap > 0 && pl > 0, "O_APPEND and plain opens");
+    CHECK(vfs_write(pl, "X", 1, 0) == 1, "positioned write");
+    CHECK(vfs_write(ap, "Y", 1, 0) == 1, "append");
+    char data[16] = { 0 };
+    int rd = vfs_open("/it/flags", O_RDONLY);
+    CHECK(rd > 0 && vfs_read(rd, data, sizeof(data), 0) == 11 &&
+          !memcmp(data, "X123456789Y", 11), "O_APPEND leaked into the other open");
+    CHECK(vfs_close(pl) == 0 && vfs_close(rd) == 0 && vfs_close(ap) == 0, "close");
+    printf("  ✓ O_APPEND stays with the open that asked for it\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All inode table tests passed!\n");
+    return 0;
+}
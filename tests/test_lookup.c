@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include "vfs_core.h"
 
 int main() {
@@ -33,6 +34,37 @@ int main() {
         printf("FAIL path normalization\n"); return 1;
     }
 
+    // Test stack-buffer normalization
+    char norm[64];
+    if (vfs_path_normalize("/a//b/./c/../d/", norm, sizeof(norm)) != 6 ||
+        strcmp(norm, "/a/b/d") != 0) {
+        printf("FAIL normalize /a//b/./c/../d/ -> %s\n", norm); return 1;
+    }
+    if (vfs_path_normalize("/../..", norm, sizeof(norm)) != 1 || strcmp(norm, "/") != 0) {
+        printf("FAIL normalize above root\n"); return 1;
+    }
+    if (vfs_path_normalize("/0123456789/0123456789", norm, 12) != -ENAMETOOLONG) {
+        printf("FAIL normalize overflow\n"); return 1;
+    }
+    if (vfs_path_normalize("relative", norm, sizeof(norm)) != -EINVAL) {
+        printf("FAIL normalize relative path\n"); return 1;
+    }
+
+    // Test component iterator
+    vfs_path_iter_t it;
+    const char *name;
+    size_t len;
+    int n = 0;
+    vfs_path_iter_init(&it, "/dir1//dir2/file");
+    while (vfs_path_iter_next(&it, &name, &len)) {
+        static const char *want[] = { "dir1", "dir2", "file" };
+        if (n >= 3 || len != strlen(want[n]) || strncmp(name, want[n], len) != 0) {
+            printf("FAIL iterator component %d\n", n); return 1;
+        }
+        n++;
+    }
+    if (n != 3) { printf("FAIL iterator count %d\n", n); return 1; }
+
     printf("All tests passed!\n");
 
     // Cleanup - vfs_shutdown handles dentry tree cleanup
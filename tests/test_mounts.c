@@ -0,0 +1,225 @@
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/stat.h>
+
+/*
+ * Mount table tests: longest-prefix matching on component boundaries,
+ * stacked mounts, lookups racing with mount/unmount, and unmounts racing
+ * with operations inside the mount they remove, which they sleep on.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_mounts"
+#define THREADS     4
+#define REMOUNTS    200
+#define SLOW_MS     300         /* how long the stub backend's stat of "slow" takes */
+
+static int exists(const char *path) {
+    struct stat st;
+    return vfs_stat(path, &st) == 0;
+}
+
+static _Atomic int g_stop;
+static _Atomic int g_failures;
+
+static void *stat_loop(void *arg) {
+    (void)arg;
+    while (!atomic_load(&g_stop)) {
+        if (!exists("/m/x/y/z/marker_xyz") || !exists("/m/a/marker_a"))
+            atomic_fetch_add(&g_failures, 1);
+    }
+    return NULL;
+}
+
+/* Stat and open inside /m/tmp while it comes and goes: either outcome is
+ * fine, using the mount after it is torn down is not */
+static void *churn_loop(void *arg) {
+    (void)arg;
+    struct stat st;
+    while (!atomic_load(&g_stop)) {
+        int r = vfs_stat("/m/tmp/churn", &st);
+        if (r != 0 && r != -ENOENT)
+            atomic_fetch_add(&g_failures, 1);
+        int fh = vfs_open("/m/tmp/churn", O_RDONLY);
+        if (fh >= 0)
+            vfs_close(fh);
+        else if (fh != -ENOENT)
+            atomic_fetch_add(&g_failures, 1);
+    }
+    return NULL;
+}
+
+/* ---- stub backend: a directory whose entry "slow" takes SLOW_MS to stat ---- */
+
+static _Atomic int g_in_slow_stat;
+
+static int slow_init(const char *root, void **data) { (void)root; *data = &g_in_slow_stat; return 0; }
+static int slow_shutdown(void *data) { (void)data; return 0; }
+
+static int slow_stat(void *data, const char *rel, struct stat *st)
+{
+    (void)data;
+    memset(st, 0, sizeof(*st));
+    st->st_dev = 42;
+    st->st_nlink = 1;
+    if (!strcmp(rel, ".") || !*rel) {
+        st->st_mode = S_IFDIR | 0755;
+        st->st_ino = 1;
+        return 0;
+    }
+    if (strcmp(rel, "slow"))
+        return -ENOENT;
+    atomic_store(&g_in_slow_stat, 1);
+    usleep(SLOW_MS * 1000);
+    st->st_mode = S_IFREG | 0644;
+    st->st_ino = 2;
+    return 0;
+}
+
+static const vfs_backend_ops_t slow_ops = {
+    .name     = "slowstat",
+    .init     = slow_init,
+    .shutdown = slow_shutdown,
+    .stat     = slow_stat,
+};
+
+static void *slow_stat_once(void *arg) {
+    struct stat st;
+    *(int *)arg = vfs_stat("/slow/slow", &st);
+    return NULL;
+}
+
+static double seconds(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+    printf("Running mount table tests...\n");
+
+    test_dir_setup(BACKEND_DIR);
+    system("mkdir -p " BACKEND_DIR "/a " BACKEND_DIR "/ab "
+           BACKEND_DIR "/abc " BACKEND_DIR "/xyz " BACKEND_DIR "/tmp && "
+           "touch " BACKEND_DIR "/a/marker_a " BACKEND_DIR "/ab/marker_ab "
+           BACKEND_DIR "/abc/marker_abc " BACKEND_DIR "/xyz/marker_xyz " BACKEND_DIR "/tmp/churn");
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+
+    CHECK(vfs_mount_backend("/m/a", BACKEND_DIR "/a", "posix") == 0, "mount /m/a");
+    CHECK(vfs_mount_backend("/m/a/b", BACKEND_DIR "/ab", "posix") == 0, "mount /m/a/b");
+    CHECK(vfs_mount_backend("/m/abc", BACKEND_DIR "/abc", "posix") == 0, "mount /m/abc");
+    CHECK(vfs_mount_backend("/m/x/y/z", BACKEND_DIR "/xyz", "posix") == 0, "mount /m/x/y/z");
+
+    /* Test 1: the deepest mount on a component boundary wins */
+    CHECK(exists("/m/a/marker_a"), "/m/a resolves to its backend");
+    CHECK(exists("/m/a/b/marker_ab"), "/m/a/b resolves to the nested mount");
+    CHECK(!exists("/m/a/marker_ab"), "nested mount leaked into its parent");
+    CHECK(exists("/m/abc/marker_abc"), "/m/abc is not matched by /m/a");
+    CHECK(exists("/m/x/y/z/marker_xyz"), "deep mountpoint");
+    CHECK(!exists("/m/x/y/marker_xyz"), "intermediate components are not mounts");
+    CHECK(exists("/dir1/dir2/file"), "root mount still serves everything else");
+    printf("  ✓ longest-prefix match on component boundaries\n");
+
+    /* Test 2: a mount on top of another hides it until unmounted */
+    CHECK(vfs_mount_backend("/m/a", BACKEND_DIR "/abc", "posix") == 0, "stacked mount");
+    CHECK(exists("/m/a/marker_abc") && !exists("/m/a/marker_a"), "newest mount wins");
+    CHECK(vfs_unmount_backend("/m/a") == 0, "unmount stacked");
+    CHECK(exists("/m/a/marker_a"), "older mount visible again");
+    CHECK(vfs_unmount_backend("/m/a/b") == 0, "unmount /m/a/b");
+    CHECK(!exists("/m/a/b/marker_ab"), "unmounted path still resolves");
+    CHECK(vfs_unmount_backend("/m/a/b") == -ENOENT, "double unmount");
+    printf("  ✓ stacked mounts and unmount\n");
+
+    /* Test 3: lookups keep working while unrelated mounts come and go */
+    pthread_t tids[THREADS];
+    for (int i = 0; i < THREADS; i++)
+        pthread_create(&tids[i], NULL, stat_loop, NULL);
+    int mount_errors = 0;
+    for (int i = 0; i < REMOUNTS; i++) {
+        if (vfs_mount_backend("/m/tmp", BACKEND_DIR "/tmp", "posix") != 0 ||
+            vfs_unmount_backend("/m/tmp") != 0)
+            mount_errors++;
+    }
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(tids[i], NULL);
+    CHECK(mount_errors == 0, "mount/unmount cycle failed");
+    CHECK(atomic_load(&g_failures) == 0, "lookup failed during remounts");
+    printf("  ✓ %d lookup threads unaffected by %d remounts\n", THREADS, REMOUNTS);
+
+    /* Test 4: unmounting the mount an operation is inside waits for it */
+    atomic_store(&g_stop, 0);
+    for (int i = 0; i < THREADS; i++)
+        pthread_create(&tids[i], NULL, churn_loop, NULL);
+    int unmounted = 0, busy = 0;
+    for (int i = 0; i < REMOUNTS; i++) {
+        if (vfs_mount_backend("/m/tmp", BACKEND_DIR "/tmp", "posix") != 0) {
+            mount_errors++;
+            continue;
+        }
+        int r;
+        while ((r = vfs_unmount_backend("/m/tmp")) == -EBUSY)
+            busy++;
+        if (r == 0)
+            unmounted++;
+    }
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(tids[i], NULL);
+    CHECK(mount_errors == 0 && unmounted == REMOUNTS, "mount/unmount under churn");
+    CHECK(atomic_load(&g_failures) == 0, "operation failed during remounts");
+    CHECK(!exists("/m/tmp/churn"), "unmounted mount still resolves");
+    printf("  ✓ %d remounts under %d stat/open threads (%d busy retries)\n",
+           REMOUNTS, THREADS, busy);
+
+    /* Test 5: open handles keep a mount, whichever way it is removed */
+    CHECK(vfs_mount_backend("/m/tmp", BACKEND_DIR "/tmp", "posix") == 0, "mount /m/tmp");
+    int fh = vfs_open("/m/tmp/churn", O_RDONLY);
+    CHECK(fh >= 0, "open inside /m/tmp");
+    CHECK(vfs_unmount_backend("/m/tmp") == -EBUSY, "unmount with a handle open");
+    CHECK(exists("/m/tmp/churn"), "busy mount still visible");
+    CHECK(vfs_close(fh) == 0 && vfs_unmount_backend("/m/tmp") == 0, "unmount once closed");
+
+    vfs_mount_entry_t *m = vfs_mount_create("/m/mem", "mem");
+    CHECK(m != NULL, "vfs_mount_create");
+    fh = vfs_create("/m/mem/f", 0644, NULL);
+    CHECK(fh >= 0, "create in the in-memory mount");
+    CHECK(vfs_mount_destroy(m) == -EBUSY, "destroy with a handle open");
+    CHECK(vfs_close(fh) == 0 && vfs_mount_destroy(m) == 0, "destroy once closed");
+    printf("  ✓ busy mounts refuse to unmount\n");
+
+    /* Test 6: an unmount waiting for a slow operation sleeps */
+    CHECK(vfs_register_backend(&slow_ops) == 0, "register stub backend");
+    CHECK(vfs_mount_backend("/slow", "stub", "slowstat") == 0, "mount /slow");
+    pthread_t slow;
+    int slow_ret = -1;
+    pthread_create(&slow, NULL, slow_stat_once, &slow_ret);
+    while (!atomic_load(&g_in_slow_stat))
+        usleep(1000);
+    double wall = seconds(CLOCK_MONOTONIC), cpu = seconds(CLOCK_PROCESS_CPUTIME_ID);
+    CHECK(vfs_unmount_backend("/slow") == 0, "unmount /slow");
+    wall = seconds(CLOCK_MONOTONIC) - wall;
+    cpu = seconds(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+    pthread_join(slow, NULL);
+    CHECK(slow_ret == 0, "stat finished on the mount it started on");
+    CHECK(wall >= SLOW_MS / 2000.0, "unmount did not wait for the stat");
+    CHECK(cpu < wall / 4, "unmount spun while waiting");
+    printf("  ✓ unmount slept %.0f ms on an operation, %.1f ms of CPU\n",
+           wall * 1e3, cpu * 1e3);
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All mount table tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Negative dentry tests: misses on a backend mount are cached for the
+ * configured TTL, creation through the VFS replaces them, and lookups of
+ * missing names no longer fabricate directories.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_negative"
+
+static uint64_t backend_lookups(void) {
+    vfs_dcache_stats_t st;
+    vfs_dcache_get_stats(&st);
+    return st.backend_lookups;
+}
+
+int main(void) {
+    printf("Running negative dentry tests...\n");
+
+    test_dir_setup(BACKEND_DIR);
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    if (vfs_mount_backend("/neg", BACKEND_DIR, "posix") != 0) {
+        fprintf(stderr, "mount failed\n");
+        vfs_shutdown();
+        return 1;
+    }
+
+    struct stat st;
+
+    /* Test 1: a miss is ENOENT, not an auto-created directory */
+    CHECK(vfs_stat("/neg/missing", &st) == -ENOENT, "stat of missing file");
+    CHECK(vfs_open("/neg/missing", O_RDONLY) == -ENOENT, "open of missing file");
+    printf("  ✓ missing backend file reports ENOENT\n");
+
+    /* Test 2: repeated misses within the TTL stay in memory */
+    uint64_t before = backend_lookups();
+    for (int i = 0; i < 100; i++)
+        CHECK(vfs_stat("/neg/missing", &st) == -ENOENT, "repeated miss");
+    CHECK(backend_lookups() == before, "negative dentry not reused");
+    printf("  ✓ 100 repeated misses served from the dcache\n");
+
+    /* Test 3: creating the name through the VFS drops the negative entry */
+    int fh = vfs_open("/neg/missing", O_CREAT | O_RDWR);
+    CHECK(fh >= 0, "create over negative dentry");
+    vfs_close(fh);
+    CHECK(vfs_stat("/neg/missing", &st) == 0 && S_ISREG(st.st_mode),
+          "created file not visible");
+    CHECK(vfs_mkdir("/neg/newdir", 0755) == 0, "backend mkdir");
+    CHECK(vfs_stat("/neg/newdir", &st) == 0 && S_ISDIR(st.st_mode),
+          "backend mkdir not visible");
+    printf("  ✓ create/mkdir replace negative entries\n");
+
+    /* Test 4: TTL 0 disables negative caching */
+    vfs_set_negative_ttl_ms(0);
+    CHECK(vfs_get_negative_ttl_ms() == 0, "ttl setter");
+    before = backend_lookups();
+    for (int i = 0; i < 10; i++)
+        CHECK(vfs_stat("/neg/uncached", &st) == -ENOENT, "uncached miss");
+    CHECK(backend_lookups() == before + 10, "miss cached with TTL 0");
+    /* files created behind the VFS's back show up immediately */
+    system("touch " BACKEND_DIR "/uncached");
+    CHECK(vfs_stat("/neg/uncached", &st) == 0, "external create not seen");
+    vfs_set_negative_ttl_ms(1000);
+    printf("  ✓ TTL 0 disables negative caching\n");
+
+    /* Test 5: in-memory mkdir creates, and refuses duplicates */
+    CHECK(vfs_mkdir("/memdir", 0755) == 0, "in-memory mkdir");
+    CHECK(vfs_mkdir("/memdir", 0755) == -EEXIST, "duplicate mkdir");
+    CHECK(vfs_stat("/memdir", &st) == 0 && S_ISDIR(st.st_mode), "memdir stat");
+    CHECK(vfs_stat("/memdir/none", &st) == -ENOENT, "in-memory miss");
+    printf("  ✓ in-memory mkdir\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All negative dentry tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#define CHECK_CLEANUP()                    /* no VFS to shut down */
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+/*
+ * posix backend path handling relative to cached directory fds: deep
+ * trees, renames and rmdir dropping stale cache entries, a backing root
+ * renamed on the host, the cache bound, and lookups racing renames.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_posix_dirfd"
+#define MOVED_DIR   "/tmp/vfs_test_posix_dirfd_moved"
+#define DEPTH       24
+#define WIDE        400         /* more directories than the cache holds */
+
+static int g_id;
+static _Atomic int g_stop, g_errors;
+
+static int count_entry(void *buf, const char *name, const struct stat *st, off_t off,
+                       int flags)
+{
+    (void)off;
+    (void)flags;
+    if (!strcmp(name, "leaf") && S_ISREG(st->st_mode))
+        ++*(int *)buf;
+    return 0;
+}
+
+/* stat files under w/dNNN while another thread renames w/d000 back and forth */
+static void *stat_loop(void *arg)
+{
+    (void)arg;
+    char rel[64];
+    struct stat st;
+    for (unsigned i = 0; !atomic_load(&g_stop); i++) {
+        snprintf(rel, sizeof(rel), "w/d%03u/f", 1 + i % (WIDE - 1));
+        if (posix_stat(g_id, rel, &st) != 0)
+            atomic_fetch_add(&g_errors, 1);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    printf("Running posix dirfd path tests...\n");
+    test_dir_cleanup(MOVED_DIR);
+    test_dir_setup(BACKEND_DIR);
+    int fds_before = test_open_fds();
+    g_id = posix_backend_init(BACKEND_DIR);
+    CHECK(g_id > 0, "posix_backend_init");
+    CHECK(posix_backend_init(BACKEND_DIR "/missing") < 0 && errno == ENOENT, "missing root");
+
+    /* Test 1: a deep tree built and used through the backend */
+    char rel[512] = "";
+    for (int i = 0; i < DEPTH; i++) {
+        size_t n = strlen(rel);
+        snprintf(rel + n, sizeof(rel) - n, "%sl%02d", n ? "/" : "", i);
+        CHECK(posix_mkdir(g_id, rel, 0755) == 0, "mkdir level");
+    }
+    size_t dlen = strlen(rel);
+    strcat(rel, "/leaf");
+    int h = posix_create(g_id, rel, 0644);
+    CHECK(h > 0 && posix_write(g_id, h, "deep", 4, 0) == 4, "create at the bottom");
+    CHECK(posix_close(g_id, h) == 0, "close");
+    struct stat st;
+    CHECK(posix_stat(g_id, rel, &st) == 0 && st.st_size == 4, "stat at the bottom");
+    rel[dlen] = '\0';
+    int found = 0;
+    CHECK(posix_readdir(g_id, rel, &found, count_entry, 0, 0) == 0 && found == 1,
+          "readdir at the bottom");
+    CHECK(posix_stat(g_id, ".", &st) == 0 && S_ISDIR(st.st_mode), "stat the root");
+    CHECK(posix_stat(g_id, "/etc", &st) < 0 && errno == EINVAL, "absolute path rejected");
+    printf("  ✓ %d-level tree through cached directory fds\n", DEPTH);
+
+    /* Test 2: renames and rmdir through the backend drop stale entries */
+    CHECK(posix_mkdir(g_id, "a", 0755) == 0 && posix_mkdir(g_id, "a/b", 0755) == 0, "mkdir a/b");
+    h = posix_create(g_id, "a/b/f", 0644);
+    CHECK(h > 0 && posix_close(g_id, h) == 0, "create a/b/f");
+    CHECK(posix_stat(g_id, "a/b/f", &st) == 0, "a/b cached");
+    CHECK(posix_rename(g_id, "a", "c") == 0, "rename a -> c");
+    CHECK(posix_stat(g_id, "a/b/f", &st) < 0 && errno == ENOENT, "old path gone");
+    CHECK(posix_stat(g_id, "c/b/f", &st) == 0, "new path");
+    CHECK(posix_mkdir(g_id, "a", 0755) == 0 && posix_mkdir(g_id, "a/b", 0755) == 0,
+          "recreate a/b");
+    h = posix_create(g_id, "a/b/g", 0644);
+    CHECK(h > 0 && posix_close(g_id, h) == 0, "create in the new a/b");
+    CHECK(access(BACKEND_DIR "/a/b/g", F_OK) == 0 && access(BACKEND_DIR "/c/b/g", F_OK) != 0,
+          "file landed in the new directory");
+
+    CHECK(posix_stat(g_id, "c/b/f", &st) == 0, "c/b cached");
+    CHECK(posix_unlink(g_id, "c/b/f") == 0 && posix_unlink(g_id, "c/b") == 0, "rmdir c/b");
+    CHECK(posix_mkdir(g_id, "c/b", 0755) == 0, "mkdir c/b again");
+    h = posix_create(g_id, "c/b/h", 0644);
+    CHECK(h > 0 && posix_close(g_id, h) == 0 && access(BACKEND_DIR "/c/b/h", F_OK) == 0,
+          "create after rmdir and mkdir");
+
+    CHECK(posix_mkdir(g_id, "e", 0755) == 0, "mkdir e");
+    CHECK(posix_stat(g_id, "a/b/g", &st) == 0, "a/b cached again");
+    CHECK(posix_rename(g_id, "e", "a") < 0, "rename onto a non-empty dir fails");
+    CHECK(posix_unlink(g_id, "a/b/g") == 0 && posix_unlink(g_id, "a/b") == 0, "empty a");
+    CHECK(posix_rename(g_id, "e", "a") == 0, "rename e over a");
+    CHECK(posix_mkdir(g_id, "a/b", 0755) == 0 && access(BACKEND_DIR "/a/b", F_OK) == 0,
+          "replaced directory");
+    printf("  ✓ renames and rmdir invalidate cached directories\n");
+
+    /* Test 3: the backing root moves on the host */
+    CHECK(rename(BACKEND_DIR, MOVED_DIR) == 0, "host rename");
+    CHECK(posix_stat(g_id, "a/b", &st) == 0, "stat after the root moved");
+    h = posix_create(g_id, "moved", 0644);
+    CHECK(h > 0 && posix_close(g_id, h) == 0 && access(MOVED_DIR "/moved", F_OK) == 0,
+          "create after the root moved");
+    CHECK(rename(MOVED_DIR, BACKEND_DIR) == 0, "host rename back");
+    printf("  ✓ backend follows its root across a host rename\n");
+
+    /* Test 4: more directories than the cache holds */
+    CHECK(posix_mkdir(g_id, "w", 0755) == 0, "mkdir w");
+    for (int i = 0; i < WIDE; i++) {
+        snprintf(rel, sizeof(rel), "w/d%03d", i);
+        CHECK(posix_mkdir(g_id, rel, 0755) == 0, "mkdir w/dNNN");
+        strcat(rel, "/f");
+        h = posix_create(g_id, rel, 0644);
+        CHECK(h > 0 && posix_close(g_id, h) == 0, "create w/dNNN/f");
+    }
+    for (int pass = 0; pass < 2; pass++)
+        for (int i = 0; i < WIDE; i++) {
+            snprintf(rel, sizeof(rel), "w/d%03d/f", i);
+            CHECK(posix_stat(g_id, rel, &st) == 0, "stat w/dNNN/f");
+        }
+    CHECK(test_open_fds() <= fds_before + 1 + 256 + 1, "cache stays bounded");
+    printf("  ✓ cache bounded with %d directories in use\n", WIDE);
+
+    /* Test 5: lookups on many threads while a directory is renamed */
+    pthread_t th[3];
+    for (int i = 0; i < 3; i++)
+        pthread_create(&th[i], NULL, stat_loop, NULL);
+    for (int i = 0; i < 200; i++) {
+        if (posix_rename(g_id, "w/d000", "w/moved") != 0 ||
+            posix_stat(g_id, "w/moved/f", &st) != 0 ||
+            posix_rename(g_id, "w/moved", "w/d000") != 0 ||
+            posix_stat(g_id, "w/d000/f", &st) != 0)
+            atomic_fetch_add(&g_errors, 1);
+    }
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < 3; i++)
+        pthread_join(th[i], NULL);
+    CHECK(g_errors == 0, "concurrent lookups and renames");
+    printf("  ✓ concurrent lookups alongside renames\n");
+
+    CHECK(posix_backend_shutdown(g_id) == 0, "shutdown");
+    CHECK(test_open_fds() == fds_before, "directory fds closed at shutdown");
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All posix dirfd path tests passed!\n");
+    return 0;
+}
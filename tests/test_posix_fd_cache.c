@@ -0,0 +1,200 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#define CHECK_CLEANUP()                    /* no VFS to shut down */
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/*
+ * posix backend open fd cache: reopens served without touching the host,
+ * handles sharing one fd per access mode, unlink and rename dropping
+ * entries, files replaced on the host noticed after the TTL (at once for
+ * writing), the size
+ * bound, eviction under open handles, and opens racing renames.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_posix_fd_cache"
+#define THREADS     4
+#define ROUNDS      20000
+
+static int g_id;
+static _Atomic int g_stop, g_errors;
+
+/* First byte of rel through a fresh handle, or -1 */
+static int first_byte(const char *rel)
+{
+    char c;
+    int h = posix_open(g_id, rel, O_RDONLY, 0);
+    if (h < 0)
+        return -1;
+    ssize_t n = posix_read(g_id, h, &c, 1, 0);
+    posix_close(g_id, h);
+    return n == 1 ? c : -1;
+}
+
+static void put(const char *rel, char c)
+{
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd), "printf %c > " BACKEND_DIR "/%s", c, rel);
+    system(cmd);
+}
+
+/* open, read and close r0..r3 while another thread renames them around */
+static void *reader(void *arg)
+{
+    char rel[8];
+    for (unsigned i = (unsigned)(long)arg; !atomic_load(&g_stop); i++) {
+        snprintf(rel, sizeof(rel), "r%u", i % 4);
+        char c;
+        int h = posix_open(g_id, rel, O_RDONLY, 0);
+        if (h < 0)
+            continue;           /* renamed away just now */
+        if (posix_read(g_id, h, &c, 1, 0) != 1 || c != 'r' || posix_close(g_id, h) != 0)
+            atomic_fetch_add(&g_errors, 1);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    printf("Running posix open fd cache tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    system("mkdir -p " BACKEND_DIR "/dir");
+    put("a", 'a');
+    put("dir/f", 'f');
+    put("new", 'n');
+
+    int fds_before = test_open_fds();
+    g_id = posix_backend_init(BACKEND_DIR);
+    CHECK(g_id > 0, "posix_backend_init");
+
+    /* Test 1: reopens hit, handles share the fd of their access mode */
+    uint64_t hits, misses, checks;
+    for (int i = 0; i < 10; i++)
+        CHECK(first_byte("a") == 'a', "read a");
+    CHECK(posix_fd_cache_stats(g_id, &hits, &misses, &checks) == 0 &&
+          hits == 9 && misses == 1 && checks == 0, "one miss, then hits");
+    CHECK(test_open_fds() == fds_before + 2, "root fd and one cached fd");
+    int h1 = posix_open(g_id, "a", O_RDONLY, 0);
+    int h2 = posix_open(g_id, "a", O_RDONLY, 0);
+    int h3 = posix_open(g_id, "a", O_RDWR, 0);
+    int h4 = posix_open(g_id, "a", O_RDONLY | O_APPEND, 0);
+    CHECK(h1 > 0 && h2 > 0 && h3 > 0 && h4 > 0 && h1 != h2, "open a four times");
+    CHECK(posix_fd(g_id, h1) == posix_fd(g_id, h2), "same mode shares the fd");
+    CHECK(posix_fd(g_id, h3) != posix_fd(g_id, h1), "other mode, other fd");
+    CHECK(posix_fd(g_id, h4) != posix_fd(g_id, h1), "O_APPEND not shared");
+    CHECK(posix_write(g_id, h3, "A", 1, 0) == 1, "write through the cached fd");
+    char c;
+    CHECK(posix_read(g_id, h2, &c, 1, 0) == 1 && c == 'A', "other handle sees it");
+    CHECK(posix_close(g_id, h1) == 0 && posix_read(g_id, h2, &c, 1, 0) == 1,
+          "closing one handle leaves the shared fd open");
+    CHECK(posix_close(g_id, h1) < 0 && errno == EBADF, "double close");
+    CHECK(posix_close(g_id, h2) == 0 && posix_close(g_id, h3) == 0 &&
+          posix_close(g_id, h4) == 0, "close the rest");
+    printf("  ✓ reopens served from the cache, fds shared per access mode\n");
+
+    /* Test 2: unlink and rename through the backend drop entries */
+    int fds = test_open_fds();
+    CHECK(posix_unlink(g_id, "a") == 0 && test_open_fds() == fds - 2, "unlink closes cached fds");
+    put("a", 'b');
+    CHECK(first_byte("a") == 'b', "recreated file");
+    CHECK(first_byte("new") == 'n', "cache new");
+    CHECK(posix_rename(g_id, "a", "new") == 0 && first_byte("new") == 'b',
+          "rename over a cached file");
+    CHECK(first_byte("a") == -1 && errno == ENOENT, "old name gone");
+    CHECK(first_byte("dir/f") == 'f' && posix_rename(g_id, "dir", "moved") == 0,
+          "rename the parent directory");
+    CHECK(posix_mkdir(g_id, "dir", 0755) == 0, "mkdir dir again");
+    put("dir/f", 'g');
+    CHECK(first_byte("dir/f") == 'g' && first_byte("moved/f") == 'f',
+          "files below a renamed directory");
+    printf("  ✓ unlink and rename invalidate cached fds\n");
+
+    /* Test 3: a file replaced on the host is noticed after the TTL */
+    CHECK(first_byte("new") == 'b', "cache new");
+    system("printf h > " BACKEND_DIR "/tmp_h && mv " BACKEND_DIR "/tmp_h " BACKEND_DIR "/new");
+    usleep(1100 * 1000);
+    posix_fd_cache_stats(g_id, NULL, NULL, &checks);
+    CHECK(first_byte("new") == 'h', "replacement seen");
+    uint64_t checks2;
+    posix_fd_cache_stats(g_id, NULL, NULL, &checks2);
+    CHECK(checks2 == checks + 1, "one identity check");
+
+    put("w", 'w');
+    h1 = posix_open(g_id, "w", O_RDWR, 0);
+    CHECK(h1 > 0 && posix_close(g_id, h1) == 0, "cache w for writing");
+    system("printf x > " BACKEND_DIR "/tmp_w && mv " BACKEND_DIR "/tmp_w " BACKEND_DIR "/w");
+    posix_fd_cache_stats(g_id, NULL, NULL, &checks);
+    h1 = posix_open(g_id, "w", O_RDWR, 0);
+    CHECK(h1 > 0 && posix_write(g_id, h1, "W", 1, 0) == 1 && posix_close(g_id, h1) == 0,
+          "write w within the TTL");
+    posix_fd_cache_stats(g_id, NULL, NULL, &checks2);
+    CHECK(checks2 == checks + 1, "writable entry checked at once");
+    CHECK(first_byte("w") == 'W', "write landed in the replacement");
+    printf("  ✓ host replacement noticed after the TTL, at once for writing\n");
+
+    /* Test 4: the size bound, and eviction while a handle uses the fd */
+    CHECK(posix_fd_cache_set_size(g_id, 0) == 0, "turn the cache off");
+    fds = test_open_fds();
+    CHECK(posix_fd_cache_set_size(g_id, 4) == 0, "set size 4");
+    char rel[16];
+    for (int i = 0; i < 10; i++) {
+        snprintf(rel, sizeof(rel), "s%d", i);
+        put(rel, 's');
+        CHECK(first_byte(rel) == 's', "read sN");
+    }
+    CHECK(test_open_fds() == fds + 4, "cache stays bounded");
+    CHECK(posix_fd_cache_set_size(g_id, 1) == 0 && test_open_fds() == fds + 1, "shrink to 1");
+    h1 = posix_open(g_id, "s0", O_RDONLY, 0);
+    CHECK(h1 > 0 && first_byte("s1") == 's' && test_open_fds() == fds + 2, "evict s0 while open");
+    CHECK(posix_read(g_id, h1, &c, 1, 0) == 1 && c == 's', "evicted fd still readable");
+    CHECK(posix_close(g_id, h1) == 0 && test_open_fds() == fds + 1, "last handle closes it");
+    CHECK(posix_fd_cache_set_size(g_id, 0) == 0 && test_open_fds() == fds, "cached fds closed");
+    uint64_t misses2;
+    posix_fd_cache_stats(g_id, &hits, &misses, NULL);
+    CHECK(first_byte("s1") == 's' && test_open_fds() == fds, "no caching when off");
+    posix_fd_cache_stats(g_id, NULL, &misses2, NULL);
+    CHECK(misses2 == misses + 1, "counted as a miss");
+    CHECK(posix_fd_cache_set_size(g_id, -1) < 0 && errno == EINVAL, "negative size");
+    printf("  ✓ size bound, eviction under an open handle, cache off\n");
+
+    /* Test 5: opens, reads and closes racing renames and unlinks */
+    CHECK(posix_fd_cache_set_size(g_id, 128) == 0, "set size 128");
+    for (int i = 0; i < 4; i++) {
+        snprintf(rel, sizeof(rel), "r%d", i);
+        put(rel, 'r');
+    }
+    pthread_t th[THREADS];
+    for (long i = 0; i < THREADS; i++)
+        pthread_create(&th[i], NULL, reader, (void *)i);
+    for (int i = 0; i < ROUNDS / 100; i++) {
+        if (posix_rename(g_id, "r0", "r0.tmp") != 0 || posix_rename(g_id, "r0.tmp", "r0") != 0)
+            atomic_fetch_add(&g_errors, 1);
+        int h = posix_create(g_id, "victim", 0644);
+        first_byte("victim");   /* cache it; empty, so -1 */
+        if (h < 0 || posix_close(g_id, h) != 0 || posix_unlink(g_id, "victim") != 0)
+            atomic_fetch_add(&g_errors, 1);
+    }
+    atomic_store(&g_stop, 1);
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(th[i], NULL);
+    CHECK(g_errors == 0, "concurrent opens alongside renames");
+    printf("  ✓ concurrent opens alongside renames and unlinks\n");
+
+    /* Test 6: shutdown closes cached and shared fds */
+    h1 = posix_open(g_id, "r1", O_RDONLY, 0);
+    CHECK(h1 > 0 && first_byte("r2") == 'r', "leave a handle open");
+    CHECK(posix_backend_shutdown(g_id) == 0, "shutdown");
+    CHECK(test_open_fds() == fds_before, "fds closed at shutdown");
+    printf("  ✓ shutdown closes cached fds\n");
+
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All posix open fd cache tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,123 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#define CHECK_CLEANUP()                    /* no VFS to shut down */
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/*
+ * posix backend handle table: handles across several table segments,
+ * slot reuse through the free list, stale and bogus handles, reads on
+ * stable handles while other threads open and close, and shutdown
+ * closing whatever is still open.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_posix_handles"
+#define MANY        3000        /* more than two segments' worth */
+#define READERS     4
+#define CHURNERS    2
+#define ROUNDS      20000
+
+static int g_id;
+static int g_stable[8];
+static _Atomic int g_errors;
+
+static void *reader(void *arg)
+{
+    int h = g_stable[(long)arg];
+    char c;
+    for (int i = 0; i < ROUNDS; i++)
+        if (posix_read(g_id, h, &c, 1, 0) != 1 || c != 'a' + (char)(long)arg)
+            atomic_fetch_add(&g_errors, 1);
+    return NULL;
+}
+
+static void *churner(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < ROUNDS / 10; i++) {
+        int h = posix_open(g_id, "data", O_RDONLY, 0);
+        if (h <= 0 || posix_close(g_id, h) != 0)
+            atomic_fetch_add(&g_errors, 1);
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    static int handles[MANY];
+    printf("Running posix handle table tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    system("printf x > " BACKEND_DIR "/data");
+    for (int i = 0; i < READERS; i++) {
+        char cmd[128];
+        snprintf(cmd, sizeof(cmd), "printf %c > " BACKEND_DIR "/r%d", 'a' + i, i);
+        system(cmd);
+    }
+
+    int fds_before = test_open_fds();
+    g_id = posix_backend_init(BACKEND_DIR);
+    CHECK(g_id > 0, "posix_backend_init");
+
+    /* Test 1: many handles, all distinct and usable */
+    for (int i = 0; i < MANY; i++) {
+        handles[i] = posix_open(g_id, "data", O_RDONLY, 0);
+        CHECK(handles[i] > 0, "open");
+    }
+    char c;
+    for (int i = 0; i < MANY; i++) {
+        CHECK(posix_read(g_id, handles[i], &c, 1, 0) == 1 && c == 'x', "read each handle");
+        for (int j = i + 1; j < i + 8 && j < MANY; j++)
+            CHECK(handles[i] != handles[j], "distinct handles");
+    }
+    printf("  ✓ %d handles across table segments\n", MANY);
+
+    /* Test 2: closed slots are reused, stale handles fail */
+    int h = handles[MANY / 2];
+    CHECK(posix_close(g_id, h) == 0, "close");
+    CHECK(posix_read(g_id, h, &c, 1, 0) < 0 && errno == EBADF, "read on a closed handle");
+    CHECK(posix_close(g_id, h) < 0 && errno == EBADF, "double close");
+    handles[MANY / 2] = posix_open(g_id, "data", O_RDONLY, 0);
+    CHECK(handles[MANY / 2] == h, "freed slot reused first");
+    for (int i = 0; i < MANY; i++)
+        CHECK(posix_close(g_id, handles[i]) == 0, "close all");
+    CHECK(posix_read(g_id, 0, &c, 1, 0) < 0 && errno == EINVAL, "handle 0");
+    CHECK(posix_read(g_id, -5, &c, 1, 0) < 0 && errno == EINVAL, "negative handle");
+    CHECK(posix_read(g_id, 1 << 30, &c, 1, 0) < 0 && errno == EBADF, "handle past the table");
+    CHECK(posix_fd(g_id, 1 << 20) < 0 && errno == EBADF, "handle in a missing segment");
+    printf("  ✓ slot reuse, stale and bogus handles\n");
+
+    /* Test 3: readers on stable handles while others open and close */
+    for (int i = 0; i < READERS; i++) {
+        char rel[8];
+        snprintf(rel, sizeof(rel), "r%d", i);
+        g_stable[i] = posix_open(g_id, rel, O_RDONLY, 0);
+        CHECK(g_stable[i] > 0, "open stable handle");
+    }
+    pthread_t th[READERS + CHURNERS];
+    for (long i = 0; i < READERS; i++)
+        pthread_create(&th[i], NULL, reader, (void *)i);
+    for (long i = 0; i < CHURNERS; i++)
+        pthread_create(&th[READERS + i], NULL, churner, NULL);
+    for (int i = 0; i < READERS + CHURNERS; i++)
+        pthread_join(th[i], NULL);
+    CHECK(g_errors == 0, "concurrent reads and open/close");
+    printf("  ✓ %d readers alongside %d open/close threads\n", READERS, CHURNERS);
+
+    /* Test 4: shutdown closes what is still open */
+    for (int i = 0; i < 100; i++)
+        CHECK(posix_open(g_id, "data", O_RDONLY, 0) > 0, "open before shutdown");
+    CHECK(posix_backend_shutdown(g_id) == 0, "shutdown");
+    CHECK(test_open_fds() == fds_before, "fds closed at shutdown");
+    printf("  ✓ shutdown closes open handles\n");
+
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All posix handle table tests passed!\n");
+    return 0;
+}
@@ -9,8 +9,8 @@
 #include <sys/stat.h>
 #include "backend_posix.h"
 
-static int filler_print(void *buf, const char *name, const struct stat *st, off_t off) {
-    (void)buf; (void)st; (void)off;
+static int filler_print(void *buf, const char *name, const struct stat *st, off_t off, int flags) {
+    (void)buf; (void)st; (void)off; (void)flags;
     printf("entry: %s\n", name);
     return 0;
 }
@@ -51,7 +51,7 @@ int main(void) {
 
     /* readdir on root */
     printf("readdir results:\n");
-    if (posix_readdir(id, ".", NULL, (vfs_fill_dir_t)filler_print, 0) != 0) {
+    if (posix_readdir(id, ".", NULL, filler_print, 0, 0) != 0) {
         perror("posix_readdir");
         posix_backend_shutdown(id);
         return 9;
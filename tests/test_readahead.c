@@ -0,0 +1,242 @@
+#define _GNU_SOURCE
+#include "../src/backends/backend_posix.h"
+#include "../src/core/vfs_core.h"
+#define CHECK_CLEANUP()                    /* no VFS to shut down */
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+/*
+ * posix backend read-pattern tracking, watched through mincore(): a
+ * sequential stream pulls in a growing readahead window, scattered reads
+ * switch the fd to random advice, long read-only streams leave nothing
+ * far behind them in the page cache, and tracking can be turned off.
+ * Reads made on the fd from vfs_get_fd, as the FUSE read_buf path splices
+ * them, are watched too once reported with vfs_fd_read, and readers
+ * interleaving on one open file are told apart.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_readahead"
+#define FILE_SIZE   (48 << 20)
+#define KB          1024L
+#define MB          (1024L * 1024)
+#define THREADS     4
+
+static int g_id, g_host;
+static _Atomic int g_errors;
+static char g_buf[256 * 1024];
+
+/* Pages of [off, off+len) in the page cache */
+static long resident(off_t off, long len)
+{
+    static unsigned char vec[FILE_SIZE / 4096];
+    void *p = mmap(NULL, len, PROT_READ, MAP_SHARED, g_host, off);
+    if (p == MAP_FAILED)
+        return -1;
+    long n = 0;
+    if (mincore(p, len, vec) == 0)
+        for (long i = 0; i < len / 4096; i++)
+            n += vec[i] & 1;
+    munmap(p, len);
+    return n;
+}
+
+static void cold(void)
+{
+    fdatasync(g_host);
+    posix_fadvise(g_host, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+/* Read [from, to) in chunk-sized reads, checking the block pattern */
+static int stream(int h, off_t from, off_t to, size_t chunk)
+{
+    for (off_t off = from; off < to; off += chunk)
+        if (posix_read(g_id, h, g_buf, chunk, off) != (ssize_t)chunk ||
+            g_buf[0] != (char)(off / 4096) || g_buf[chunk - 1] != (char)((off + chunk - 1) / 4096))
+            return -1;
+    return 0;
+}
+
+/* Each thread streams its own quarter on one shared handle */
+static void *quarter(void *arg)
+{
+    int h = *(int *)arg >> 8, i = *(int *)arg & 0xff;
+    char buf[64 * 1024];
+    off_t base = (off_t)i * (FILE_SIZE / THREADS);
+    for (off_t off = base; off < base + FILE_SIZE / THREADS; off += sizeof(buf))
+        if (posix_read(g_id, h, buf, sizeof(buf), off) != (ssize_t)sizeof(buf) ||
+            buf[0] != (char)(off / 4096))
+            atomic_fetch_add(&g_errors, 1);
+    return NULL;
+}
+
+int main(void)
+{
+    printf("Running readahead tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    g_host = open(BACKEND_DIR "/big", O_CREAT | O_RDWR, 0644);
+    CHECK(g_host >= 0, "create big");
+    for (long blk = 0; blk < FILE_SIZE / 4096; blk++) {
+        char page[4096];
+        memset(page, (char)blk, sizeof(page));
+        CHECK(write(g_host, page, sizeof(page)) == sizeof(page), "fill big");
+    }
+    g_id = posix_backend_init(BACKEND_DIR);
+    CHECK(g_id > 0, "posix_backend_init");
+    /* keep the cached fd out of it: every handle gets its own open file */
+    CHECK(posix_fd_cache_set_size(g_id, 0) == 0, "fd cache off");
+
+    /* Test 1: a sequential stream reads ahead in a growing window */
+    uint64_t seq, rnd, ra, dropped;
+    cold();
+    int h = posix_open(g_id, "big", O_RDONLY, 0);
+    CHECK(h > 0 && stream(h, 0, 1 * MB, 64 * KB) == 0, "read the first MiB");
+    CHECK(posix_readahead_stats(g_id, &seq, &rnd, &ra, &dropped) == 0 && seq == 1 && rnd == 0,
+          "advised sequential once");
+    CHECK(ra >= 2 * MB && ra <= 4 * MB, "window grew with the stream");
+    CHECK(resident(2 * MB + 512 * KB, 512 * KB) == 128, "window ahead of the reader is cached");
+    CHECK(stream(h, 1 * MB, 16 * MB, 128 * KB) == 0, "read on to 16 MiB");
+    CHECK(resident(16 * MB, 4 * MB) == 1024, "window keeps ahead");
+    posix_close(g_id, h);
+
+    posix_readahead_stats(g_id, NULL, NULL, &ra, NULL);
+    CHECK(posix_readahead_set_window(g_id, 0) == 0, "tracking off");
+    cold();
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    uint64_t ra2;
+    CHECK(h > 0 && stream(h, 0, 1 * MB, 64 * KB) == 0, "read the first MiB again");
+    CHECK(posix_readahead_stats(g_id, &seq, NULL, &ra2, NULL) == 0 && ra2 == ra && seq == 1,
+          "readahead left to the kernel");
+    posix_close(g_id, h);
+    CHECK(posix_readahead_set_window(g_id, 8 * MB) == 0, "tracking on");
+    printf("  ✓ sequential streams read ahead in a growing window\n");
+
+    /* Test 2: scattered reads switch to random advice, and back */
+    cold();
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    static const long offs[] = { 40, 10, 30, 20 };
+    for (int i = 0; i < 4; i++)
+        CHECK(posix_read(g_id, h, g_buf, 4096, offs[i] * MB) == 4096 &&
+              g_buf[0] == (char)(offs[i] * MB / 4096), "scattered read");
+    CHECK(posix_readahead_stats(g_id, &seq, &rnd, NULL, NULL) == 0 && seq == 1 && rnd == 1,
+          "advised random after four");
+    CHECK(posix_read(g_id, h, g_buf, 4096, 5 * MB) == 4096 && resident(5 * MB, 256 * KB) == 1,
+          "random reads fetch only what they ask for");
+    CHECK(stream(h, 5 * MB + 4 * KB, 6 * MB, 4 * KB) == 0, "then stream");
+    CHECK(posix_readahead_stats(g_id, &seq, NULL, NULL, NULL) == 0 && seq == 2,
+          "advised sequential again");
+    posix_close(g_id, h);
+    printf("  ✓ scattered reads advised random, streams sequential again\n");
+
+    /* Test 3: a long read-only pass leaves little behind it */
+    cold();
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    CHECK(h > 0 && stream(h, 0, FILE_SIZE, 128 * KB) == 0, "read the whole file");
+    posix_close(g_id, h);
+    CHECK(posix_readahead_stats(g_id, NULL, NULL, NULL, &dropped) == 0 && dropped >= 40 * MB,
+          "dropped behind the stream");
+    CHECK(resident(0, 40 * MB) == 0, "start of the file no longer cached");
+    CHECK(resident(FILE_SIZE - 4 * MB, 4 * MB) == 1024, "recent part still cached");
+
+    cold();
+    h = posix_open(g_id, "big", O_RDWR, 0);
+    CHECK(h > 0 && stream(h, 0, FILE_SIZE, 128 * KB) == 0, "read through a read-write handle");
+    posix_close(g_id, h);
+    uint64_t dropped2;
+    posix_readahead_stats(g_id, NULL, NULL, NULL, &dropped2);
+    CHECK(dropped2 == dropped && resident(0, 40 * MB) == 40 * MB / 4096,
+          "nothing dropped behind a read-write handle");
+    printf("  ✓ pages far behind read-only streams dropped\n");
+
+    /* Test 4: vectored reads are tracked too; a reused slot starts over */
+    cold();
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    posix_readahead_stats(g_id, &seq, NULL, &ra, NULL);
+    for (off_t off = 0; off < 1 * MB; off += 64 * KB) {
+        struct iovec iov[2] = { { g_buf, 32 * KB }, { g_buf + 32 * KB, 32 * KB } };
+        CHECK(posix_readv(g_id, h, iov, 2, off) == 64 * KB, "readv");
+    }
+    posix_readahead_stats(g_id, &seq, NULL, &ra2, NULL);
+    uint64_t seq2 = seq;
+    CHECK(ra2 > ra && resident(2 * MB + 512 * KB, 512 * KB) == 128, "readv streams read ahead");
+    posix_close(g_id, h);
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    CHECK(posix_read(g_id, h, g_buf, 4096, 1 * MB) == 4096, "read on a new handle");
+    posix_readahead_stats(g_id, &seq, NULL, &ra, NULL);
+    CHECK(seq == seq2 && ra == ra2, "new handle does not continue the old stream");
+    posix_close(g_id, h);
+    printf("  ✓ vectored reads tracked, state reset per handle\n");
+
+    /* Test 5: threads streaming on one handle */
+    cold();
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    pthread_t th[THREADS];
+    int args[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        args[i] = h << 8 | i;
+        pthread_create(&th[i], NULL, quarter, &args[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(th[i], NULL);
+    CHECK(g_errors == 0, "concurrent reads on one handle");
+    CHECK(posix_close(g_id, h) == 0, "close");
+    printf("  ✓ concurrent reads on one handle\n");
+
+    /* Test 6: reads on the vfs_get_fd fd, reported with vfs_fd_read */
+    CHECK(vfs_init() == 0, "vfs_init");
+    CHECK(vfs_mount_backend("/ra", BACKEND_DIR, "posix") == 0, "mount /ra");
+    cold();
+    int fh = vfs_open("/ra/big", O_RDONLY);
+    int fd = fh >= 0 ? vfs_get_fd(fh, R_OK) : -1;
+    CHECK(fd >= 0, "get_fd");
+    for (off_t off = 0; off < FILE_SIZE; off += 128 * KB) {
+        CHECK(pread(fd, g_buf, 128 * KB, off) == 128 * KB && g_buf[0] == (char)(off / 4096),
+              "pread the fd");
+        vfs_fd_read(fh, off, 128 * KB);
+    }
+    CHECK(vfs_close(fh) == 0, "vfs_close");
+    CHECK(resident(0, 40 * MB) == 0 && resident(FILE_SIZE - 4 * MB, 4 * MB) == 1024,
+          "dropped behind a stream read through the fd");
+    vfs_shutdown();
+    printf("  ✓ reads through vfs_get_fd tracked\n");
+
+    /* Test 7: two streams interleaved on one handle, then scattered reads
+     * on another handle sharing its cached fd */
+    CHECK(posix_fd_cache_set_size(g_id, 16) == 0, "fd cache on");
+    cold();
+    posix_readahead_stats(g_id, &seq, &rnd, &ra, NULL);
+    h = posix_open(g_id, "big", O_RDONLY, 0);
+    int h2 = posix_open(g_id, "big", O_RDONLY, 0);
+    CHECK(h > 0 && h2 > 0, "two handles on the cached fd");
+    for (off_t off = 0; off < 4 * MB; off += 64 * KB)
+        CHECK(stream(h, off, off + 64 * KB, 64 * KB) == 0 &&
+              stream(h, 24 * MB + off, 24 * MB + off + 64 * KB, 64 * KB) == 0,
+              "interleaved reads");
+    uint64_t rnd2;
+    posix_readahead_stats(g_id, &seq2, &rnd2, &ra2, NULL);
+    CHECK(seq2 == seq + 1 && rnd2 == rnd, "interleaved streams advised sequential");
+    CHECK(ra2 - ra >= 2 * 2 * MB, "both streams read ahead");
+    for (int i = 0; i < 8; i++)
+        CHECK(posix_read(g_id, h2, g_buf, 4096, (40 - i) * MB) == 4096 &&
+              stream(h, 4 * MB + i * 64 * KB, 4 * MB + (i + 1) * 64 * KB, 64 * KB) == 0,
+              "scattered reads beside a stream");
+    posix_readahead_stats(g_id, NULL, &rnd2, NULL, NULL);
+    CHECK(rnd2 == rnd, "advised random under a sequential stream");
+    posix_close(g_id, h2);
+    posix_close(g_id, h);
+    printf("  ✓ interleaved streams on one open file tracked apart\n");
+
+    CHECK(posix_backend_shutdown(g_id) == 0, "shutdown");
+    close(g_host);
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All readahead tests passed!\n");
+    return 0;
+}
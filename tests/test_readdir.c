@@ -0,0 +1,284 @@
+#define _GNU_SOURCE
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Directory listing through vfs_readdir on the posix and posix_uring
+ * backends: every entry exactly once with its inode number and type,
+ * attributes only with VFS_READDIR_PLUS, a filler that fills up, and a
+ * directory bigger than one getdents64 buffer. Directory streams resumed
+ * page by page from entry cookies, on backend and in-memory directories.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_readdir"
+#define BIG         6000
+
+typedef struct listing {
+    int count, plus, limit;
+    int page;                   /* entries taken since page was reset */
+    off_t cookie;               /* of the last entry taken */
+    char first[64];             /* first entry of the page */
+    int seen[BIG];              /* bigNNNN entries */
+    struct stat file, dir, link;
+    int file_flags;
+} listing_t;
+
+static int fill(void *buf, const char *name, const struct stat *st, off_t off, int flags)
+{
+    listing_t *l = buf;
+    if (l->limit && l->page == l->limit)
+        return 1;
+    if (!l->page)
+        snprintf(l->first, sizeof(l->first), "%s", name);
+    l->page++;
+    l->cookie = off;
+    l->count++;
+    l->plus += (flags & VFS_FILL_DIR_PLUS) != 0;
+    if (!strncmp(name, "big", 3))
+        l->seen[atoi(name + 3)]++;
+    else if (!strcmp(name, "file")) {
+        l->file = *st;
+        l->file_flags = flags;
+    } else if (!strcmp(name, "sub"))
+        l->dir = *st;
+    else if (!strcmp(name, "link"))
+        l->link = *st;
+    return 0;
+}
+
+/* NULL or what failed */
+static const char *check_small(const char *dir, listing_t *l)
+{
+    struct stat st;                     /* backends report host inode numbers */
+    char path[64];
+    if (stat(BACKEND_DIR "/small/file", &st) != 0)
+        return "stat file";
+
+    memset(l, 0, sizeof(*l));
+    snprintf(path, sizeof(path), "%s/small", dir);
+    if (vfs_readdir(path, l, fill, 0, NULL, 0) != 0)
+        return "readdir";
+    if (l->count != 5 || l->plus != 0)         /* . .. file sub link */
+        return "entries without attributes";
+    if (!S_ISREG(l->file.st_mode) || !S_ISDIR(l->dir.st_mode) || !S_ISLNK(l->link.st_mode))
+        return "types from d_type";
+    if (l->file.st_ino != st.st_ino || l->file.st_size != 0)
+        return "inode number only";
+
+    memset(l, 0, sizeof(*l));
+    if (vfs_readdir(path, l, fill, 0, NULL, VFS_READDIR_PLUS) != 0)
+        return "readdir plus";
+    if (l->count != 5 || l->plus != 5 || !(l->file_flags & VFS_FILL_DIR_PLUS))
+        return "entries with attributes";
+    if (l->file.st_size != 1234 || l->file.st_nlink != 1 || l->file.st_ino != st.st_ino)
+        return "file attributes";
+    if (!S_ISLNK(l->link.st_mode))
+        return "symlink reported as its target, unlike d_type";
+    return NULL;
+}
+
+/* List a directory stream in pages of limit entries, each call resuming
+ * from the last cookie; returns the number of calls, or -1 */
+static int list_pages(int fh, listing_t *l, int limit, int flags)
+{
+    int calls = 0;
+    memset(l, 0, sizeof(*l));
+    l->limit = limit;
+    do {
+        l->page = 0;
+        if (vfs_readdir_fh(fh, l, fill, l->cookie, flags) != 0)
+            return -1;
+        calls++;
+        if (l->page && !l->cookie)
+            return -1;          /* entries need a cookie to resume from */
+    } while (l->page);
+    return calls;
+}
+
+static const char *check_pages(const char *dir, listing_t *l, int flags)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "%s/big", dir);
+    int fh = vfs_opendir(path);
+    if (fh <= 0)
+        return "opendir";
+    int calls = list_pages(fh, l, 100, flags);
+    vfs_closedir(fh);
+    if (calls != (BIG + 2 + 99) / 100 + 1)
+        return "one call per page";
+    if (l->count != BIG + 2)
+        return "paged entry count";
+    for (int i = 0; i < BIG; i++)
+        if (l->seen[i] != 1)
+            return "each paged entry once";
+    if (flags && l->plus != BIG + 2)
+        return "paged entries with attributes";
+    return NULL;
+}
+
+/* A cookie taken mid-listing still leads to the same entry later, on the
+ * stream, after a rewind, and through a path listing */
+static const char *check_cookies(const char *dir, listing_t *l)
+{
+    char path[64], next[64], start[64];
+    snprintf(path, sizeof(path), "%s/big", dir);
+    int fh = vfs_opendir(path);
+    if (fh <= 0)
+        return "opendir";
+
+    const char *err = NULL;
+    memset(l, 0, sizeof(*l));
+    l->limit = 500;
+    vfs_readdir_fh(fh, l, fill, 0, 0);
+    off_t mid = l->cookie;
+    snprintf(start, sizeof(start), "%s", l->first);
+    l->page = 0;
+    l->limit = 1000;
+    vfs_readdir_fh(fh, l, fill, mid, 0);
+    snprintf(next, sizeof(next), "%s", l->first);
+
+    l->page = 0;
+    vfs_readdir_fh(fh, l, fill, l->cookie, 0);      /* move on */
+    l->page = 0;
+    vfs_readdir_fh(fh, l, fill, mid, VFS_READDIR_PLUS);
+    if (strcmp(l->first, next) != 0)
+        err = "seek back to a cookie";
+    l->page = 0;
+    vfs_readdir_fh(fh, l, fill, 0, 0);
+    if (!err && strcmp(l->first, start) != 0)
+        err = "offset 0 starts over";
+    memset(l, 0, sizeof(*l));
+    l->limit = 1;
+    if (!err && (vfs_readdir(path, l, fill, mid, NULL, 0) != 0 || strcmp(l->first, next) != 0))
+        err = "path listing from a cookie";
+    vfs_closedir(fh);
+    return err;
+}
+
+static const char *check_big(const char *dir, listing_t *l, int flags)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "%s/big", dir);
+    memset(l, 0, sizeof(*l));
+    if (vfs_readdir(path, l, fill, 0, NULL, flags) != 0)
+        return "readdir big";
+    if (l->count != BIG + 2)
+        return "big entry count";
+    for (int i = 0; i < BIG; i++)
+        if (l->seen[i] != 1)
+            return "each big entry once";
+    if (flags && l->plus != BIG + 2)
+        return "big entries with attributes";
+    return NULL;
+}
+
+int main(void)
+{
+    static listing_t l;
+    printf("Running readdir tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    system("mkdir -p " BACKEND_DIR "/small/sub " BACKEND_DIR "/big && "
+           "head -c 1234 /dev/zero > " BACKEND_DIR "/small/file && "
+           "ln -s file " BACKEND_DIR "/small/link");
+    for (int i = 0; i < BIG; i++) {
+        char p[64];
+        snprintf(p, sizeof(p), BACKEND_DIR "/big/big%04d_with_a_longer_name", i);
+        close(open(p, O_CREAT | O_WRONLY, 0644));
+    }
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    CHECK(vfs_mount_backend("/p", BACKEND_DIR, "posix") == 0, "mount posix");
+    CHECK(vfs_mount_backend("/u", BACKEND_DIR, "posix_uring") == 0, "mount posix_uring");
+
+    /* Test 1: types and inode numbers, attributes only when asked */
+    const char *err = check_small("/p", &l);
+    CHECK(!err, err);
+    printf("  ✓ posix: d_type listing, attributes with VFS_READDIR_PLUS\n");
+    err = check_small("/u", &l);
+    CHECK(!err, err);
+    printf("  ✓ posix_uring: the same, statx in flight together\n");
+
+    /* Test 2: more entries than one getdents64 buffer holds */
+    for (int flags = 0; flags <= VFS_READDIR_PLUS; flags++) {
+        err = check_big("/p", &l, flags);
+        CHECK(!err, err);
+        err = check_big("/u", &l, flags);
+        CHECK(!err, err);
+    }
+    printf("  ✓ %d entries, each listed once\n", BIG);
+
+    /* Test 3: a full filler ends the listing; missing directories fail */
+    const char *dirs[] = { "/p/big", "/u/big" };
+    for (int i = 0; i < 2; i++) {
+        memset(&l, 0, sizeof(l));
+        l.limit = 100;
+        CHECK(vfs_readdir(dirs[i], &l, fill, 0, NULL, VFS_READDIR_PLUS) == 0 && l.count == 100,
+              "listing stops when the filler is full");
+    }
+    CHECK(vfs_readdir("/p/missing", &l, fill, 0, NULL, 0) == -ENOENT, "missing directory");
+    memset(&l, 0, sizeof(l));
+    CHECK(vfs_readdir("/", &l, fill, 0, NULL, VFS_READDIR_PLUS) == 0 && l.count >= 3 &&
+          l.plus == 0, "in-memory directory");
+    printf("  ✓ full filler, missing and in-memory directories\n");
+
+    /* Test 4: streams listed a page per call, resuming from cookies */
+    for (int flags = 0; flags <= VFS_READDIR_PLUS; flags++) {
+        err = check_pages("/p", &l, flags);
+        CHECK(!err, err);
+        err = check_pages("/u", &l, flags);
+        CHECK(!err, err);
+    }
+    err = check_cookies("/p", &l);
+    CHECK(!err, err);
+    err = check_cookies("/u", &l);
+    CHECK(!err, err);
+    printf("  ✓ paged listings and stable cookies on both backends\n");
+
+    /* Test 5: in-memory streams list what was there at opendir */
+    CHECK(vfs_mkdir("/mem", 0755) == 0, "mkdir /mem");
+    for (int i = 0; i < 10; i++) {
+        char p[32];
+        snprintf(p, sizeof(p), "/mem/big%04d", i);
+        CHECK(vfs_mkdir(p, 0755) == 0, "mkdir /mem/bigNNNN");
+    }
+    int fh = vfs_opendir("/mem");
+    CHECK(fh > 0, "opendir in memory");
+    memset(&l, 0, sizeof(l));
+    l.limit = 3;
+    CHECK(vfs_readdir_fh(fh, &l, fill, 0, 0) == 0 && l.page == 3 && l.cookie == 3,
+          "in-memory cookies");
+    CHECK(vfs_mkdir("/mem/big0010", 0755) == 0, "mkdir while listing");
+    do {
+        l.page = 0;
+        CHECK(vfs_readdir_fh(fh, &l, fill, l.cookie, 0) == 0, "in-memory page");
+    } while (l.page);
+    CHECK(l.count == 12 && l.seen[10] == 0, "snapshot taken at opendir");
+    for (int i = 0; i < 10; i++)
+        CHECK(l.seen[i] == 1, "each in-memory entry once");
+    char c;
+    CHECK(vfs_read(fh, &c, 1, 0) == -EBADF, "no data through a directory handle");
+    CHECK(vfs_closedir(fh) == 0 && vfs_closedir(fh) == -EBADF, "closedir once");
+    CHECK(vfs_opendir("/p/small/file") == -ENOTDIR, "opendir on a file");
+    CHECK(vfs_opendir("/p/missing") == -ENOENT, "opendir on nothing");
+    int file = vfs_open("/p/small/file", O_RDONLY);
+    CHECK(file > 0 && vfs_readdir_fh(file, &l, fill, 0, 0) == -EBADF &&
+          vfs_closedir(file) == -EBADF && vfs_close(file) == 0, "file handles are not streams");
+    fh = vfs_opendir("/u/big");
+    CHECK(fh > 0, "opendir left open");
+    printf("  ✓ in-memory snapshot and handle checks\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All readdir tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+/*
+ * Dentry refcount + LRU shrinker tests: crawling a backend stays within
+ * the memory budget, pinned entries (open handles) survive eviction, and
+ * lookups racing with the shrinker stay correct.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_shrink"
+#define NDIRS       10
+#define NFILES      300
+#define BUDGET      (128u << 10)
+#define WORKERS     4
+#define WORKER_OPS  20000
+
+static void make_tree(void) {
+    char path[256];
+    test_dir_setup(BACKEND_DIR);
+    for (int i = 0; i < NDIRS; i++) {
+        snprintf(path, sizeof(path), BACKEND_DIR "/d%d", i);
+        mkdir(path, 0755);
+        for (int j = 0; j < NFILES; j++) {
+            snprintf(path, sizeof(path), BACKEND_DIR "/d%d/f%d", i, j);
+            int fd = open(path, O_CREAT | O_WRONLY, 0644);
+            if (fd >= 0) {
+                write(fd, "x", 1);
+                close(fd);
+            }
+        }
+    }
+}
+
+static int crawl(void) {
+    char path[128];
+    struct stat st;
+    for (int i = 0; i < NDIRS; i++) {
+        for (int j = 0; j < NFILES; j++) {
+            snprintf(path, sizeof(path), "/shr/d%d/f%d", i, j);
+            if (vfs_stat(path, &st) != 0 || st.st_size != 1)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static void *stat_worker(void *arg) {
+    unsigned seed = (unsigned)(uintptr_t)arg;
+    char path[128];
+    struct stat st;
+    for (int n = 0; n < WORKER_OPS; n++) {
+        snprintf(path, sizeof(path), "/shr/d%d/f%d",
+                 rand_r(&seed) % NDIRS, rand_r(&seed) % NFILES);
+        if (vfs_stat(path, &st) != 0) {
+            fprintf(stderr, "FAIL: stat %s under shrinker\n", path);
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    printf("Running dentry shrinker tests...\n");
+
+    make_tree();
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    if (vfs_mount_backend("/shr", BACKEND_DIR, "posix") != 0) {
+        fprintf(stderr, "mount failed\n");
+        vfs_shutdown();
+        return 1;
+    }
+
+    vfs_dcache_stats_t st;
+
+    /* Test 1: an open handle pins its dentry and, through it, its parents */
+    int fh = vfs_open("/shr/d0/f0", O_RDONLY);
+    CHECK(fh > 0, "open pinned file");
+
+    /* Test 2: a crawl bigger than the budget stays within it */
+    vfs_dcache_set_budget(BUDGET);
+    CHECK(vfs_dcache_get_budget() == BUDGET, "budget setter");
+    CHECK(crawl() == 0, "crawl under budget");
+    vfs_dcache_get_stats(&st);
+    CHECK(st.evictions > 0, "shrinker never ran");
+    CHECK(st.bytes <= BUDGET, "memory budget exceeded");
+    CHECK(st.dentries_peak >= st.dentries && st.inodes_peak >= st.inodes,
+          "peak below current");
+    printf("  ✓ crawl of %d files: %zu dentries (peak %zu), %zu inodes (peak %zu), "
+           "%zu bytes, %llu evictions\n",
+           NDIRS * NFILES, st.dentries, st.dentries_peak, st.inodes, st.inodes_peak,
+           st.bytes, (unsigned long long)st.evictions);
+
+    /* the pinned path is still cached: resolving it needs no backend call */
+    uint64_t before = st.backend_lookups;
+    vfs_dentry_t *d = NULL;
+    CHECK(vfs_resolve_path("/shr/d0/f0", &d) == 0, "resolve pinned file");
+    vfs_dcache_get_stats(&st);
+    CHECK(st.backend_lookups == before, "pinned entry was evicted");
+    char c;
+    CHECK(vfs_read(fh, &c, 1, 0) == 1 && c == 'x', "read through pinned handle");
+    vfs_close(fh);
+    printf("  ✓ open handle pinned its dentry chain\n");
+
+    /* Test 3: explicit shrink drops every unused entry, in-memory tree stays */
+    size_t n = vfs_dcache_shrink(SIZE_MAX);
+    vfs_dcache_get_stats(&st);
+    CHECK(n > 0 && st.unused == 0, "full shrink");
+    CHECK(vfs_resolve_path("/dir1/dir2/file", &d) == 0, "in-memory entry evicted");
+    CHECK(crawl() == 0, "crawl after shrink");
+    printf("  ✓ shrink evicted %zu entries, lookups refill from the backend\n", n);
+
+    /* Test 4: lookups racing with the shrinker under a tiny budget */
+    vfs_dcache_set_budget(16u << 10);
+    pthread_t tids[WORKERS];
+    for (int i = 0; i < WORKERS; i++)
+        pthread_create(&tids[i], NULL, stat_worker, (void *)(uintptr_t)(i + 1));
+    for (int i = 0; i < WORKERS; i++)
+        pthread_join(tids[i], NULL);
+    vfs_dcache_get_stats(&st);
+    printf("  ✓ %d threads x %d stats against the shrinker (%llu evictions)\n",
+           WORKERS, WORKER_OPS, (unsigned long long)st.evictions);
+
+    /* Test 5: budget 0 disables the shrinker */
+    vfs_dcache_set_budget(0);
+    uint64_t ev = st.evictions;
+    CHECK(crawl() == 0, "crawl unlimited");
+    vfs_dcache_get_stats(&st);
+    CHECK(st.evictions == ev, "eviction with unlimited budget");
+    CHECK(st.unused >= NDIRS * NFILES, "crawled entries not on the LRU");
+    printf("  ✓ unlimited budget keeps %zu unused entries\n", st.unused);
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All shrinker tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+#define _GNU_SOURCE
+#include "../src/core/vfs_core.h"
+#include "test_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Zero-copy tests: vfs_get_fd on posix and posix_uring handles, access
+ * checks, the fallbacks (in-memory files, O_DIRECT), and data spliced
+ * through a pipe in both directions the way the FUSE read_buf/write_buf
+ * path moves it, with vfs_fd_written keeping the size current.
+ */
+
+#define BACKEND_DIR "/tmp/vfs_test_splice"
+#define CHUNK       (64 * 1024)
+
+/* Write CHUNK bytes of src at offset through the fd, and splice them back
+ * out into dst; NULL or what failed */
+static const char *round_trip(const char *path, const char *src, char *dst, off_t offset)
+{
+    int pfd[2];
+    if (pipe(pfd) != 0)
+        return "pipe";
+    fcntl(pfd[0], F_SETPIPE_SZ, CHUNK);
+
+    int fh = vfs_open(path, O_RDWR | O_CREAT);
+    int fd = fh > 0 ? vfs_get_fd(fh, R_OK | W_OK) : -1;
+    const char *err = NULL;
+    if (fd < 0) {
+        err = "get_fd";
+        goto out;
+    }
+
+    /* write_buf: request data arrives in a pipe and goes to the file */
+    if (write(pfd[1], src, CHUNK) != CHUNK) {
+        err = "fill pipe";
+        goto out;
+    }
+    loff_t pos = offset;
+    ssize_t n = splice(pfd[0], NULL, fd, &pos, CHUNK, SPLICE_F_MOVE);
+    if (n != CHUNK) {
+        err = "splice into the file";
+        goto out;
+    }
+    vfs_fd_written(fh, offset, n);
+    struct stat st;
+    if (vfs_stat(path, &st) != 0 || st.st_size != offset + CHUNK) {
+        err = "size after a spliced write";
+        goto out;
+    }
+
+    /* read_buf: file pages go to the pipe, as libfuse sends them on */
+    pos = offset;
+    n = splice(fd, &pos, pfd[1], NULL, CHUNK, SPLICE_F_MOVE);
+    if (n != CHUNK || read(pfd[0], dst, CHUNK) != CHUNK || memcmp(src, dst, CHUNK)) {
+        err = "splice out of the file";
+        goto out;
+    }
+    /* the handle's own reads see the spliced data */
+    memset(dst, 0, CHUNK);
+    if (vfs_read(fh, dst, CHUNK, offset) != CHUNK || memcmp(src, dst, CHUNK))
+        err = "vfs_read after a spliced write";
+out:
+    if (fh > 0)
+        vfs_close(fh);
+    close(pfd[0]);
+    close(pfd[1]);
+    return err;
+}
+
+int main(void)
+{
+    static char src[CHUNK], dst[CHUNK];
+    printf("Running zero-copy tests...\n");
+    test_dir_setup(BACKEND_DIR);
+    for (int i = 0; i < CHUNK; i++)
+        src[i] = (char)(i * 7 + i / 4096);
+
+    if (vfs_init() != 0) {
+        fprintf(stderr, "vfs_init failed\n");
+        return 1;
+    }
+    CHECK(vfs_mount_backend("/p", BACKEND_DIR, "posix") == 0, "mount posix");
+    CHECK(vfs_mount_backend("/u", BACKEND_DIR, "posix_uring") == 0, "mount posix_uring");
+
+    /* Test 1: data spliced both ways through the backend fd */
+    const char *err = round_trip("/p/spliced", src, dst, 0);
+    CHECK(!err, err);
+    err = round_trip("/p/spliced", src, dst, 3 * CHUNK);
+    CHECK(!err, err);
+    printf("  ✓ posix: splice into and out of the backend fd\n");
+    err = round_trip("/u/uspliced", src, dst, CHUNK);
+    CHECK(!err, err);
+    printf("  ✓ posix_uring: the same\n");
+
+    /* Test 2: access granted at open limits the fd */
+    int fh = vfs_open("/p/spliced", O_RDONLY);
+    CHECK(fh > 0, "open read-only");
+    CHECK(vfs_get_fd(fh, R_OK) >= 0, "read fd");
+    CHECK(vfs_get_fd(fh, W_OK) == -EBADF, "write fd on a read-only handle");
+    CHECK(vfs_get_fd(fh, 0) == -EBADF && vfs_get_fd(fh, X_OK) == -EBADF, "bad access mask");
+    vfs_close(fh);
+    CHECK(vfs_get_fd(fh, R_OK) == -EBADF, "closed handle");
+    CHECK(vfs_get_fd(12345, R_OK) == -EBADF, "unknown handle");
+    printf("  ✓ access checked against the handle\n");
+
+    /* Test 3: no fd to hand out, so callers copy */
+    fh = vfs_open("/dir1/memfile", O_RDWR | O_CREAT);
+    CHECK(fh > 0, "in-memory file");
+    CHECK(vfs_get_fd(fh, R_OK) == -EOPNOTSUPP, "in-memory file has no fd");
+    vfs_fd_written(fh, 0, 100);         /* ignored */
+    vfs_close(fh);
+    system("head -c 65536 /dev/zero > " BACKEND_DIR "/direct");
+    const char *dpaths[] = { "/p/direct", "/u/direct" };
+    for (int i = 0; i < 2; i++) {
+        fh = vfs_open(dpaths[i], O_RDONLY | O_DIRECT);
+        CHECK(fh > 0, "open O_DIRECT");
+        CHECK(vfs_get_fd(fh, R_OK) == -EOPNOTSUPP, "O_DIRECT handle has no fd");
+        vfs_close(fh);
+    }
+    printf("  ✓ in-memory and O_DIRECT files fall back\n");
+
+    vfs_shutdown();
+    test_dir_cleanup(BACKEND_DIR);
+    printf("All zero-copy tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+/*
+ * Shared by the unit tests: the CHECK macro and a scratch directory under
+ * /tmp for the backend under test, recreated empty at the start of a run
+ * and removed at the end.
+ *
+ * CHECK prints what failed, runs CHECK_CLEANUP() and returns 1 from the
+ * calling function. Tests of the VFS core leave CHECK_CLEANUP at
+ * vfs_shutdown(); tests that drive a backend directly define it empty
+ * before including this header.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <dirent.h>
+
+#ifndef CHECK_CLEANUP
+#define CHECK_CLEANUP() vfs_shutdown()
+#endif
+
+#define CHECK(cond, msg) do {                     \
+        if (!(cond)) {                            \
+            fprintf(stderr, "FAIL: %s\n", msg);   \
+            CHECK_CLEANUP();                      \
+            return 1;                             \
+        }                                         \
+    } while (0)
+
+/* Run the shell command built from fmt; its exit status */
+static inline int test_sh(const char *fmt, ...)
+{
+    char cmd[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(cmd, sizeof(cmd), fmt, ap);
+    va_end(ap);
+    return system(cmd);
+}
+
+/* dir, empty, with any missing parents */
+static inline int test_dir_setup(const char *dir)
+{
+    return test_sh("rm -rf '%s' && mkdir -p '%s'", dir, dir);
+}
+
+static inline void test_dir_cleanup(const char *dir)
+{
+    test_sh("rm -rf '%s'", dir);
+}
+
+/* Entries in /proc/self/fd, for comparing counts before and after; -1 on error */
+static inline int test_open_fds(void)
+{
+    int n = 0;
+    DIR *d = opendir("/proc/self/fd");
+    if (!d)
+        return -1;
+    while (readdir(d))
+        n++;
+    closedir(d);
+    return n;
+}
+
+#endif /* TEST_UTIL_H */